@@ -31,6 +31,8 @@
 
 
 #include "thirdparty/catch.hpp"
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
 
 #include "SkaleCommon.h"
 #include "Log.h"
@@ -38,8 +40,23 @@
 #include "crypto/CryptoManager.h"
 
 #include "iostream"
+#include <functional>
 #include "time.h"
 #include "crypto/SHAHash.h"
+#include "crypto/MockupECDSASigner.h"
+#include "crypto/LocalECDSASigner.h"
+#include "crypto/SGXECDSASigner.h"
+#include "crypto/ECDSAVerify.h"
+#include "crypto/bls_include.h"
+#include "crypto/LagrangeCoeffsCache.h"
+#include "crypto/BLSSigCodec.h"
+#include "BLSSigShare.h"
+#include "crypto/SHA256Hasher.h"
+#include "datastructures/Transaction.h"
+#include "datastructures/TransactionList.h"
+#include "protocols/binconsensus/BinConsensusInstance.h"
+#include "protocols/binconsensus/RoundVotes.h"
+#include "utils/Time.h"
 
 #include "stubclient.h"
 #include <network/Utils.h>
@@ -157,6 +174,47 @@ TEST_CASE_METHOD(StartFromScratch, "Use finalization download only", "[consensus
     SUCCEED();
 }
 
+TEST_CASE_METHOD(StartFromScratch, "Restart nodes from saved consensus state", "[consensus-restart]") {
+
+#ifndef CONSENSUS_STATE_PERSISTENCE
+    WARN("Built without CONSENSUS_STATE_PERSISTENCE, nodes restart without consensus snapshots");
+#endif
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+    usleep(1000 * Consensust::getRunningTimeMS()); /* Flawfinder: ignore */
+
+    auto committedBeforeStop = engine->getLargestCommittedBlockID();
+    REQUIRE(committedBeforeStop > 0);
+
+    // stop all nodes in the middle of consensus, the DBs stay in place
+    engine->exitGracefullyBlocking();
+    delete engine;
+
+    auto startTime = Time::getCurrentTimeMs();
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+
+    while (engine->getLargestCommittedBlockID() <= committedBeforeStop &&
+           Time::getCurrentTimeMs() - startTime < Consensust::getRunningTimeMS()) {
+        usleep(10000);
+    }
+
+    auto timeToFirstCommitMs = Time::getCurrentTimeMs() - startTime;
+
+    REQUIRE(engine->getLargestCommittedBlockID() > committedBeforeStop);
+
+    printf("TEST_LOG: restarted at block %lu, first commit after %lu ms\n",
+           (unsigned long) committedBeforeStop, (unsigned long) timeToFirstCommitMs);
+
+    engine->exitGracefullyBlocking();
+    delete engine;
+    SUCCEED();
+}
+
 bool success = false;
 
 void exit_check() {
@@ -207,6 +265,93 @@ TEST_CASE_METHOD(StartFromScratch, "Issue different proposals to different nodes
     SUCCEED();
 }
 
+TEST_CASE_METHOD(StartFromScratch, "Use compact BLS encoding when all nodes support it", "[bls-compact]") {
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+    usleep(1000 * Consensust::getRunningTimeMS()); /* Flawfinder: ignore */
+
+    REQUIRE(engine->getLargestCommittedBlockID() > 0);
+    REQUIRE(engine->getCompactBLSNodesCount() == (uint64_t) engine->nodesCount());
+
+    engine->exitGracefullyBlocking();
+    delete engine;
+    SUCCEED();
+}
+
+TEST_CASE_METHOD(StartFromScratch, "Keep the libBLS encoding while a node does not support compact", "[bls-legacy-peer]") {
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+    usleep(1000 * Consensust::getRunningTimeMS()); /* Flawfinder: ignore */
+
+    // the node without compact encoding has to parse every share and signature of the chain
+    REQUIRE(engine->checkCommittedBlocksMatch() > 0);
+    REQUIRE(engine->getCompactBLSNodesCount() == 0);
+
+    engine->exitGracefullyBlocking();
+    delete engine;
+    SUCCEED();
+}
+
+TEST_CASE_METHOD(StartFromScratch, "Do not repropose transactions of queued blocks", "[ext-face-queue]") {
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+    usleep(1000 * Consensust::getRunningTimeMS()); /* Flawfinder: ignore */
+
+    // test transactions stay pending until their block is delivered, as on the external face,
+    // two of the nodes pipeline their proposals
+    REQUIRE(engine->checkCommittedBlocksMatch() > 0);
+    REQUIRE(engine->checkNoDuplicateTransactions() > 0);
+
+    engine->exitGracefullyBlocking();
+    delete engine;
+    SUCCEED();
+}
+
+TEST_CASE_METHOD(StartFromScratch, "Split round 0 votes with the fast path", "[fast-path-split-vote]") {
+    setenv("SPLIT_CONSENSUS_VOTE_TEST", "1", 1);
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+    usleep(1000 * Consensust::getRunningTimeMS()); /* Flawfinder: ignore */
+
+    // honest nodes start instances of odd proposers with different values, they still have to agree
+    auto matchingBlocks = engine->checkCommittedBlocksMatch();
+
+    REQUIRE(matchingBlocks > 0);
+
+    engine->exitGracefullyBlocking();
+    delete engine;
+
+    unsetenv("SPLIT_CONSENSUS_VOTE_TEST");
+    SUCCEED();
+}
+
+TEST_CASE_METHOD(StartFromScratch, "Check agreement of round 0 fast path decisions", "[fast-path]") {
+
+    engine = new ConsensusEngine();
+    engine->parseTestConfigsAndCreateAllNodes(Consensust::getConfigDirPath());
+    engine->slowStartBootStrapTest();
+    usleep(1000 * Consensust::getRunningTimeMS()); /* Flawfinder: ignore */
+
+    // conflicting decisions of a binary consensus instance also fail the global decision history check
+    auto matchingBlocks = engine->checkCommittedBlocksMatch();
+
+    REQUIRE(matchingBlocks > 0);
+
+    printf("TEST_LOG: %lu blocks match on all nodes\n", (unsigned long) matchingBlocks);
+
+    engine->exitGracefullyBlocking();
+    delete engine;
+    SUCCEED();
+}
+
 
 
 
@@ -268,4 +413,562 @@ TEST_CASE_METHOD(StartFromScratch, "Test sgx server connection", "[sgx]") {
     // basicRun();
     SUCCEED();
 
-}
\ No newline at end of file
+}
+
+
+/* Calls _run(i) for i in [0, _count), prints the rate and returns the elapsed ms */
+uint64_t timeRuns(const string &_name, uint64_t _count, const std::function<void(uint64_t)> &_run) {
+
+    auto startTime = Time::getCurrentTimeMs();
+
+    for (uint64_t i = 0; i < _count; i++) {
+        _run(i);
+    }
+
+    auto elapsedMs = std::max(Time::getCurrentTimeMs() - startTime, (uint64_t) 1);
+
+    printf("TEST_LOG: %s: %lu in %lu ms, %lu/sec\n", _name.c_str(), (unsigned long) _count,
+           (unsigned long) elapsedMs, (unsigned long) (_count * 1000 / elapsedMs));
+
+    return elapsedMs;
+}
+
+
+ptr<SHAHash> createTestHash(uint64_t _i) {
+    auto msg = make_shared<vector<uint8_t>>();
+    msg->push_back(_i % 256);
+    msg->push_back(_i / 256);
+    return SHAHash::calculateHash(msg);
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Sign and verify ECDSA", "[ecdsa]") {
+
+    string keyFilePath("/tmp/ecdsa_test_key.pem");
+
+    auto publicKey = LocalECDSASigner::generateKeyFile(keyFilePath);
+    auto signer = make_shared<LocalECDSASigner>(keyFilePath);
+    REQUIRE(*signer->getPublicKey() == *publicKey);
+
+    ECDSAVerify verify;
+    verify.addPublicKey(1, publicKey);
+
+    for (uint64_t i = 0; i < 10; i++) {
+        auto hash = createTestHash(i);
+        auto sig = signer->sign(hash);
+        REQUIRE(sig != nullptr);
+
+        // the cached key and the hex key paths have to agree
+        REQUIRE(verify.verify(hash, sig, 1));
+        REQUIRE_NOTHROW(verify.signature_verify(hash, publicKey, sig));
+
+        auto otherHash = createTestHash(i + 1);
+        REQUIRE(!verify.verify(otherHash, sig, 1));
+        REQUIRE_THROWS(verify.signature_verify(otherHash, publicKey, sig));
+    }
+
+    REQUIRE(make_shared<MockupECDSASigner>()->sign(createTestHash(0)) != nullptr);
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Benchmark ECDSA signers", "[.][ecdsa-sign-benchmark]") {
+
+    auto hash = createTestHash(0);
+
+    auto mockupSigner = make_shared<MockupECDSASigner>();
+    timeRuns("mockup ECDSA signatures", 100000, [&](uint64_t) { mockupSigner->sign(hash); });
+
+    string keyFilePath("/tmp/ecdsa_benchmark_key.pem");
+
+    LocalECDSASigner::generateKeyFile(keyFilePath);
+    auto localSigner = make_shared<LocalECDSASigner>(keyFilePath);
+
+    timeRuns("local ECDSA signatures", 1000, [&](uint64_t) { localSigner->sign(hash); });
+
+    // needs an SGX wallet running on localhost
+    if (std::getenv("TEST_SGX_BENCHMARK") != nullptr) {
+
+        string certDir("/tmp");
+
+        CryptoManager::generateSSLClientCertAndKey(certDir);
+
+        auto certFilePath = certDir + "/cert";
+        auto keyFilePath = certDir + "/key";
+
+        CryptoManager::setSGXKeyAndCert(keyFilePath, certFilePath);
+
+        jsonrpc::HttpClient client("https://localhost:" + to_string(SGX_SSL_PORT));
+        auto c = make_shared<StubClient>(client, jsonrpc::JSONRPC_CLIENT_V2);
+
+        auto keyName = CryptoManager::generateSGXECDSAKey(c).first;
+        auto sgxSigner = make_shared<SGXECDSASigner>(make_shared<string>("localhost"), keyName);
+
+        timeRuns("SGX ECDSA signatures", 100, [&](uint64_t) { sgxSigner->sign(hash); });
+    }
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Benchmark ECDSA verification", "[.][ecdsa-verify-benchmark]") {
+
+    string keyFilePath("/tmp/ecdsa_benchmark_key.pem");
+
+    auto publicKey = LocalECDSASigner::generateKeyFile(keyFilePath);
+    auto signer = make_shared<LocalECDSASigner>(keyFilePath);
+
+    ECDSAVerify verify;
+    verify.addPublicKey(1, publicKey);
+
+    vector<ptr<SHAHash>> hashes;
+    vector<ptr<string>> sigs;
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        hashes.push_back(createTestHash(i));
+        sigs.push_back(signer->sign(hashes.back()));
+    }
+
+    timeRuns("ECDSA verifications with a cached key", hashes.size(),
+             [&](uint64_t i) { verify.verify(hashes.at(i), sigs.at(i), 1); });
+
+    timeRuns("ECDSA verifications with a hex key", hashes.size(),
+             [&](uint64_t i) { verify.signature_verify(hashes.at(i), publicKey, sigs.at(i)); });
+}
+
+
+/* Shares of a random (_requiredSigners, _nodeCount) threshold key over a random hash point */
+struct TestBLSShares {
+
+    libff::alt_bn128_G1 hashPoint;
+    libff::alt_bn128_G2 publicKey;
+    vector<size_t> signerIndices;
+    vector<libff::alt_bn128_G1> shares;
+    vector<pair<ptr<libff::alt_bn128_G1>, ptr<libff::alt_bn128_G2>>> sharesWithPublicKeys;
+
+    TestBLSShares(uint64_t _requiredSigners, uint64_t _signers) {
+
+        vector<libff::alt_bn128_Fr> polynomial;
+
+        for (uint64_t i = 0; i < _requiredSigners; i++) {
+            polynomial.push_back(libff::alt_bn128_Fr::random_element());
+        }
+
+        hashPoint = libff::alt_bn128_Fr::random_element() * libff::alt_bn128_G1::one();
+        publicKey = polynomial.at(0) * libff::alt_bn128_G2::one();
+
+        for (uint64_t i = 1; i <= _signers; i++) {
+            auto secretKeyShare = libff::alt_bn128_Fr::zero();
+            for (auto coeff = polynomial.rbegin(); coeff != polynomial.rend(); coeff++) {
+                secretKeyShare = secretKeyShare * libff::alt_bn128_Fr((long) i) + *coeff;
+            }
+
+            signerIndices.push_back(i);
+            shares.push_back(secretKeyShare * hashPoint);
+            sharesWithPublicKeys.push_back({make_shared<libff::alt_bn128_G1>(shares.back()),
+                                            make_shared<libff::alt_bn128_G2>(
+                                                    secretKeyShare * libff::alt_bn128_G2::one())});
+        }
+    }
+
+    bool verify(const libff::alt_bn128_G1 &_signature) const {
+        return libff::alt_bn128_ate_reduced_pairing(_signature, libff::alt_bn128_G2::one()) ==
+               libff::alt_bn128_ate_reduced_pairing(hashPoint, publicKey);
+    }
+};
+
+
+TEST_CASE_METHOD(StartFromScratch, "Merge and verify BLS sig shares", "[bls-merge]") {
+
+    libff::init_alt_bn128_params();
+
+    uint64_t nodeCount = 16;
+    uint64_t requiredSigners = 2 * nodeCount / 3 + 1;
+
+    TestBLSShares test(requiredSigners, requiredSigners);
+
+    signatures::Bls bls(requiredSigners, nodeCount);
+    LagrangeCoeffsCache cache(nodeCount, requiredSigners, LAGRANGE_COEFFS_CACHE_SIZE);
+
+    auto signature = LagrangeCoeffsCache::combine(test.shares, *cache.getCoeffs(test.signerIndices));
+
+    REQUIRE(test.verify(signature));
+    REQUIRE(signature == bls.SignatureRecover(test.shares, bls.LagrangeCoeffs(test.signerIndices)));
+
+    // cached coefficients are reused for the second merge
+    REQUIRE(LagrangeCoeffsCache::combine(test.shares, *cache.getCoeffs(test.signerIndices)) == signature);
+
+    REQUIRE(CryptoManager::findBadBLSSigSharePositions(test.hashPoint, test.sharesWithPublicKeys).empty());
+
+    // a corrupted share breaks the merged signature and is the only one rejected
+    test.shares.at(5) = test.shares.at(5) + libff::alt_bn128_G1::one();
+    *test.sharesWithPublicKeys.at(5).first = test.shares.at(5);
+
+    REQUIRE(!test.verify(LagrangeCoeffsCache::combine(test.shares, *cache.getCoeffs(test.signerIndices))));
+    REQUIRE(CryptoManager::findBadBLSSigSharePositions(test.hashPoint, test.sharesWithPublicKeys) ==
+            vector<uint64_t>{5});
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Benchmark BLS signature merging", "[.][bls-merge-benchmark]") {
+
+    libff::init_alt_bn128_params();
+
+    for (uint64_t nodeCount : {4, 16, 32}) {
+
+        uint64_t requiredSigners = 2 * nodeCount / 3 + 1;
+
+        TestBLSShares test(requiredSigners, requiredSigners);
+
+        signatures::Bls bls(requiredSigners, nodeCount);
+        LagrangeCoeffsCache cache(nodeCount, requiredSigners, LAGRANGE_COEFFS_CACHE_SIZE);
+
+        auto prefix = to_string(nodeCount) + " nodes: ";
+
+        timeRuns(prefix + "libBLS merges", 100, [&](uint64_t) {
+            bls.SignatureRecover(test.shares, bls.LagrangeCoeffs(test.signerIndices));
+        });
+
+        timeRuns(prefix + "merges with cached coefficients", 100, [&](uint64_t) {
+            LagrangeCoeffsCache::combine(test.shares, *cache.getCoeffs(test.signerIndices));
+        });
+
+        timeRuns(prefix + "batch share verifications", 10, [&](uint64_t) {
+            CryptoManager::findBadBLSSigSharePositions(test.hashPoint, test.sharesWithPublicKeys);
+        });
+    }
+}
+
+
+/* Random affine points with their libBLS and compact encodings */
+struct TestBLSEncodings {
+
+    vector<libff::alt_bn128_G1> points;
+    vector<ptr<string>> legacyStrings;
+    vector<ptr<string>> compactStrings;
+
+    explicit TestBLSEncodings(uint64_t _count) {
+        string hint("");
+
+        for (uint64_t i = 0; i < _count; i++) {
+            auto point = libff::alt_bn128_Fr::random_element() * libff::alt_bn128_G1::one();
+            point.to_affine_coordinates();
+            points.push_back(point);
+            legacyStrings.push_back(
+                    BLSSigShare(make_shared<libff::alt_bn128_G1>(point), hint, 1, 16, 11).toString());
+            compactStrings.push_back(BLSSigCodec::encode(point));
+        }
+    }
+};
+
+
+TEST_CASE_METHOD(StartFromScratch, "Encode and decode BLS sig shares", "[bls-codec]") {
+
+    libff::init_alt_bn128_params();
+
+    TestBLSEncodings test(100);
+
+    BLSSigCodec codec(BLS_SIG_CODEC_CACHE_SIZE);
+
+    for (uint64_t i = 0; i < test.points.size(); i++) {
+        REQUIRE(test.compactStrings[i]->size() == 2 * BLSSigCodec::ENCODED_SIZE);
+        REQUIRE(*codec.decode(test.legacyStrings[i]) == test.points[i]);
+        REQUIRE(*codec.decode(test.compactStrings[i]) == test.points[i]);
+        // cached decodes return the same point
+        REQUIRE(*codec.decode(test.compactStrings[i]) == test.points[i]);
+        REQUIRE(*BLSSigCodec::encode(*codec.decode(test.legacyStrings[i])) == *test.compactStrings[i]);
+    }
+
+    // a point that is not on the curve is rejected
+    auto corrupt = make_shared<string>(*test.compactStrings[0]);
+    corrupt->at(100) = (corrupt->at(100) == '0') ? '1' : '0';
+    REQUIRE_THROWS(codec.decode(corrupt));
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Benchmark BLS sig share decoding", "[.][bls-codec-benchmark]") {
+
+    libff::init_alt_bn128_params();
+
+    TestBLSEncodings test(1000);
+
+    auto count = test.points.size();
+
+    timeRuns("libBLS share decodes", count,
+             [&](uint64_t i) { BLSSigShare(test.legacyStrings[i], 1, 16, 11); });
+
+    BLSSigCodec codec(BLS_SIG_CODEC_CACHE_SIZE);
+
+    timeRuns("compact share decodes", count, [&](uint64_t i) { codec.decode(test.compactStrings[i]); });
+    timeRuns("cached compact share decodes", count, [&](uint64_t i) { codec.decode(test.compactStrings[i]); });
+}
+
+
+/* Copies the sample, so that hashes cached by an earlier run are not reused */
+ptr<TransactionList> copyTransactionList(ptr<TransactionList> _sample) {
+    auto transactions = make_shared<vector<ptr<Transaction>>>();
+
+    for (auto &&t : *_sample->getItems()) {
+        transactions->push_back(make_shared<Transaction>(t->getData(), false));
+    }
+
+    return make_shared<TransactionList>(transactions);
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Hash with every supported SHA256 implementation", "[sha]") {
+
+    boost::random::mt19937 gen;
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    auto sample = TransactionList::createRandomSample(1000, gen, ubyte);
+
+    string abc("abc");
+    vector<uint8_t> abcDigest{0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae,
+                              0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61,
+                              0xf2, 0x00, 0x15, 0xad};
+
+    auto defaultImplementation = SHA256Hasher::getImplementation();
+
+    ptr<SHAHash> expectedRoot = nullptr;
+
+    for (auto implementation : {SHA256Hasher::SOFTWARE, SHA256Hasher::AVX2, SHA256Hasher::SHA_NI}) {
+
+        if (!SHA256Hasher::isSupported(implementation))
+            continue;
+
+        SHA256Hasher::setImplementation(implementation);
+
+        vector<uint8_t> digest(SHA_HASH_LEN);
+        SHA256Hasher::hash((const uint8_t *) abc.data(), abc.size(), digest.data());
+        REQUIRE(digest == abcDigest);
+
+        // messages of different lengths hashed in lanes match one by one hashing
+        vector<const uint8_t *> data;
+        vector<uint64_t> lens;
+        for (auto &&t : *sample->getItems()) {
+            data.push_back(t->getData()->data());
+            lens.push_back(t->getData()->size());
+        }
+
+        vector<uint8_t> digests(data.size() * SHA_HASH_LEN);
+        SHA256Hasher::hashMany(data.size(), data.data(), lens.data(), digests.data());
+
+        for (uint64_t i = 0; i < data.size(); i++) {
+            SHA256Hasher::hash(data[i], lens[i], digest.data());
+            REQUIRE(memcmp(digest.data(), digests.data() + i * SHA_HASH_LEN, SHA_HASH_LEN) == 0);
+        }
+
+        auto root = copyTransactionList(sample)->calculateTopMerkleRoot();
+
+        if (expectedRoot == nullptr)
+            expectedRoot = root;
+
+        REQUIRE(root->compare(expectedRoot) == 0);
+    }
+
+    SHA256Hasher::setImplementation(defaultImplementation);
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Benchmark block hashing", "[.][sha-benchmark]") {
+
+    boost::random::mt19937 gen;
+    boost::random::uniform_int_distribution<> ubyte(0, 255);
+
+    auto sample = TransactionList::createRandomSample(10000, gen, ubyte);
+
+    auto defaultImplementation = SHA256Hasher::getImplementation();
+
+    for (auto implementation : {SHA256Hasher::SOFTWARE, SHA256Hasher::AVX2, SHA256Hasher::SHA_NI}) {
+
+        if (!SHA256Hasher::isSupported(implementation))
+            continue;
+
+        SHA256Hasher::setImplementation(implementation);
+
+        auto list = copyTransactionList(sample);
+
+        timeRuns(SHA256Hasher::getImplementationName(implementation) + " merkle roots of 10000 transactions", 1,
+                 [&](uint64_t) { list->calculateTopMerkleRoot(); });
+    }
+
+    SHA256Hasher::setImplementation(defaultImplementation);
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Compute common coins of many nodes in one process", "[common-coin]") {
+
+    uint64_t nodeCount = 16;
+    uint64_t blockCount = 100;
+    uint64_t roundCount = 8;
+
+    auto previousBlockHash = SHAHash::calculateHash(make_shared<vector<uint8_t>>(SHA_HASH_LEN, 7));
+
+    // each thread plays the consensus instances of one node, with no locking between them
+    vector<vector<uint64_t>> coins(nodeCount);
+    vector<thread> threads;
+
+    for (uint64_t node = 0; node < nodeCount; node++) {
+        threads.emplace_back([&, node]() {
+            for (uint64_t blockID = 1; blockID <= blockCount; blockID++) {
+                for (uint64_t proposer = 1; proposer <= nodeCount; proposer++) {
+                    for (uint64_t r = 0; r < roundCount; r++) {
+                        coins[node].push_back(BinConsensusInstance::calculateDeterministicRandom(
+                                schain_id(1), block_id(blockID), schain_index(proposer), bin_consensus_round(r),
+                                previousBlockHash));
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto &&t : threads) {
+        t.join();
+    }
+
+    uint64_t ones = 0;
+
+    for (uint64_t node = 1; node < nodeCount; node++) {
+        REQUIRE(coins[node] == coins[0]);
+    }
+
+    for (auto &&coin : coins[0]) {
+        ones += coin % 2;
+    }
+
+    // the coin has to be close to fair
+    REQUIRE(ones > coins[0].size() * 45 / 100);
+    REQUIRE(ones < coins[0].size() * 55 / 100);
+
+    auto otherPreviousHash = SHAHash::calculateHash(make_shared<vector<uint8_t>>(SHA_HASH_LEN, 8));
+    REQUIRE(BinConsensusInstance::calculateDeterministicRandom(schain_id(1), block_id(1), schain_index(1),
+                                                               bin_consensus_round(0), otherPreviousHash) !=
+            coins[0][0]);
+
+    SUCCEED();
+}
+
+
+/* Synthetic 0/1 votes of _nodeCount nodes for _instanceCount instances of _roundCount rounds */
+vector<uint8_t> createTestVotes(uint64_t _instanceCount, uint64_t _roundCount, uint64_t _nodeCount) {
+
+    boost::random::mt19937 gen;
+    boost::random::uniform_int_distribution<> uvalue(0, 1);
+
+    vector<uint8_t> values(_instanceCount * _roundCount * _nodeCount);
+    for (auto &&value : values) {
+        value = uvalue(gen);
+    }
+
+    return values;
+}
+
+
+/* Counts the supermajorities seen while adding the votes, the way the old per round maps did */
+uint64_t countVotesInMaps(const vector<uint8_t> &_values, uint64_t _instanceCount, uint64_t _roundCount,
+                          uint64_t _nodeCount) {
+    uint64_t count = 0;
+
+    for (uint64_t i = 0; i < _instanceCount; i++) {
+        map<bin_consensus_round, set<schain_index>> bvbTrueVotes;
+        map<bin_consensus_round, set<schain_index>> bvbFalseVotes;
+        map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>> auxTrueVotes;
+        map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>> auxFalseVotes;
+
+        for (uint64_t r = 0; r < _roundCount; r++) {
+            for (uint64_t j = 1; j <= _nodeCount; j++) {
+                auto v = _values[(i * _roundCount + r) * _nodeCount + j - 1];
+                (v ? bvbTrueVotes : bvbFalseVotes)[r].insert(j);
+                (v ? auxTrueVotes : auxFalseVotes)[r][j] = nullptr;
+                count += bvbTrueVotes[r].size() * 3 > 2 * _nodeCount;
+                count += auxTrueVotes[r].size() + auxFalseVotes[r].size() > 2 * _nodeCount / 3;
+            }
+        }
+    }
+
+    return count;
+}
+
+
+uint64_t countVotesInRoundVotes(const vector<uint8_t> &_values, uint64_t _instanceCount, uint64_t _roundCount,
+                                uint64_t _nodeCount) {
+    uint64_t count = 0;
+
+    for (uint64_t i = 0; i < _instanceCount; i++) {
+        for (uint64_t r = 0; r < _roundCount; r++) {
+            RoundVotes votes((node_count(_nodeCount)));
+            for (uint64_t j = 1; j <= _nodeCount; j++) {
+                auto v = bin_consensus_value(_values[(i * _roundCount + r) * _nodeCount + j - 1]);
+                votes.addBVBVote(v, schain_index(j));
+                votes.addAUXVote(v, schain_index(j), nullptr);
+                count += votes.getBVBVoteCount(bin_consensus_value(true)) * 3 > 2 * _nodeCount;
+                count += votes.getTotalAUXVoteCount() > 2 * _nodeCount / 3;
+            }
+        }
+    }
+
+    return count;
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Count and serialize binary consensus votes", "[round-votes]") {
+
+    uint64_t nodeCount = 16;
+    uint64_t instanceCount = 100;
+    uint64_t roundCount = 4;
+
+    auto values = createTestVotes(instanceCount, roundCount, nodeCount);
+
+    REQUIRE(countVotesInMaps(values, instanceCount, roundCount, nodeCount) ==
+            countVotesInRoundVotes(values, instanceCount, roundCount, nodeCount));
+
+    RoundVotes votes((node_count(nodeCount)));
+
+    for (uint64_t j = 1; j <= nodeCount; j++) {
+        auto v = bin_consensus_value(values[j - 1]);
+        REQUIRE(votes.addBVBVote(v, schain_index(j)));
+        REQUIRE(!votes.addBVBVote(v, schain_index(j)));
+        votes.addAUXVote(v, schain_index(j), nullptr);
+    }
+
+    votes.insertBinValue(bin_consensus_value(true));
+    votes.setBroadcast(bin_consensus_value(false));
+
+    string serialized;
+    votes.serialize(serialized);
+
+    RoundVotes restored((node_count(nodeCount)));
+    const char *data = serialized.data();
+    restored.deserialize(data, serialized.data() + serialized.size());
+
+    REQUIRE(data == serialized.data() + serialized.size());
+
+    for (bool value : {false, true}) {
+        auto v = bin_consensus_value(value);
+        REQUIRE(restored.getBVBVoteCount(v) == votes.getBVBVoteCount(v));
+        REQUIRE(restored.getAUXVoteCount(v) == votes.getAUXVoteCount(v));
+        REQUIRE(restored.hasBinValue(v) == votes.hasBinValue(v));
+        REQUIRE(restored.isBroadcast(v) == votes.isBroadcast(v));
+        for (uint64_t j = 1; j <= nodeCount; j++) {
+            REQUIRE(restored.hasAUXVote(v, schain_index(j)) == votes.hasAUXVote(v, schain_index(j)));
+        }
+    }
+
+    const char *truncated = serialized.data();
+    RoundVotes partial((node_count(nodeCount)));
+    REQUIRE_THROWS(partial.deserialize(truncated, serialized.data() + serialized.size() - 1));
+}
+
+
+TEST_CASE_METHOD(StartFromScratch, "Benchmark binary consensus vote storage", "[.][vote-benchmark]") {
+
+    uint64_t nodeCount = 16;
+    uint64_t instanceCount = 20000;
+    uint64_t roundCount = 4;
+
+    auto values = createTestVotes(instanceCount, roundCount, nodeCount);
+
+    timeRuns("vote maps of 20000 instances", 1,
+             [&](uint64_t) { countVotesInMaps(values, instanceCount, roundCount, nodeCount); });
+
+    timeRuns("round vote bitsets of 20000 instances", 1,
+             [&](uint64_t) { countVotesInRoundVotes(values, instanceCount, roundCount, nodeCount); });
+}
@@ -41,6 +41,7 @@
 #include <iostream>
 #include "assert.h"
 #include <condition_variable>
+#include <future>
 #include "stdlib.h"
 #include <unistd.h>
 #include <string>
@@ -54,6 +55,7 @@
 #include <exception>
 #include <files.h>
 #include <arpa/inet.h>
+#include <endian.h>
 #include <cassert>
 #include <boost/assert.hpp>
 #include <sys/socket.h>
@@ -163,12 +165,42 @@ static  constexpr uint64_t PROPOSAL_RETRY_INTERVAL_MS = 500;
 
 static constexpr uint64_t CATCHUP_INTERVAL_MS = 10000;
 
+static constexpr uint64_t CATCHUP_WINDOW_SIZE = 64;
+
+static constexpr uint64_t CATCHUP_DOWNLOAD_THREADS = 4;
+
 static constexpr uint64_t MONITORING_INTERVAL_MS = 1000;
 
 static constexpr uint64_t WAIT_AFTER_NETWORK_ERROR_MS = 3000;
 
 static constexpr uint64_t CONNECTION_REFUSED_LOG_INTERVAL_MS = 10 * 60 * 1000;
 
+static constexpr uint64_t CATCHUP_SCHEDULER_POLL_MS = 1000;
+
+static constexpr uint64_t CATCHUP_SLOW_WINDOW_FACTOR = 4;
+
+static constexpr uint64_t CATCHUP_MAX_PEER_BACKOFF_FACTOR = 8;
+
+static constexpr uint64_t CATCHUP_MIN_INTERVAL_MS = 100;
+
+static constexpr uint64_t CATCHUP_LAG_GRACE_MS = 1000;
+
+static constexpr uint64_t CATCHUP_MAX_INTERVAL_FACTOR = 8;
+
+// windows are scheduled at most catchupWindowSize * catchupDownloadThreads * factor blocks ahead
+static constexpr uint64_t CATCHUP_SCHEDULE_AHEAD_FACTOR = 4;
+
+static constexpr uint64_t FINALIZE_DOWNLOAD_MAX_REQUESTS_PER_PEER = 2;
+
+static constexpr uint64_t FINALIZE_DOWNLOAD_POLL_MS = 100;
+
+static constexpr uint64_t FINALIZE_DOWNLOAD_RETRY_MS = 100;
+
+static constexpr uint64_t OPTIMISTIC_SIG_SHARE_MERGE = 1;
+
+// quorums tried per arriving share when a merge fails and per-node BLS public keys are not known
+static constexpr uint64_t SIG_SHARE_MERGE_MAX_SUBSETS = 16;
+
 
 // Non-tunable params
 
@@ -198,6 +230,8 @@ static constexpr uint64_t TEST_MAGIC_NUMBER = 0x2456032650150;
 
 static const uint64_t KNOWN_TRANSACTIONS_HISTORY = 2 * MAX_TRANSACTIONS_PER_BLOCK;
 
+static const uint64_t INTERNED_TRANSACTIONS_CACHE_SIZE = 2 * KNOWN_TRANSACTIONS_HISTORY;
+
 
 enum port_type {
     PROPOSAL = 0, CATCHUP = 1, RETRIEVE = 2, HTTP_JSON = 3, BINARY_CONSENSUS = 4, ZMQ_BROADCAST = 5,
@@ -287,6 +321,35 @@ inline std::string className(const std::string &prettyFunction) {
 
 static const num_threads NUM_SCHAIN_THREADS = num_threads(1);
 
+// 1 processes all consensus messages on the schain message thread
+static constexpr uint64_t MESSAGE_PROCESSING_SHARDS = 1;
+
+// 0 calls createBlock() of the external face on the consensus thread
+static constexpr uint64_t EXT_FACE_QUEUE_SIZE = 0;
+
+// 1 builds the next proposal while the decided block is being committed
+static constexpr uint64_t PROPOSAL_PIPELINING = 0;
+
+// 0 sends each consensus vote in its own signed network message
+static constexpr uint64_t MESSAGE_COALESCING_WINDOW_MS = 0;
+
+// 1 uses a fixed common coin of 1 in round 0 of binary consensus, so an instance where 2/3 of nodes
+// vote for the proposal decides in round 0. Changes the protocol, agreement breaks unless all nodes
+// of a chain run the same version with the same value
+static constexpr uint64_t FAST_PATH_DECISION = 0;
+
+// 0 makes the node write BLS shares and signatures only in the libBLS string format and not advertise
+// the compact encoding, the way older nodes do
+static constexpr uint64_t COMPACT_BLS_ENCODING = 1;
+
+// bounds shutdown latency of the schain message and network coalescing threads
+static constexpr uint64_t SCHAIN_MESSAGE_WAIT_MS = 1000;
+
+static const num_threads NUM_CATCHUP_VERIFY_THREADS = num_threads(4);
+
+// each SGX signing thread keeps one batch request in flight over its own connection
+static const num_threads NUM_SGX_SIGN_THREADS = num_threads(4);
+
 
 static const num_threads NUM_DISPATCH_THREADS = num_threads(1);
 
@@ -302,11 +365,23 @@ static const uint64_t  BLOCK_SIG_SHARE_DB_SIZE = 10000000;
 static const uint64_t  DA_SIG_SHARE_DB_SIZE = 10000000;
 static const uint64_t  DA_PROOF_DB_SIZE = 10000000;
 static const uint64_t  BLOCK_PROPOSAL_DB_SIZE = 100000000;
+static const uint64_t  MAX_DB_BATCH_WRITES = 4096;
 static const uint64_t  MAX_DELAYED_MESSAGE_SENDS = 256;
 static const uint64_t  MAX_PROPOSAL_QUEUE_SIZE = 8;
 
 static const uint64_t SGX_SSL_PORT = 1026;
 
+static const uint64_t SGX_SIGN_MAX_BATCH_SIZE = 32;
+
+static const uint64_t LAGRANGE_COEFFS_CACHE_SIZE = 1024;
+
+static const uint64_t BLS_SIG_CODEC_CACHE_SIZE = 1024;
+
+static const uint64_t SHA_HASH_THREADS = 4;
+
+// smaller batches are hashed on the calling thread
+static const uint64_t SHA_HASH_PARALLEL_MIN_MESSAGES = 2048;
+
 
 extern void setThreadName(std::string const &_n, ConsensusEngine* _engine);
 
@@ -0,0 +1,239 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BlockFinalizeDownloadAgent.cpp
+    @author agent
+    @date 2026
+*/
+
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/ExitRequestedException.h"
+#include "exceptions/FatalError.h"
+#include "exceptions/ConnectionRefusedException.h"
+
+#include "thirdparty/json.hpp"
+
+#include "chains/Schain.h"
+#include "node/Node.h"
+#include "utils/Time.h"
+
+#include "BlockFinalizeDownloader.h"
+#include "BlockFinalizeDownloadAgent.h"
+#include "BlockFinalizeDownloadAgentThreadPool.h"
+
+
+BlockFinalizeDownloadAgent::BlockFinalizeDownloadAgent(Schain &_sChain) : Agent(_sChain, false) {
+    try {
+        logThreadLocal_ = _sChain.getNode()->getLog();
+
+        CHECK_STATE(_sChain.getNodeCount() > 1);
+
+        // a worker per peer, the per-peer limit lets fast peers pick up the work of slow ones
+        threadPool = make_shared<BlockFinalizeDownloadAgentThreadPool>(
+                (uint64_t) _sChain.getNodeCount() - 1, this);
+        threadPool->startService();
+    } catch (ExitRequestedException &) { throw; } catch (...) {
+        throw_with_nested(FatalError(__FUNCTION__, __CLASS_NAME__));
+    }
+}
+
+
+void BlockFinalizeDownloadAgent::download(ptr<BlockFinalizeDownloader> _downloader) {
+
+    CHECK_ARGUMENT(_downloader != nullptr);
+
+    auto key = make_pair((uint64_t) _downloader->getBlockId(), (uint64_t) _downloader->getProposerIndex());
+
+    unique_lock<mutex> lock(downloadMutex);
+
+    CHECK_STATE(downloaders.count(key) == 0);
+
+    downloaders[key] = _downloader;
+
+    downloadCond.notify_all();
+
+    while (!getNode()->isExitRequested() && !_downloader->isComplete()) {
+
+        // the db lookups do not need the lock
+        lock.unlock();
+        auto obsolete = _downloader->isObsolete();
+        lock.lock();
+
+        if (obsolete)
+            break;
+
+        downloadCond.wait_for(lock, chrono::milliseconds(FINALIZE_DOWNLOAD_POLL_MS));
+    }
+
+    // requests that are still in flight keep the downloader alive and are simply ignored
+    downloaders.erase(key);
+}
+
+
+ptr<BlockFinalizeDownloadJob> BlockFinalizeDownloadAgent::waitForJob() {
+
+    unique_lock<mutex> lock(downloadMutex);
+
+    auto nodeCount = (uint64_t) getSchain()->getNodeCount();
+    auto myIndex = getSchain()->getSchainIndex();
+
+    while (!getNode()->isExitRequested()) {
+
+        auto currentTime = Time::getCurrentTimeMs();
+        uint64_t waitMs = FINALIZE_DOWNLOAD_POLL_MS;
+
+        for (auto &&item : downloaders) {
+            auto downloader = item.second;
+
+            if (downloader->isComplete())
+                continue;
+
+            // rotate over peers, so that fragments of a block come from everyone
+            for (uint64_t i = 1; i <= nodeCount; i++) {
+                schain_index peer = ((uint64_t) downloader->lastPeer + i - 1) % nodeCount + 1;
+
+                if (peer == myIndex || downloader->busyPeers.count(peer) > 0)
+                    continue;
+
+                if (downloader->fragmentList.isErasureCoded() && plainFragmentPeers.count(peer) > 0)
+                    continue;
+
+                if (peerRequests[peer] >= FINALIZE_DOWNLOAD_MAX_REQUESTS_PER_PEER)
+                    continue;
+
+                auto retryTime = downloader->peerRetryTimeMs[peer];
+
+                if (retryTime > currentTime) {
+                    waitMs = std::min(waitMs, retryTime - currentTime);
+                    continue;
+                }
+
+                fragment_index fragment = downloader->fragmentList.nextIndexToRetrieve(
+                        downloader->requestedFragments);
+
+                if (fragment == 0)
+                    break;
+
+                downloader->lastPeer = peer;
+                downloader->busyPeers.insert(peer);
+                downloader->requestedFragments.insert(fragment);
+                peerRequests[peer]++;
+
+                auto job = make_shared<BlockFinalizeDownloadJob>();
+                job->downloader = downloader;
+                job->peerIndex = peer;
+                job->fragmentIndex = fragment;
+                return job;
+            }
+        }
+
+        downloadCond.wait_for(lock, chrono::milliseconds(waitMs));
+    }
+
+    return nullptr;
+}
+
+
+void BlockFinalizeDownloadAgent::jobCompleted(ptr<BlockFinalizeDownloadJob> _job, bool _received,
+                                              uint64_t _retryMs) {
+    CHECK_ARGUMENT(_job != nullptr);
+
+    lock_guard<mutex> lock(downloadMutex);
+
+    auto downloader = _job->downloader;
+
+    CHECK_STATE(peerRequests[_job->peerIndex] > 0);
+    peerRequests[_job->peerIndex]--;
+
+    downloader->busyPeers.erase(_job->peerIndex);
+    downloader->requestedFragments.erase(_job->fragmentIndex);
+
+    if (!_received)
+        downloader->peerRetryTimeMs[_job->peerIndex] = Time::getCurrentTimeMs() + _retryMs;
+
+    downloadCond.notify_all();
+}
+
+
+void BlockFinalizeDownloadAgent::peerErasureCodingArrived(schain_index _peerIndex, bool _supported) {
+    lock_guard<mutex> lock(downloadMutex);
+
+    if (_supported) {
+        plainFragmentPeers.erase(_peerIndex);
+    } else if (plainFragmentPeers.insert(_peerIndex).second) {
+        LOG(info, "Peer " + to_string(_peerIndex) + " does not support erasure coded fragments");
+    }
+}
+
+
+bool BlockFinalizeDownloadAgent::isErasureCodingSupported(uint64_t _dataFragments) {
+    lock_guard<mutex> lock(downloadMutex);
+
+    auto peerCount = (uint64_t) getSchain()->getNodeCount() - 1;
+
+    return peerCount - plainFragmentPeers.size() >= _dataFragments;
+}
+
+
+void BlockFinalizeDownloadAgent::notifyAllConditionVariables() {
+    Agent::notifyAllConditionVariables();
+    downloadCond.notify_all();
+}
+
+
+void BlockFinalizeDownloadAgent::workerThreadFragmentDownloadLoop(BlockFinalizeDownloadAgent *_agent) {
+
+    CHECK_ARGUMENT(_agent != nullptr);
+
+    auto node = _agent->getNode();
+
+    setThreadName("BlckFinLoop", node->getConsensusEngine());
+
+    _agent->waitOnGlobalStartBarrier();
+
+    try {
+        while (!node->isExitRequested()) {
+
+            auto job = _agent->waitForJob();
+
+            if (job == nullptr)
+                continue;
+
+            bool received = false;
+            uint64_t retryMs = FINALIZE_DOWNLOAD_RETRY_MS;
+
+            try {
+                received = job->downloader->downloadFragment(job->peerIndex, job->fragmentIndex);
+            } catch (ExitRequestedException &) {
+                return;
+            } catch (ConnectionRefusedException &e) {
+                _agent->logConnectionRefused(e, job->peerIndex);
+                retryMs = node->getWaitAfterNetworkErrorMs();
+            } catch (exception &e) {
+                Exception::logNested(e);
+                retryMs = node->getWaitAfterNetworkErrorMs();
+            }
+
+            _agent->jobCompleted(job, received, retryMs);
+        }
+    } catch (FatalError *e) {
+        node->exitOnFatalError(e->getMessage());
+    }
+}
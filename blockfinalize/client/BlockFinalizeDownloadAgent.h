@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BlockFinalizeDownloadAgent.h
+    @author agent
+    @date 2026
+*/
+
+
+#pragma once
+
+
+class Schain;
+class BlockFinalizeDownloader;
+class BlockFinalizeDownloadAgentThreadPool;
+
+
+/**
+ * A single fragment request to a peer
+ */
+class BlockFinalizeDownloadJob {
+public:
+    ptr<BlockFinalizeDownloader> downloader;
+    schain_index peerIndex = 0;
+    fragment_index fragmentIndex = 0;
+};
+
+
+/**
+ * Long-lived service that downloads fragments for all blocks waiting for finalization
+ * over a shared set of worker threads. Lower block ids are served first,
+ * and the number of parallel requests to a peer is limited.
+ */
+class BlockFinalizeDownloadAgent : public Agent {
+
+    mutex downloadMutex;
+
+    condition_variable downloadCond;
+
+    // (block id, proposer index) -> downloader, ordered so that the lowest block goes first
+    map<pair<uint64_t, uint64_t>, ptr<BlockFinalizeDownloader>> downloaders;
+
+    // requests in flight per peer
+    map<schain_index, uint64_t> peerRequests;
+
+    // peers that answered a request for an erasure coded fragment with a plain slice
+    set<schain_index> plainFragmentPeers;
+
+    ptr<BlockFinalizeDownloadAgentThreadPool> threadPool = nullptr;
+
+    ptr<BlockFinalizeDownloadJob> waitForJob();
+
+    void jobCompleted(ptr<BlockFinalizeDownloadJob> _job, bool _received, uint64_t _retryMs);
+
+public:
+
+    BlockFinalizeDownloadAgent(Schain &_sChain);
+
+    /**
+     * Blocks until enough fragments are downloaded or the download is not needed anymore
+     */
+    void download(ptr<BlockFinalizeDownloader> _downloader);
+
+    /**
+     * Records whether a peer answered a request for an erasure coded fragment with a coded one
+     */
+    void peerErasureCodingArrived(schain_index _peerIndex, bool _supported);
+
+    /**
+     * True unless so many peers sent plain slices that the rest can not provide _dataFragments fragments
+     */
+    bool isErasureCodingSupported(uint64_t _dataFragments);
+
+    void notifyAllConditionVariables() override;
+
+    static void workerThreadFragmentDownloadLoop(BlockFinalizeDownloadAgent *_agent);
+};
@@ -16,28 +16,24 @@
     You should have received a copy of the GNU Affero General Public License
     along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
 
-    @file BlockFinalizeDownloaderThreadPool.h
+    @file BlockFinalizeDownloadAgentThreadPool.h
     @author Stan Kladko
     @date 2019
 */
 
+
 #pragma once
 
 #include <cstdint>
 
 #include "threads/WorkerThreadPool.h"
 
-class BlockFinalizeDownloaderThreadPool : public WorkerThreadPool {
+class BlockFinalizeDownloadAgentThreadPool : public WorkerThreadPool {
 
 public:
 
-    BlockFinalizeDownloaderThreadPool(num_threads numThreads, Agent *_params);
+    BlockFinalizeDownloadAgentThreadPool(num_threads _numThreads, Agent *_agent);
 
     void createThread(uint64_t number) override;
 
-    void startService() override;
-
-    virtual ~BlockFinalizeDownloaderThreadPool();
-
 };
-
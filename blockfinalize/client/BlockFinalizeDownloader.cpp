@@ -72,6 +72,7 @@
 #include "datastructures/BlockProposalFragmentList.h"
 #include "datastructures/BlockProposalSet.h"
 #include "datastructures/BlockProposal.h"
+#include "utils/ReedSolomon.h"
 #include "db/BlockProposalDB.h"
 #include "db/DAProofDB.h"
 #include "monitoring/LivelinessMonitor.h"
@@ -82,14 +83,15 @@
 #include "pendingqueue/PendingTransactionsAgent.h"
 
 #include "BlockFinalizeDownloader.h"
-#include "BlockFinalizeDownloaderThreadPool.h"
+#include "BlockFinalizeDownloadAgent.h"
 
 
 BlockFinalizeDownloader::BlockFinalizeDownloader(Schain *_sChain, block_id _blockId, schain_index _proposerIndex)
         : Agent(*_sChain, false, true),
           blockId(_blockId),
           proposerIndex(_proposerIndex),
-          fragmentList(_blockId, (uint64_t) _sChain->getNodeCount() - 1) {
+          fragmentList(_blockId, (uint64_t) _sChain->getNodeCount() - 1,
+                       getDataFragmentCount((uint64_t) _sChain->getNodeCount())) {
 
     CHECK_ARGUMENT(_sChain != nullptr);
 
@@ -100,9 +102,6 @@ BlockFinalizeDownloader::BlockFinalizeDownloader(Schain *_sChain, block_id _bloc
 
         CHECK_STATE(sChain != nullptr);
 
-        threadCounter = 0;
-
-
     }
     catch (ExitRequestedException &) { throw; }
     catch (...) {
@@ -117,13 +116,15 @@ nlohmann::json BlockFinalizeDownloader::readBlockFinalizeResponseHeader(ptr<Clie
 }
 
 
-uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragment_index _fragmentIndex) {
+bool BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragment_index _fragmentIndex) {
 
 
     try {
 
+        uint64_t requestedDataFragments = fragmentList.isErasureCoded() ? fragmentList.getDataFragments() : 0;
+
         auto header = make_shared<BlockFinalizeRequestHeader>(*sChain, blockId, proposerIndex,
-                this->getNode()->getNodeID(), _fragmentIndex);
+                this->getNode()->getNodeID(), _fragmentIndex, requestedDataFragments);
         auto socket = make_shared<ClientSocket>(*sChain, _dstIndex, CATCHUP);
         auto io = getSchain()->getIo();
 
@@ -161,7 +162,7 @@ uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragm
 
         if (status == CONNECTION_DISCONNECT) {
             LOG(debug, "BlockFinalizec got response::no fragment");
-            return fragmentList.nextIndexToRetrieve();
+            return false;
         }
 
         if (status != CONNECTION_PROCEED) {
@@ -171,6 +172,27 @@ uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragm
         }
 
 
+        uint64_t dataFragments = 0;
+
+        if (response.find("dataFragments") != response.end())
+            dataFragments = Header::getUint64(response, "dataFragments");
+
+        if (dataFragments != 0 && dataFragments != requestedDataFragments) {
+            BOOST_THROW_EXCEPTION(NetworkProtocolException("Peer sent an unexpected erasure coded fragment",
+                                                           __CLASS_NAME__));
+        }
+
+        // a peer that does not know erasure coding answers with a plain slice. Once too few peers
+        // are left to provide the coded fragments, download plain slices from everyone instead
+        if (requestedDataFragments > 0) {
+            auto agent = getSchain()->getBlockFinalizeDownloadAgent();
+            agent->peerErasureCodingArrived(_dstIndex, dataFragments > 0);
+            if (dataFragments == 0 && !agent->isErasureCodingSupported(requestedDataFragments)) {
+                LOG(info, "Falling back to plain fragments for block " + to_string(blockId));
+                fragmentList.switchToPlainFragments();
+            }
+        }
+
         ptr<BlockProposalFragment> blockFragment = nullptr;
 
 
@@ -185,11 +207,11 @@ uint64_t BlockFinalizeDownloader::downloadFragment(schain_index _dstIndex, fragm
 
         uint64_t next = 0;
 
-        fragmentList.addFragment(blockFragment, next);
+        fragmentList.addFragment(blockFragment, next, dataFragments);
 
         LOG(debug, "BlockFinalizec success");
 
-        return next;
+        return true;
 
     } catch (ExitRequestedException &e) { throw; } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
@@ -262,81 +284,46 @@ BlockFinalizeDownloader::readBlockFragment(ptr<ClientSocket> _socket, nlohmann::
 }
 
 
-void BlockFinalizeDownloader::workerThreadFragmentDownloadLoop(BlockFinalizeDownloader *agent, schain_index _dstIndex) {
-
-    auto sChain = agent->getSchain();
-    auto node = sChain->getNode();
-    auto proposalDB = node->getBlockProposalDB();
-    auto daProofDB = node->getDaProofDB();
-    auto blockId = agent->getBlockId();
-    auto proposerIndex = agent->getProposerIndex();
-    auto sChainIndex = sChain->getSchainIndex();
-    bool testFinalizationDownloadOnly = node->getTestConfig()->isFinalizationDownloadOnly();
-
-    setThreadName("BlckFinLoop", node->getConsensusEngine());
-
-    uint64_t next = (uint64_t) _dstIndex;
-
-    node->waitOnGlobalClientStartBarrier();
-
-    if (next > (uint64_t) sChainIndex)
-        next--;
-
-    try {
-
-        while (!node->isExitRequested()) {
+bool BlockFinalizeDownloader::isComplete() {
+    return fragmentList.isComplete();
+}
 
-            if (!testFinalizationDownloadOnly) {
-                // take into account that the block can
-                //  be in parralel committed through catchup
-                if (sChain->getLastCommittedBlockID() >= blockId) {
-                    return;
-                }
+bool BlockFinalizeDownloader::isObsolete() {
 
-                // take into account that the proposal and da proof can arrive through
-                // BlockproposalServerAgent
+    if (getNode()->getTestConfig()->isFinalizationDownloadOnly())
+        return false;
 
-                if (proposalDB->proposalExists(blockId, proposerIndex)) {
-                    auto proposal = proposalDB->getBlockProposal(agent->blockId, agent->proposerIndex);
-                    if (daProofDB->haveDAProof(proposal)) {
-                        return;
-                    }
-                }
+    // take into account that the block can
+    //  be in parralel committed through catchup
+    if (sChain->getLastCommittedBlockID() >= blockId) {
+        return true;
+    }
 
-            }
+    // take into account that the proposal and da proof can arrive through
+    // BlockproposalServerAgent
+    auto proposalDB = getNode()->getBlockProposalDB();
 
-            try {
-                next = agent->downloadFragment(_dstIndex, next);
-                if (next == 0) {
-                    return;
-                }
-            } catch (ExitRequestedException &) {
-                return;
-            } catch (ConnectionRefusedException &e) {
-                agent->logConnectionRefused(e, _dstIndex);
-                usleep(node->getWaitAfterNetworkErrorMs() * 1000);
-            } catch (exception &e) {
-                Exception::logNested(e);
-                usleep(node->getWaitAfterNetworkErrorMs() * 1000);
-            };
-        };
-    } catch (FatalError *e) {
-        node->exitOnFatalError(e->getMessage());
+    if (proposalDB->proposalExists(blockId, proposerIndex)) {
+        auto proposal = proposalDB->getBlockProposal(blockId, proposerIndex);
+        if (getNode()->getDaProofDB()->haveDAProof(proposal)) {
+            return true;
+        }
     }
+
+    return false;
 }
 
 ptr<BlockProposal> BlockFinalizeDownloader::downloadProposal() {
 
     MONITOR(__CLASS_NAME__, __FUNCTION__);
 
-    {
+    auto agent = getSchain()->getBlockFinalizeDownloadAgent();
 
+    // use plain slices right away if peers are already known not to support erasure coding
+    if (fragmentList.isErasureCoded() && !agent->isErasureCodingSupported(fragmentList.getDataFragments()))
+        fragmentList.switchToPlainFragments();
 
-        threadPool = make_shared<BlockFinalizeDownloaderThreadPool>((uint64_t) getSchain()->getNodeCount(), this);
-        threadPool->startService();
-        threadPool->joinAll();
-
-    }
+    agent->download(shared_from_this());
 
     try {
 
@@ -352,6 +339,18 @@ ptr<BlockProposal> BlockFinalizeDownloader::downloadProposal() {
     }
 }
 
+uint64_t BlockFinalizeDownloader::getDataFragmentCount(uint64_t _nodeCount) {
+    CHECK_ARGUMENT(_nodeCount > 1);
+
+    auto totalFragments = _nodeCount - 1;
+
+    if (totalFragments > ReedSolomon::MAX_SHARDS)
+        return totalFragments;
+
+    // up to a third of the peers may be faulty, fragments from the rest are enough
+    return totalFragments - totalFragments / 3;
+}
+
 BlockFinalizeDownloader::~BlockFinalizeDownloader() {
 
 }
@@ -55,12 +55,13 @@ class BlockFinalizeResponseHeader;
 class BlockProposalFragment;
 class BlockProposalFragmentList;
 class BlockProposal;
-class BlockFinalizeDownloaderThreadPool;
 class BlockProposalSet;
 
 #include "datastructures/BlockProposalFragmentList.h"
 
-class BlockFinalizeDownloader : public Agent {
+class BlockFinalizeDownloader : public Agent, public enable_shared_from_this<BlockFinalizeDownloader> {
+
+    friend class BlockFinalizeDownloadAgent;
 
     block_id blockId;
 
@@ -68,22 +69,28 @@ class BlockFinalizeDownloader : public Agent {
 
     BlockProposalFragmentList fragmentList;
 
+    // scheduling state, guarded by the BlockFinalizeDownloadAgent lock
+    set<schain_index> busyPeers;
 
-public:
+    set<fragment_index> requestedFragments;
+
+    map<schain_index, uint64_t> peerRetryTimeMs;
 
-    atomic< uint64_t > threadCounter;
+    schain_index lastPeer = 0;
 
-    ptr<BlockFinalizeDownloaderThreadPool> threadPool = nullptr;
+
+public:
 
     BlockFinalizeDownloader(Schain *_sChain, block_id _blockId, schain_index _proposerIndex);
 
 
     virtual ~BlockFinalizeDownloader();
 
-    uint64_t downloadFragment(schain_index _dstIndex, fragment_index _fragmentIndex);
+    bool downloadFragment(schain_index _dstIndex, fragment_index _fragmentIndex);
 
+    bool isComplete();
 
-    static void workerThreadFragmentDownloadLoop(BlockFinalizeDownloader* agent, schain_index _dstIndex );
+    bool isObsolete();
 
     nlohmann::json readBlockFinalizeResponseHeader( ptr< ClientSocket > _socket );
 
@@ -102,6 +109,8 @@ public:
 
     block_id getBlockId();
 
+    static uint64_t getDataFragmentCount(uint64_t _nodeCount);
+
     schain_index getProposerIndex();
 };
 
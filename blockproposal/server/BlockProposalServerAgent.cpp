@@ -52,6 +52,7 @@
 
 #include "abstracttcpserver/AbstractServerAgent.h"
 #include "chains/Schain.h"
+#include "catchup/client/CatchupClientAgent.h"
 #include "crypto/SHAHash.h"
 #include "headers/BlockProposalResponseHeader.h"
 #include "headers/FinalProposalResponseHeader.h"
@@ -446,6 +447,9 @@ ptr<Header> BlockProposalServerAgent::createProposalResponseHeader(ptr<ServerCon
     }
 
     if ((uint64_t) sChain->getLastCommittedBlockID()  + 1 < (uint64_t) _header.getBlockId()) {
+        // the proposer already committed the previous block, we are behind
+        sChain->getCatchupClientAgent()->peerCommittedBlockIDArrived(nmi->getSchainIndex(),
+                                                                     _header.getBlockId() - 1);
         responseHeader->setStatusSubStatus(CONNECTION_RETRY_LATER,
                 CONNECTION_BLOCK_PROPOSAL_IN_THE_FUTURE);
         responseHeader->setComplete();
@@ -533,6 +537,8 @@ ptr<Header> BlockProposalServerAgent::createDAProofResponseHeader(ptr<ServerConn
     }
 
     if ((uint64_t) sChain->getLastCommittedBlockID()  + 1 < _header->getBlockId()) {
+        sChain->getCatchupClientAgent()->peerCommittedBlockIDArrived(nmi->getSchainIndex(),
+                                                                     _header->getBlockId() - 1);
         responseHeader->setStatusSubStatus(CONNECTION_RETRY_LATER,
                 CONNECTION_BLOCK_PROPOSAL_IN_THE_FUTURE);
         responseHeader->setComplete();
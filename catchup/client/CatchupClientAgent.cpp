@@ -41,9 +41,13 @@
 #include "network/IO.h"
 #include "network/Network.h"
 #include "pendingqueue/PendingTransactionsAgent.h"
+#include "utils/Time.h"
+
+#include "datastructures/CommittedBlock.h"
 
 #include "CatchupClientAgent.h"
 #include "CatchupClientThreadPool.h"
+#include "CatchupDownloadScheduler.h"
 
 
 CatchupClientAgent::CatchupClientAgent( Schain& _sChain ) : Agent(_sChain, false ) {
@@ -51,8 +55,21 @@ CatchupClientAgent::CatchupClientAgent( Schain& _sChain ) : Agent(_sChain, false
         logThreadLocal_ = _sChain.getNode()->getLog();
         this->sChain = &_sChain;
 
+        peerClaimedBlockIDs.resize( ( uint64_t ) _sChain.getNodeCount() + 1, 0 );
+
         if (_sChain.getNodeCount() > 1 ) {
-            this->catchupClientThreadPool = make_shared<CatchupClientThreadPool >( 1, this );
+            auto downloadThreads = std::min( getNode()->getCatchupDownloadThreads(),
+                ( uint64_t ) _sChain.getNodeCount() - 1 );
+
+            if ( downloadThreads > 0 ) {
+                scheduler = make_shared< CatchupDownloadScheduler >( _sChain.getSchainIndex(),
+                    ( uint64_t ) _sChain.getNodeCount(), getNode()->getCatchupWindowSize(),
+                    downloadThreads, getNode()->getWaitAfterNetworkErrorMs() );
+            }
+
+            // thread 0 polls peers, the rest download windows in parallel
+            this->catchupClientThreadPool =
+                make_shared<CatchupClientThreadPool >( 1 + downloadThreads, this );
             catchupClientThreadPool->startService();
         }
     } catch (ExitRequestedException &) {throw;} catch (...) {
@@ -67,10 +84,49 @@ nlohmann::json CatchupClientAgent::readCatchupResponseHeader( ptr< ClientSocket
 
 
 void CatchupClientAgent::sync( schain_index _dstIndex ) {
-    LOG( debug, "Catchupc step 0: requesting blocks after " +
-                    to_string( getSchain()->getLastCommittedBlockID() ) );
+    auto lastCommittedBlockID = getSchain()->getLastCommittedBlockID();
+
+    // when downloading in parallel, ask for the first window only and let the
+    // scheduler spread the rest of the missing range across peers
+    block_id toBlockID = 0;
+
+    if ( scheduler != nullptr )
+        toBlockID = lastCommittedBlockID + scheduler->getWindowSize();
+
+    block_id peerCommittedBlockID = 0;
+    uint64_t bytesRead = 0;
+
+    auto blocks = downloadBlocks(
+        _dstIndex, lastCommittedBlockID, toBlockID, peerCommittedBlockID, bytesRead );
+
+    peerSyncCompleted( _dstIndex, peerCommittedBlockID, blocks != nullptr );
+
+    if ( scheduler != nullptr && peerCommittedBlockID > 0 ) {
+        block_id downloadedBlockID = lastCommittedBlockID;
+        if ( blocks != nullptr )
+            downloadedBlockID = blocks->getBlocks()->back()->getBlockID();
+        scheduler->peerCommittedBlockIDArrived( _dstIndex, peerCommittedBlockID, downloadedBlockID );
+    }
+
+    if ( blocks != nullptr ) {
+        {
+            lock_guard< mutex > lock( commitMutex );
+            getSchain()->blockCommitsArrivedThroughCatchup( blocks );
+        }
+        LOG( debug, "Catchupc success" );
+    }
+
+    commitDownloadedWindows();
+}
 
-    auto header = make_shared<CatchupRequestHeader >( *sChain, _dstIndex );
+
+ptr< CommittedBlockList > CatchupClientAgent::downloadBlocks( schain_index _dstIndex,
+    block_id _afterBlockID, block_id _toBlockID, block_id& _peerCommittedBlockID,
+    uint64_t& _bytesRead ) {
+    LOG( debug, "Catchupc step 0: requesting blocks after " + to_string( _afterBlockID ) );
+
+    auto header =
+        make_shared<CatchupRequestHeader >( *sChain, _dstIndex, _afterBlockID, _toBlockID );
     auto socket = make_shared<ClientSocket >( *sChain, _dstIndex, CATCHUP );
     auto io = getSchain()->getIo();
 
@@ -110,11 +166,15 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
 
     LOG( debug, "Catchupc step 2: read catchup response header" );
 
+    // older servers do not report their committed block id
+    if ( response.find( "committedBlockID" ) != response.end() )
+        _peerCommittedBlockID = Header::getUint64( response, "committedBlockID" );
+
     auto status = ( ConnectionStatus ) Header::getUint64( response, "status" );
 
     if ( status == CONNECTION_DISCONNECT ) {
         LOG( debug, "Catchupc got response::no missing blocks" );
-        return;
+        return nullptr;
     }
 
 
@@ -128,7 +188,7 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
 
 
     try {
-        blocks = readMissingBlocks( socket, response );
+        blocks = readMissingBlocks( socket, response, _bytesRead );
     } catch ( ExitRequestedException& ) {
         throw;
     } catch ( ... ) {
@@ -139,8 +199,58 @@ void CatchupClientAgent::sync( schain_index _dstIndex ) {
 
     LOG( debug, "Catchupc step 3: got missing blocks:" + to_string( blocks->getBlocks()->size() ) );
 
-    getSchain()->blockCommitsArrivedThroughCatchup( blocks );
-    LOG( debug, "Catchupc success" );
+    return blocks;
+}
+
+
+void CatchupClientAgent::downloadWindow( ptr< CatchupWindow > _window ) {
+    CHECK_ARGUMENT( _window != nullptr );
+
+    block_id peerCommittedBlockID = 0;
+    uint64_t bytesRead = 0;
+
+    auto blocks = downloadBlocks( _window->peerIndex, _window->firstBlockID - 1,
+        _window->lastBlockID, peerCommittedBlockID, bytesRead );
+
+    if ( peerCommittedBlockID > 0 ) {
+        scheduler->peerCommittedBlockIDArrived(
+            _window->peerIndex, peerCommittedBlockID, getSchain()->getLastCommittedBlockID() );
+    }
+
+    if ( blocks == nullptr ) {
+        // the peer does not have the window, give it to somebody else
+        scheduler->windowFailed( _window );
+        return;
+    }
+
+    LOG( debug, "Catchupc downloaded window " + to_string( _window->firstBlockID ) + ":" +
+                    to_string( _window->lastBlockID ) + " from " +
+                    to_string( _window->peerIndex ) );
+
+    scheduler->windowDownloaded( _window, blocks, bytesRead );
+}
+
+
+void CatchupClientAgent::commitDownloadedWindows() {
+    if ( scheduler == nullptr )
+        return;
+
+    lock_guard< mutex > lock( commitMutex );
+
+    while ( true ) {
+        auto window = scheduler->popNextWindow( getSchain()->getLastCommittedBlockID() );
+        if ( window == nullptr )
+            return;
+
+        getSchain()->blockCommitsArrivedThroughCatchup( window->blocks );
+
+        // commit stops at the first block that does not verify
+        auto lastCommittedBlockID = getSchain()->getLastCommittedBlockID();
+        if ( lastCommittedBlockID < window->blocks->getBlocks()->back()->getBlockID() ) {
+            scheduler->windowRejected( window, lastCommittedBlockID );
+            return;
+        }
+    }
 }
 
 size_t CatchupClientAgent::parseBlockSizes(
@@ -179,13 +289,15 @@ size_t CatchupClientAgent::parseBlockSizes(
 
 
 ptr< CommittedBlockList > CatchupClientAgent::readMissingBlocks(
-    ptr< ClientSocket > _socket, nlohmann::json responseHeader ) {
+    ptr< ClientSocket > _socket, nlohmann::json responseHeader, uint64_t& _bytesRead ) {
     ASSERT( responseHeader > 0 );
 
     auto blockSizes = make_shared<vector< uint64_t > >();
 
     auto totalSize = parseBlockSizes( responseHeader, blockSizes );
 
+    _bytesRead = totalSize;
+
     auto serializedBlocks = make_shared<vector< uint8_t > >( totalSize );
 
     try {
@@ -225,9 +337,17 @@ void CatchupClientAgent::workerThreadItemSendLoop( CatchupClientAgent* agent ) {
 
     auto destinationSchainIndex = schain_index(1 );
 
+    auto intervalMs = agent->getNode()->getCatchupIntervalMs();
+
     try {
         while ( !agent->getSchain()->getNode()->isExitRequested() ) {
-            usleep( agent->getNode()->getCatchupIntervalMs() * 1000 );
+            auto laggingPeer = agent->waitForSyncTrigger( intervalMs, destinationSchainIndex );
+
+            // ask the next peer in round-robin order that claims to be ahead
+            if ( laggingPeer != 0 )
+                destinationSchainIndex = laggingPeer;
+
+            auto committedBefore = agent->getSchain()->getLastCommittedBlockID();
 
             try {
                 agent->sync(destinationSchainIndex );
@@ -240,6 +360,19 @@ void CatchupClientAgent::workerThreadItemSendLoop( CatchupClientAgent* agent ) {
                 Exception::logNested( e );
             }
 
+            {
+                lock_guard< mutex > lock( agent->lagMutex );
+                agent->lastSyncTimeMs = Time::getCurrentTimeMs();
+            }
+
+            if ( laggingPeer != 0 || agent->getSchain()->getLastCommittedBlockID() > committedBefore ) {
+                intervalMs = agent->getNode()->getCatchupIntervalMs();
+            } else {
+                // in sync, poll less and less often, lag signals will wake us up
+                intervalMs = std::min( 2 * intervalMs,
+                    agent->getNode()->getCatchupIntervalMs() * CATCHUP_MAX_INTERVAL_FACTOR );
+            }
+
             destinationSchainIndex = nextSyncNodeIndex(agent, destinationSchainIndex );
         };
     } catch ( FatalError* e ) {
@@ -247,6 +380,172 @@ void CatchupClientAgent::workerThreadItemSendLoop( CatchupClientAgent* agent ) {
     }
 }
 
+void CatchupClientAgent::workerThreadWindowDownloadLoop( CatchupClientAgent* agent ) {
+    setThreadName( "CatchupDownload", agent->getNode()->getConsensusEngine() );
+
+    agent->waitOnGlobalStartBarrier();
+
+    auto scheduler = agent->getScheduler();
+
+    CHECK_STATE( scheduler != nullptr );
+
+    try {
+        while ( !agent->getSchain()->getNode()->isExitRequested() ) {
+            auto window = scheduler->waitForWindow( CATCHUP_SCHEDULER_POLL_MS );
+
+            if ( window == nullptr )
+                continue;
+
+            try {
+                agent->downloadWindow( window );
+            } catch ( ExitRequestedException& ) {
+                return;
+            } catch ( ConnectionRefusedException& e ) {
+                scheduler->windowFailed( window );
+                agent->logConnectionRefused( e, window->peerIndex );
+            } catch ( exception& e ) {
+                scheduler->windowFailed( window );
+                Exception::logNested( e );
+            }
+
+            try {
+                agent->commitDownloadedWindows();
+            } catch ( ExitRequestedException& ) {
+                return;
+            } catch ( exception& e ) {
+                Exception::logNested( e );
+            }
+        };
+    } catch ( FatalError* e ) {
+        agent->getNode()->exitOnFatalError( e->getMessage() );
+    }
+}
+
+
+void CatchupClientAgent::notifyAllConditionVariables() {
+    Agent::notifyAllConditionVariables();
+    if ( scheduler != nullptr )
+        scheduler->exit();
+    lagCond.notify_all();
+}
+
+
+void CatchupClientAgent::peerCommittedBlockIDArrived(
+    schain_index _peerIndex, block_id _peerCommittedBlockID ) {
+    auto lastCommittedBlockID = getSchain()->getLastCommittedBlockID();
+
+    if ( _peerCommittedBlockID <= lastCommittedBlockID )
+        return;
+
+    if ( _peerIndex == 0 || _peerIndex == getSchain()->getSchainIndex() ||
+         ( uint64_t ) _peerIndex > ( uint64_t ) getSchain()->getNodeCount() )
+        return;
+
+    lock_guard< mutex > lock( lagMutex );
+
+    if ( _peerCommittedBlockID <= peerClaimedBlockIDs.at( ( uint64_t ) _peerIndex ) )
+        return;
+
+    peerClaimedBlockIDs.at( ( uint64_t ) _peerIndex ) = _peerCommittedBlockID;
+
+    updateLagBlockID();
+}
+
+
+void CatchupClientAgent::peerSyncCompleted(
+    schain_index _peerIndex, block_id _peerCommittedBlockID, bool _blocksReceived ) {
+    if ( _peerIndex == 0 || _peerIndex == getSchain()->getSchainIndex() ||
+         ( uint64_t ) _peerIndex > ( uint64_t ) getSchain()->getNodeCount() )
+        return;
+
+    lock_guard< mutex > lock( lagMutex );
+
+    // the catchup response replaces whatever the peer claimed before. A peer that
+    // did not serve a single block is not ahead of us as far as we can tell
+    if ( !_blocksReceived )
+        _peerCommittedBlockID =
+            std::min( _peerCommittedBlockID, getSchain()->getLastCommittedBlockID() );
+
+    peerClaimedBlockIDs.at( ( uint64_t ) _peerIndex ) = _peerCommittedBlockID;
+
+    updateLagBlockID();
+}
+
+
+void CatchupClientAgent::updateLagBlockID() {
+    auto nodeCount = ( uint64_t ) getSchain()->getNodeCount();
+    auto maxFaulty = ( nodeCount - 1 ) / 3;
+
+    auto claims = peerClaimedBlockIDs;
+    sort( claims.begin(), claims.end(), greater< block_id >() );
+
+    // a single peer can claim anything, so only trust an id claimed by f + 1 peers
+    block_id newLagBlockID = claims.at( maxFaulty );
+
+    auto lastCommittedBlockID = getSchain()->getLastCommittedBlockID();
+
+    // a new lag, as opposed to peers that keep moving ahead of us
+    if ( newLagBlockID > lastCommittedBlockID && lagBlockID <= lastCommittedBlockID )
+        lagDetectedTimeMs = Time::getCurrentTimeMs();
+
+    lagBlockID = newLagBlockID;
+
+    if ( lagBlockID > lastCommittedBlockID )
+        lagCond.notify_all();
+}
+
+
+schain_index CatchupClientAgent::waitForSyncTrigger(
+    uint64_t _intervalMs, schain_index _nextPeerIndex ) {
+    unique_lock< mutex > lock( lagMutex );
+
+    auto deadline = Time::getCurrentTimeMs() + _intervalMs;
+
+    while ( !getSchain()->getNode()->isExitRequested() ) {
+        auto currentTime = Time::getCurrentTimeMs();
+        auto lastCommittedBlockID = getSchain()->getLastCommittedBlockID();
+
+        // while windows are being downloaded the scheduler already takes care of the lag
+        bool downloading = scheduler != nullptr && scheduler->isDownloading();
+
+        if ( lagBlockID > lastCommittedBlockID && !downloading ) {
+            // being a single block behind is normal while peers commit concurrently
+            uint64_t triggerTime = currentTime;
+            if ( lagBlockID == lastCommittedBlockID + 1 )
+                triggerTime = lagDetectedTimeMs + CATCHUP_LAG_GRACE_MS;
+
+            triggerTime = std::max( triggerTime, lastSyncTimeMs + CATCHUP_MIN_INTERVAL_MS );
+
+            if ( triggerTime <= currentTime ) {
+                auto nodeCount = ( uint64_t ) getSchain()->getNodeCount();
+                for ( uint64_t i = 0; i < nodeCount; i++ ) {
+                    auto peer = ( ( uint64_t ) _nextPeerIndex - 1 + i ) % nodeCount + 1;
+                    if ( peerClaimedBlockIDs.at( peer ) >= lagBlockID )
+                        return schain_index( peer );
+                }
+                return 0;
+            }
+
+            deadline = std::min( deadline, triggerTime );
+        }
+
+        if ( currentTime >= deadline )
+            return 0;
+
+        // commits do not signal this condition, so wake up periodically to re-check the lag
+        lagCond.wait_for( lock, chrono::milliseconds( std::min( deadline - currentTime,
+                                    ( uint64_t ) CATCHUP_SCHEDULER_POLL_MS ) ) );
+    }
+
+    return 0;
+}
+
+
+ptr< CatchupDownloadScheduler > CatchupClientAgent::getScheduler() const {
+    return scheduler;
+}
+
+
 schain_index CatchupClientAgent::nextSyncNodeIndex(
     const CatchupClientAgent* agent, schain_index _destinationSchainIndex ) {
     auto nodeCount = ( uint64_t ) agent->getSchain()->getNodeCount();
@@ -29,9 +29,37 @@ class ClientSocket;
 class Schain;
 class CatchupClientThreadPool;
 class CatchupResponseHeader;
+class CatchupDownloadScheduler;
+class CatchupWindow;
 
 class CatchupClientAgent : public Agent {
 
+    // nullptr if parallel window download is disabled
+    ptr< CatchupDownloadScheduler > scheduler = nullptr;
+
+    // windows need to be popped and committed atomically to keep block order
+    mutex commitMutex;
+
+    // lag signals from consensus and peers wake up the sync loop early
+    mutex lagMutex;
+
+    condition_variable lagCond;
+
+    // committed block ids claimed by peers, indexed by schain index
+    vector< block_id > peerClaimedBlockIDs;
+
+    // highest block id claimed by more than f peers, so at least one honest peer has it
+    block_id lagBlockID = 0;
+
+    // when this node first fell behind lagBlockID
+    uint64_t lagDetectedTimeMs = 0;
+
+    uint64_t lastSyncTimeMs = 0;
+
+    schain_index waitForSyncTrigger( uint64_t _intervalMs, schain_index _nextPeerIndex );
+
+    void updateLagBlockID();
+
 public:
 
     ptr< CatchupClientThreadPool > catchupClientThreadPool = nullptr;
@@ -43,13 +71,40 @@ public:
     void sync( schain_index _dstIndex );
 
 
+    ptr< CommittedBlockList > downloadBlocks( schain_index _dstIndex, block_id _afterBlockID,
+        block_id _toBlockID, block_id& _peerCommittedBlockID, uint64_t& _bytesRead );
+
+
+    void downloadWindow( ptr< CatchupWindow > _window );
+
+
+    void commitDownloadedWindows();
+
+
+    void peerCommittedBlockIDArrived( schain_index _peerIndex, block_id _peerCommittedBlockID );
+
+
+    void peerSyncCompleted(
+        schain_index _peerIndex, block_id _peerCommittedBlockID, bool _blocksReceived );
+
+
     static void workerThreadItemSendLoop( CatchupClientAgent* agent );
 
+
+    static void workerThreadWindowDownloadLoop( CatchupClientAgent* agent );
+
+
+    void notifyAllConditionVariables() override;
+
+
+    ptr< CatchupDownloadScheduler > getScheduler() const;
+
+
     nlohmann::json readCatchupResponseHeader( ptr< ClientSocket > _socket );
 
 
     ptr< CommittedBlockList > readMissingBlocks(
-        ptr< ClientSocket > _socket, nlohmann::json responseHeader );
+        ptr< ClientSocket > _socket, nlohmann::json responseHeader, uint64_t& _bytesRead );
 
 
     size_t parseBlockSizes( nlohmann::json _responseHeader, ptr< vector< uint64_t > > _blockSizes );
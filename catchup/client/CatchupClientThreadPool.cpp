@@ -42,11 +42,15 @@ CatchupClientThreadPool::CatchupClientThreadPool(
 }
 
 
-void CatchupClientThreadPool::createThread(uint64_t /*number*/) {
+void CatchupClientThreadPool::createThread(uint64_t number) {
 
     auto a = (CatchupClientAgent*) agent;
 
-    this->threadpool.push_back(make_shared<thread>(CatchupClientAgent::workerThreadItemSendLoop, a));
+    if (number == 0) {
+        this->threadpool.push_back(make_shared<thread>(CatchupClientAgent::workerThreadItemSendLoop, a));
+    } else {
+        this->threadpool.push_back(make_shared<thread>(CatchupClientAgent::workerThreadWindowDownloadLoop, a));
+    }
 
 }
 
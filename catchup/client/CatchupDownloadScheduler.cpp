@@ -0,0 +1,431 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupDownloadScheduler.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "datastructures/CommittedBlock.h"
+#include "datastructures/CommittedBlockList.h"
+#include "utils/Time.h"
+
+#include "CatchupDownloadScheduler.h"
+
+
+CatchupDownloadScheduler::CatchupDownloadScheduler(schain_index _myIndex, uint64_t _nodeCount,
+                                                   uint64_t _windowSize, uint64_t _downloadThreads,
+                                                   uint64_t _waitAfterNetworkErrorMs)
+        : myIndex(_myIndex),
+          nodeCount(_nodeCount),
+          windowSize(_windowSize),
+          waitAfterNetworkErrorMs(_waitAfterNetworkErrorMs),
+          maxScheduleAheadBlocks(_windowSize * std::max(_downloadThreads, (uint64_t) 1) *
+                                 CATCHUP_SCHEDULE_AHEAD_FACTOR) {
+    CHECK_ARGUMENT(_myIndex > 0);
+    CHECK_ARGUMENT(_nodeCount > 1);
+    CHECK_ARGUMENT(_windowSize > 0);
+}
+
+
+void CatchupDownloadScheduler::peerCommittedBlockIDArrived(schain_index _peerIndex,
+                                                           block_id _peerCommittedBlockID,
+                                                           block_id _downloadedBlockID) {
+    LOCK(m)
+
+    auto stats = getPeerStats(_peerIndex);
+
+    if (_peerCommittedBlockID > stats->committedBlockID)
+        stats->committedBlockID = _peerCommittedBlockID;
+
+    removeObsoleteWindows(_downloadedBlockID);
+
+    if (_downloadedBlockID > committedBlockID)
+        committedBlockID = _downloadedBlockID;
+
+    if (_downloadedBlockID > scheduledBlockID)
+        scheduledBlockID = _downloadedBlockID;
+
+    if (_peerCommittedBlockID > targetBlockID)
+        targetBlockID = _peerCommittedBlockID;
+
+    scheduleWindows();
+}
+
+
+void CatchupDownloadScheduler::scheduleWindows() {
+
+    // the rest of the range is scheduled as committed windows make room
+    auto limit = std::min((uint64_t) targetBlockID,
+                          (uint64_t) std::max(committedBlockID, poppedBlockID) + maxScheduleAheadBlocks);
+
+    bool created = false;
+
+    while (scheduledBlockID < limit) {
+        block_id first = scheduledBlockID + 1;
+        block_id last = std::min((uint64_t) scheduledBlockID + windowSize, limit);
+        pendingWindows[first] = last;
+        scheduledBlockID = last;
+        created = true;
+    }
+
+    if (created) {
+        LOG(debug, "Catchupc scheduled windows up to block:" + to_string(scheduledBlockID));
+        windowCond.notify_all();
+    }
+}
+
+
+ptr<CatchupWindow> CatchupDownloadScheduler::waitForWindow(uint64_t _timeoutMs) {
+
+    unique_lock<recursive_mutex> lock(m);
+
+    auto deadline = Time::getCurrentTimeMs() + _timeoutMs;
+
+    while (!exitRequested) {
+
+        auto currentTime = Time::getCurrentTimeMs();
+
+        scheduleWindows();
+
+        // lowest windows first, since they block in-order commit of everything else
+        for (auto &&item : pendingWindows) {
+            auto peer = selectPeer(item.first, item.second, currentTime);
+            if (peer != 0) {
+                auto window = assignWindow(item.first, item.second, peer, currentTime);
+                pendingWindows.erase(window->firstBlockID);
+                return window;
+            }
+        }
+
+        if (pendingWindows.empty()) {
+            // nothing left to assign, help out with a window stuck on a slow peer
+            auto slowWindow = selectSlowWindow(currentTime);
+            if (slowWindow != nullptr) {
+                auto peer = selectPeer(slowWindow->firstBlockID, slowWindow->lastBlockID, currentTime);
+                if (peer != 0) {
+                    LOG(debug, "Catchupc reassigning slow window " + to_string(slowWindow->firstBlockID) +
+                               " from peer " + to_string(slowWindow->peerIndex));
+                    auto window = assignWindow(slowWindow->firstBlockID, slowWindow->lastBlockID, peer,
+                                               currentTime);
+                    window->isDuplicate = true;
+                    return window;
+                }
+            }
+        }
+
+        if (currentTime >= deadline)
+            return nullptr;
+
+        windowCond.wait_for(lock, chrono::milliseconds(
+                std::min(deadline - currentTime, (uint64_t) CATCHUP_SCHEDULER_POLL_MS)));
+    }
+
+    return nullptr;
+}
+
+
+void CatchupDownloadScheduler::windowDownloaded(ptr<CatchupWindow> _window, ptr<CommittedBlockList> _blocks,
+                                                uint64_t _bytes) {
+    CHECK_ARGUMENT(_window != nullptr);
+    CHECK_ARGUMENT(_blocks != nullptr);
+
+    LOCK(m)
+
+    auto elapsedMs = std::max(Time::getCurrentTimeMs() - _window->startTimeMs, (uint64_t) 1);
+
+    auto stats = getPeerStats(_window->peerIndex);
+    stats->busy = false;
+    stats->consecutiveFailures = 0;
+    stats->backoffUntilMs = 0;
+
+    auto bytesPerSec = _bytes * 1000 / elapsedMs;
+
+    // exponential moving averages, so a peer that slows down loses its priority quickly
+    if (stats->windowsDownloaded == 0) {
+        stats->bytesPerSec = bytesPerSec;
+    } else {
+        stats->bytesPerSec = (stats->bytesPerSec + bytesPerSec) / 2;
+    }
+    stats->windowsDownloaded++;
+
+    if (averageWindowTimeMs == 0) {
+        averageWindowTimeMs = elapsedMs;
+    } else {
+        averageWindowTimeMs = (3 * averageWindowTimeMs + elapsedMs) / 4;
+    }
+
+    auto blocks = _blocks->getBlocks();
+    CHECK_STATE(blocks->size() > 0);
+
+    auto firstID = blocks->front()->getBlockID();
+    auto lastID = blocks->back()->getBlockID();
+
+    if (lastID > stats->committedBlockID)
+        stats->committedBlockID = lastID;
+
+    if (lastID > poppedBlockID && downloadedWindows.count(_window->firstBlockID) == 0) {
+        CHECK_STATE(firstID <= _window->firstBlockID);
+        _window->blocks = _blocks;
+        downloadedWindows[_window->firstBlockID] = _window;
+
+        // the peer returned less than requested, the rest goes back to the queue
+        if (lastID < _window->lastBlockID && pendingWindows.count(lastID + 1) == 0) {
+            pendingWindows[lastID + 1] = _window->lastBlockID;
+        }
+    }
+
+    // the window is done, do not let a slow duplicate keep it in flight
+    inFlightWindows.erase(_window->firstBlockID);
+
+    releaseWindow(_window);
+
+    windowCond.notify_all();
+}
+
+
+void CatchupDownloadScheduler::windowFailed(ptr<CatchupWindow> _window) {
+    CHECK_ARGUMENT(_window != nullptr);
+
+    LOCK(m)
+
+    auto stats = getPeerStats(_window->peerIndex);
+    stats->busy = false;
+    backOff(stats);
+
+    releaseWindow(_window);
+
+    auto inFlight = inFlightWindows.find(_window->firstBlockID);
+    if (inFlight != inFlightWindows.end() && inFlight->second == _window)
+        inFlightWindows.erase(inFlight);
+
+    if (inFlightCounts.count(_window->firstBlockID) == 0 &&
+        downloadedWindows.count(_window->firstBlockID) == 0 &&
+        _window->lastBlockID > poppedBlockID) {
+        pendingWindows[_window->firstBlockID] = _window->lastBlockID;
+    }
+
+    windowCond.notify_all();
+}
+
+
+ptr<CatchupWindow> CatchupDownloadScheduler::popNextWindow(block_id _lastCommittedBlockID) {
+
+    LOCK(m)
+
+    removeObsoleteWindows(_lastCommittedBlockID);
+
+    if (_lastCommittedBlockID > committedBlockID)
+        committedBlockID = _lastCommittedBlockID;
+
+    while (!downloadedWindows.empty()) {
+        auto item = downloadedWindows.begin();
+        auto window = item->second;
+        auto blocks = window->blocks;
+        auto lastID = blocks->getBlocks()->back()->getBlockID();
+
+        if (lastID <= _lastCommittedBlockID) {
+            // already committed through consensus or another window
+            downloadedWindows.erase(item);
+            continue;
+        }
+
+        if (blocks->getBlocks()->front()->getBlockID() > _lastCommittedBlockID + 1) {
+            // there is a gap, wait for the lower window
+            return nullptr;
+        }
+
+        downloadedWindows.erase(item);
+
+        if (lastID > poppedBlockID)
+            poppedBlockID = lastID;
+
+        return window;
+    }
+
+    return nullptr;
+}
+
+
+void CatchupDownloadScheduler::windowRejected(ptr<CatchupWindow> _window, block_id _lastCommittedBlockID) {
+    CHECK_ARGUMENT(_window != nullptr);
+    CHECK_ARGUMENT(_window->blocks != nullptr);
+
+    LOCK(m)
+
+    auto lastID = _window->blocks->getBlocks()->back()->getBlockID();
+
+    if (lastID <= _lastCommittedBlockID)
+        return;
+
+    LOG(warn, "Catchupc blocks from " + to_string(_lastCommittedBlockID + 1) + " downloaded from peer " +
+              to_string(_window->peerIndex) + " did not verify, rescheduling");
+
+    auto stats = getPeerStats(_window->peerIndex);
+    stats->rejectedBlockID = _lastCommittedBlockID + 1;
+    backOff(stats);
+
+    // the popped range was not committed, so it has to be handed out again
+    if (poppedBlockID > _lastCommittedBlockID)
+        poppedBlockID = _lastCommittedBlockID;
+
+    if (pendingWindows.count(_lastCommittedBlockID + 1) == 0 &&
+        downloadedWindows.count(_lastCommittedBlockID + 1) == 0) {
+        pendingWindows[_lastCommittedBlockID + 1] = lastID;
+    }
+
+    windowCond.notify_all();
+}
+
+
+bool CatchupDownloadScheduler::isDownloading() {
+    LOCK(m)
+    return !pendingWindows.empty() || !inFlightCounts.empty() || !downloadedWindows.empty();
+}
+
+
+uint64_t CatchupDownloadScheduler::getWindowSize() const {
+    return windowSize;
+}
+
+
+void CatchupDownloadScheduler::exit() {
+    LOCK(m)
+    exitRequested = true;
+    windowCond.notify_all();
+}
+
+
+ptr<CatchupPeerStats> CatchupDownloadScheduler::getPeerStats(schain_index _peerIndex) {
+    CHECK_ARGUMENT(_peerIndex > 0 && (uint64_t) _peerIndex <= nodeCount);
+
+    auto result = peerStats.find(_peerIndex);
+
+    if (result != peerStats.end())
+        return result->second;
+
+    auto stats = make_shared<CatchupPeerStats>();
+    peerStats[_peerIndex] = stats;
+    return stats;
+}
+
+
+void CatchupDownloadScheduler::backOff(ptr<CatchupPeerStats> _stats) {
+    _stats->consecutiveFailures++;
+    _stats->backoffUntilMs = Time::getCurrentTimeMs() +
+                             waitAfterNetworkErrorMs * std::min(_stats->consecutiveFailures,
+                                                                (uint64_t) CATCHUP_MAX_PEER_BACKOFF_FACTOR);
+}
+
+
+schain_index CatchupDownloadScheduler::selectPeer(block_id _firstBlockID, block_id _lastBlockID,
+                                                  uint64_t _currentTimeMs) {
+
+    schain_index bestPeer = 0;
+    uint64_t bestScore = 0;
+
+    for (uint64_t i = 1; i <= nodeCount; i++) {
+        if (i == myIndex)
+            continue;
+
+        auto stats = getPeerStats(i);
+
+        // the catchup server of a peer has a single worker, so one request per peer at a time
+        if (stats->busy || stats->backoffUntilMs > _currentTimeMs)
+            continue;
+
+        // the peer is known to be behind this window
+        if (stats->committedBlockID != 0 && stats->committedBlockID < _lastBlockID)
+            continue;
+
+        // the peer already served invalid blocks of this window
+        if (stats->rejectedBlockID >= _firstBlockID && stats->rejectedBlockID <= _lastBlockID)
+            continue;
+
+        // peers without measurements are tried first
+        uint64_t score = (stats->windowsDownloaded == 0) ? UINT64_MAX : stats->bytesPerSec + 1;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestPeer = i;
+        }
+    }
+
+    return bestPeer;
+}
+
+
+ptr<CatchupWindow> CatchupDownloadScheduler::selectSlowWindow(uint64_t _currentTimeMs) {
+
+    if (averageWindowTimeMs == 0)
+        return nullptr;
+
+    for (auto &&item : inFlightWindows) {
+        auto window = item.second;
+        if (inFlightCounts[item.first] == 1 &&
+            _currentTimeMs - window->startTimeMs > CATCHUP_SLOW_WINDOW_FACTOR * averageWindowTimeMs) {
+            return window;
+        }
+    }
+
+    return nullptr;
+}
+
+
+ptr<CatchupWindow> CatchupDownloadScheduler::assignWindow(block_id _firstBlockID, block_id _lastBlockID,
+                                                          schain_index _peerIndex, uint64_t _currentTimeMs) {
+    auto window = make_shared<CatchupWindow>();
+    window->firstBlockID = _firstBlockID;
+    window->lastBlockID = _lastBlockID;
+    window->peerIndex = _peerIndex;
+    window->startTimeMs = _currentTimeMs;
+
+    getPeerStats(_peerIndex)->busy = true;
+
+    if (inFlightWindows.count(_firstBlockID) == 0)
+        inFlightWindows[_firstBlockID] = window;
+
+    inFlightCounts[_firstBlockID]++;
+
+    return window;
+}
+
+
+void CatchupDownloadScheduler::releaseWindow(ptr<CatchupWindow> _window) {
+    auto count = inFlightCounts.find(_window->firstBlockID);
+
+    CHECK_STATE(count != inFlightCounts.end() && count->second > 0);
+
+    if (--count->second == 0)
+        inFlightCounts.erase(count);
+}
+
+
+void CatchupDownloadScheduler::removeObsoleteWindows(block_id _lastCommittedBlockID) {
+    for (auto item = pendingWindows.begin(); item != pendingWindows.end();) {
+        if (item->second <= _lastCommittedBlockID) {
+            item = pendingWindows.erase(item);
+        } else {
+            ++item;
+        }
+    }
+}
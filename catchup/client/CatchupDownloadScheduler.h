@@ -0,0 +1,156 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupDownloadScheduler.h
+    @author agent
+    @date 2026
+*/
+
+#pragma once
+
+
+class CommittedBlockList;
+
+
+/**
+ * Assignment of a block range [firstBlockID, lastBlockID] to a single peer
+ */
+class CatchupWindow {
+public:
+    block_id firstBlockID = 0;
+    block_id lastBlockID = 0;
+    schain_index peerIndex = 0;
+    uint64_t startTimeMs = 0;
+    bool isDuplicate = false;
+    ptr<CommittedBlockList> blocks = nullptr;
+};
+
+
+/**
+ * Download statistics of a peer, used to prefer fast peers and to back off from failed ones
+ */
+class CatchupPeerStats {
+public:
+    block_id committedBlockID = 0;
+    uint64_t bytesPerSec = 0;
+    uint64_t windowsDownloaded = 0;
+    uint64_t consecutiveFailures = 0;
+    uint64_t backoffUntilMs = 0;
+    // first block of a window from this peer that did not verify
+    block_id rejectedBlockID = 0;
+    bool busy = false;
+};
+
+
+/**
+ * Splits the range of missing blocks into windows, assigns windows to peers
+ * and hands downloaded windows back strictly in block order
+ */
+class CatchupDownloadScheduler {
+
+    recursive_mutex m;
+
+    condition_variable_any windowCond;
+
+    const schain_index myIndex;
+
+    const uint64_t nodeCount;
+
+    const uint64_t windowSize;
+
+    const uint64_t waitAfterNetworkErrorMs;
+
+    // peers report committed block ids without proof, so windows are only scheduled this far ahead
+    const uint64_t maxScheduleAheadBlocks;
+
+    // highest block id that a peer reported as committed
+    block_id targetBlockID = 0;
+
+    // last block id known to be committed by this node
+    block_id committedBlockID = 0;
+
+    // last block id that is covered by a created window
+    block_id scheduledBlockID = 0;
+
+    // last block id that has been handed out for commit
+    block_id poppedBlockID = 0;
+
+    // first block id -> last block id of windows waiting for a peer
+    map<block_id, block_id> pendingWindows;
+
+    // first block id -> original assignment of windows that are being downloaded
+    map<block_id, ptr<CatchupWindow>> inFlightWindows;
+
+    // first block id -> number of parallel downloads of the window
+    map<block_id, uint64_t> inFlightCounts;
+
+    map<block_id, ptr<CatchupWindow>> downloadedWindows;
+
+    map<schain_index, ptr<CatchupPeerStats>> peerStats;
+
+    uint64_t averageWindowTimeMs = 0;
+
+    bool exitRequested = false;
+
+    ptr<CatchupPeerStats> getPeerStats(schain_index _peerIndex);
+
+    void scheduleWindows();
+
+    void backOff(ptr<CatchupPeerStats> _stats);
+
+    schain_index selectPeer(block_id _firstBlockID, block_id _lastBlockID, uint64_t _currentTimeMs);
+
+    ptr<CatchupWindow> selectSlowWindow(uint64_t _currentTimeMs);
+
+    ptr<CatchupWindow> assignWindow(block_id _firstBlockID, block_id _lastBlockID, schain_index _peerIndex,
+                                    uint64_t _currentTimeMs);
+
+    void releaseWindow(ptr<CatchupWindow> _window);
+
+    void removeObsoleteWindows(block_id _lastCommittedBlockID);
+
+public:
+
+    CatchupDownloadScheduler(schain_index _myIndex, uint64_t _nodeCount, uint64_t _windowSize,
+                             uint64_t _downloadThreads, uint64_t _waitAfterNetworkErrorMs);
+
+    void peerCommittedBlockIDArrived(schain_index _peerIndex, block_id _peerCommittedBlockID,
+                                     block_id _downloadedBlockID);
+
+    ptr<CatchupWindow> waitForWindow(uint64_t _timeoutMs);
+
+    void windowDownloaded(ptr<CatchupWindow> _window, ptr<CommittedBlockList> _blocks, uint64_t _bytes);
+
+    void windowFailed(ptr<CatchupWindow> _window);
+
+    /**
+     * @return next downloaded window that continues the chain, its blocks are in CatchupWindow::blocks
+     */
+    ptr<CatchupWindow> popNextWindow(block_id _lastCommittedBlockID);
+
+    /**
+     * Blocks of a popped window did not verify, the rest of the window goes back to the queue for another peer
+     */
+    void windowRejected(ptr<CatchupWindow> _window, block_id _lastCommittedBlockID);
+
+    bool isDownloading();
+
+    uint64_t getWindowSize() const;
+
+    void exit();
+};
@@ -58,6 +58,7 @@
 #include "pendingqueue/PendingTransactionsAgent.h"
 
 #include "chains/Schain.h"
+#include "catchup/client/CatchupClientAgent.h"
 #include "headers/BlockFinalizeResponseHeader.h"
 #include "headers/BlockProposalHeader.h"
 #include "headers/CatchupRequestHeader.h"
@@ -70,6 +71,7 @@
 #include "datastructures/CommittedBlock.h"
 #include "datastructures/CommittedBlockList.h"
 #include "datastructures/BlockProposalFragment.h"
+#include "utils/ReedSolomon.h"
 #include "CatchupServerAgent.h"
 
 
@@ -218,6 +220,12 @@ ptr<vector<uint8_t>> CatchupServerAgent::createResponseHeaderAndBinary(ptr<Serve
 
         if (type->compare(Header::BLOCK_CATCHUP_REQ) == 0) {
 
+            dynamic_pointer_cast<CatchupResponseHeader>(_responseHeader)->setCommittedBlockID(
+                    sChain->getLastCommittedBlockID());
+
+            // a peer asking for blocks after its committed block may be ahead of us
+            sChain->getCatchupClientAgent()->peerCommittedBlockIDArrived(nmi->getSchainIndex(), blockID);
+
             serializedBinary = createBlockCatchupResponse(_jsonRequest,
                                                           dynamic_pointer_cast<CatchupResponseHeader>(_responseHeader),
                                                           blockID);
@@ -240,7 +248,7 @@ ptr<vector<uint8_t>> CatchupServerAgent::createResponseHeaderAndBinary(ptr<Serve
 }
 
 
-ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::json /*_jsonRequest */,
+ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::json _jsonRequest,
                                                                     ptr<CatchupResponseHeader> _responseHeader,
                                                                     block_id _blockID) {
 
@@ -260,6 +268,13 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockCatchupResponse(nlohmann::js
 
         auto committedBlockID = sChain->getLastCommittedBlockID();
 
+        // clients that download in parallel ask for a window of blocks only
+        if (_jsonRequest.find("toBlockID") != _jsonRequest.end()) {
+            block_id toBlockID = Header::getUint64(_jsonRequest, "toBlockID");
+            if (toBlockID > 0 && toBlockID < committedBlockID)
+                committedBlockID = toBlockID;
+        }
+
         if (_blockID >= committedBlockID) {
             LOG(debug, "Catchups: blockID >= committedBlockID");
             _responseHeader->setStatusSubStatus(CONNECTION_DISCONNECT, CONNECTION_OK);
@@ -319,6 +334,23 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockFinalizeResponse(nlohmann::j
         }
 
 
+        auto totalFragments = (uint64_t) getSchain()->getNodeCount() - 1;
+
+        // clients that support erasure coding ask for a coded fragment
+        uint64_t dataFragments = 0;
+
+        if (_jsonRequest.find("dataFragments") != _jsonRequest.end()) {
+            dataFragments = Header::getUint64(_jsonRequest, "dataFragments");
+            if (dataFragments < 1 || dataFragments > totalFragments ||
+                totalFragments > ReedSolomon::MAX_SHARDS) {
+                LOG(debug, "Incorrect data fragments count:" + to_string(dataFragments));
+                _responseHeader->setStatusSubStatus(CONNECTION_DISCONNECT, CONNECTION_ERROR_INVALID_FRAGMENT_INDEX);
+                _responseHeader->setComplete();
+                return nullptr;
+            }
+        }
+
+
         schain_index proposerIndex = Header::getUint64(_jsonRequest, "proposerIndex");
 
 
@@ -347,9 +379,13 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockFinalizeResponse(nlohmann::j
             return nullptr;
         }
 
-        auto fragment = proposal->getFragment(
-                (uint64_t) getSchain()->getNodeCount() - 1,
-                fragmentIndex);
+        ptr<BlockProposalFragment> fragment;
+
+        if (dataFragments > 0 && dataFragments < totalFragments) {
+            fragment = proposal->getErasureCodedFragment(totalFragments, dataFragments, fragmentIndex);
+        } else {
+            fragment = proposal->getFragment(totalFragments, fragmentIndex);
+        }
 
         CHECK_STATE(fragment != nullptr);
 
@@ -360,6 +396,9 @@ ptr<vector<uint8_t>> CatchupServerAgent::createBlockFinalizeResponse(nlohmann::j
         _responseHeader->setFragmentParams(serializedFragment->size(),
                                            proposal->serialize()->size(), proposal->getHash()->toHex());
 
+        if (dataFragments > 0 && dataFragments < totalFragments)
+            _responseHeader->setDataFragments(dataFragments);
+
         return serializedFragment;
     } catch (ExitRequestedException &e) { throw; } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
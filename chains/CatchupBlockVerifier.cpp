@@ -0,0 +1,206 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupBlockVerifier.cpp
+    @author agent
+    @date 2026
+*/
+
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+#include "exceptions/ExitRequestedException.h"
+
+#include "thirdparty/json.hpp"
+#include "crypto/SHAHash.h"
+#include "crypto/CryptoManager.h"
+#include "crypto/ThresholdSignature.h"
+#include "datastructures/CommittedBlock.h"
+#include "node/Node.h"
+#include "messages/NetworkMessage.h"
+#include "protocols/blockconsensus/BlockSignBroadcastMessage.h"
+#include "Schain.h"
+
+#include "CatchupBlockVerifier.h"
+
+
+CatchupBlockVerifier::CatchupBlockVerifier(Schain *_sChain) : sChain(_sChain) {
+    CHECK_ARGUMENT(_sChain != nullptr);
+}
+
+
+ptr<vector<ptr<CatchupVerificationTask>>>
+CatchupBlockVerifier::submit(ptr<vector<ptr<CommittedBlock>>> _blocks) {
+    CHECK_ARGUMENT(_blocks != nullptr);
+
+    auto tasks = make_shared<vector<ptr<CatchupVerificationTask>>>();
+
+    lock_guard<mutex> lock(m);
+
+    for (auto &&block : *_blocks) {
+        auto task = make_shared<CatchupVerificationTask>();
+        task->block = block;
+        tasks->push_back(task);
+        taskQueue.push_back(task);
+    }
+
+    queueCond.notify_all();
+
+    return tasks;
+}
+
+
+bool CatchupBlockVerifier::waitForResult(ptr<CatchupVerificationTask> _task) {
+    CHECK_ARGUMENT(_task != nullptr);
+
+    {
+        unique_lock<mutex> lock(m);
+
+        if (_task->started) {
+            while (!_task->done && !exitRequested) {
+                doneCond.wait(lock);
+            }
+
+            if (!_task->done) {
+                BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
+            }
+
+            return _task->verified;
+        }
+
+        // no worker picked the block up yet, do not wait for one
+        _task->started = true;
+    }
+
+    runTask(_task);
+
+    return _task->verified;
+}
+
+
+void CatchupBlockVerifier::cancel(ptr<vector<ptr<CatchupVerificationTask>>> _tasks) {
+    CHECK_ARGUMENT(_tasks != nullptr);
+
+    lock_guard<mutex> lock(m);
+
+    for (auto &&task : *_tasks) {
+        task->cancelled = true;
+    }
+
+    while (!taskQueue.empty() && taskQueue.front()->cancelled) {
+        taskQueue.pop_front();
+    }
+}
+
+
+void CatchupBlockVerifier::exit() {
+    lock_guard<mutex> lock(m);
+    exitRequested = true;
+    queueCond.notify_all();
+    doneCond.notify_all();
+}
+
+
+void CatchupBlockVerifier::runTask(ptr<CatchupVerificationTask> _task) {
+
+    auto result = verify(_task->block);
+
+    lock_guard<mutex> lock(m);
+    _task->verified = result;
+    _task->done = true;
+    doneCond.notify_all();
+}
+
+
+bool CatchupBlockVerifier::verify(ptr<CommittedBlock> _block) {
+
+    CHECK_ARGUMENT(_block != nullptr);
+
+    try {
+        auto cryptoManager = sChain->getCryptoManager();
+
+        // empty blocks do not have a proposer signature
+        if (_block->getProposerIndex() != 0 &&
+            !cryptoManager->verifyProposalECDSA(_block, _block->getHash()->toHex(), _block->getSignature())) {
+            LOG(err, "Catchup block ECDSA sig did not verify: BID:" + to_string(_block->getBlockID()));
+            return false;
+        }
+
+        auto hash = BlockSignBroadcastMessage::calculateBlockSigHash(_block->getProposerIndex(),
+                                                                     _block->getBlockID(),
+                                                                     _block->getSchainID());
+
+        cryptoManager->verifyThresholdSig(hash, _block->getThresholdSig(), _block->getBlockID());
+
+        return true;
+
+    } catch (ExitRequestedException &) {
+        throw;
+    } catch (exception &e) {
+        LOG(err, "Catchup block threshold sig did not verify: BID:" + to_string(_block->getBlockID()));
+        Exception::logNested(e);
+        return false;
+    }
+}
+
+
+void CatchupBlockVerifier::workerThreadVerifyLoop(CatchupBlockVerifier *_verifier) {
+
+    CHECK_ARGUMENT(_verifier != nullptr);
+
+    auto sChain = _verifier->sChain;
+
+    setThreadName("catchupVerify", sChain->getNode()->getConsensusEngine());
+
+    sChain->waitOnGlobalStartBarrier();
+
+    logThreadLocal_ = sChain->getNode()->getLog();
+
+    try {
+        while (!sChain->getNode()->isExitRequested()) {
+
+            ptr<CatchupVerificationTask> task;
+
+            {
+                unique_lock<mutex> lock(_verifier->m);
+
+                while (_verifier->taskQueue.empty() && !_verifier->exitRequested) {
+                    _verifier->queueCond.wait(lock);
+                }
+
+                if (_verifier->exitRequested)
+                    return;
+
+                task = _verifier->taskQueue.front();
+                _verifier->taskQueue.pop_front();
+
+                if (task->started || task->cancelled)
+                    continue;
+
+                task->started = true;
+            }
+
+            _verifier->runTask(task);
+        }
+    } catch (ExitRequestedException &) {
+        return;
+    } catch (FatalError *e) {
+        sChain->getNode()->exitOnFatalError(e->getMessage());
+    }
+}
@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupBlockVerifier.h
+    @author agent
+    @date 2026
+*/
+
+
+#pragma once
+
+
+class Schain;
+class CommittedBlock;
+
+
+/**
+ * Verification of a single catchup block, shared between the committing thread and the verifier pool
+ */
+class CatchupVerificationTask {
+public:
+    ptr<CommittedBlock> block;
+    bool started = false;
+    bool done = false;
+    bool verified = false;
+    bool cancelled = false;
+};
+
+
+/**
+ * Verifies signatures of blocks that arrived through catchup on a worker pool, so that
+ * verification of upcoming blocks overlaps with the commit of earlier ones.
+ * Blocks are still committed strictly in order by the caller.
+ */
+class CatchupBlockVerifier {
+
+    Schain *sChain;
+
+    mutex m;
+
+    condition_variable queueCond;
+
+    condition_variable doneCond;
+
+    deque<ptr<CatchupVerificationTask>> taskQueue;
+
+    bool exitRequested = false;
+
+    bool verify(ptr<CommittedBlock> _block);
+
+    void runTask(ptr<CatchupVerificationTask> _task);
+
+public:
+
+    CatchupBlockVerifier(Schain *_sChain);
+
+    ptr<vector<ptr<CatchupVerificationTask>>> submit(ptr<vector<ptr<CommittedBlock>>> _blocks);
+
+    bool waitForResult(ptr<CatchupVerificationTask> _task);
+
+    void cancel(ptr<vector<ptr<CatchupVerificationTask>>> _tasks);
+
+    void exit();
+
+    static void workerThreadVerifyLoop(CatchupBlockVerifier *_verifier);
+};
@@ -0,0 +1,41 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file CatchupBlockVerifierThreadPool.cpp
+    @author agent
+    @date 2026
+*/
+
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "threads/WorkerThreadPool.h"
+#include "CatchupBlockVerifier.h"
+#include "CatchupBlockVerifierThreadPool.h"
+
+
+CatchupBlockVerifierThreadPool::CatchupBlockVerifierThreadPool(CatchupBlockVerifier *_verifier, Agent *_agent)
+        : WorkerThreadPool(NUM_CATCHUP_VERIFY_THREADS, _agent, false), verifier(_verifier) {
+    CHECK_ARGUMENT(_verifier != nullptr);
+}
+
+void CatchupBlockVerifierThreadPool::createThread(uint64_t /*_threadNumber*/) {
+    threadpool.push_back(make_shared<thread>(CatchupBlockVerifier::workerThreadVerifyLoop, verifier));
+}
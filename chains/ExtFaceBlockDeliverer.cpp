@@ -0,0 +1,187 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ExtFaceBlockDeliverer.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+#include "exceptions/ExitRequestedException.h"
+
+#include "datastructures/CommittedBlock.h"
+#include "datastructures/TransactionList.h"
+#include "node/Node.h"
+#include "utils/Time.h"
+#include "Schain.h"
+
+#include "ExtFaceBlockDeliverer.h"
+
+
+ExtFaceBlockDeliverer::ExtFaceBlockDeliverer(Schain *_sChain, uint64_t _maxQueueSize)
+        : sChain(_sChain), maxQueueSize(_maxQueueSize) {
+    CHECK_ARGUMENT(_sChain != nullptr);
+    CHECK_ARGUMENT(_maxQueueSize > 0);
+}
+
+
+void ExtFaceBlockDeliverer::enqueue(ptr<CommittedBlock> _block) {
+    CHECK_ARGUMENT(_block != nullptr);
+
+    auto task = make_shared<ExtFaceDeliveryTask>();
+    task->block = _block;
+
+    unique_lock<mutex> lock(m);
+
+    waitForSpace(lock);
+
+    task->enqueueTimeMs = Time::getCurrentTimeMs();
+    taskQueue.push_back(task);
+
+    queueCond.notify_all();
+}
+
+
+ptr<TransactionList> ExtFaceBlockDeliverer::getUndeliveredTransactions() {
+    auto transactions = make_shared<vector<ptr<Transaction>>>();
+
+    lock_guard<mutex> lock(m);
+
+    for (auto &&task : taskQueue) {
+        auto items = task->block->getTransactionList()->getItems();
+        transactions->insert(transactions->end(), items->begin(), items->end());
+    }
+
+    return make_shared<TransactionList>(transactions);
+}
+
+
+void ExtFaceBlockDeliverer::waitUntilDelivered(block_id _blockID) {
+    unique_lock<mutex> lock(m);
+
+    // the queue is in block order, the front block is the one being delivered
+    while (!taskQueue.empty() && taskQueue.front()->block->getBlockID() <= _blockID && !exitRequested) {
+        spaceCond.wait(lock);
+    }
+
+    if (exitRequested) {
+        BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
+    }
+}
+
+
+void ExtFaceBlockDeliverer::waitForSpace(unique_lock<mutex> &_lock) {
+    while (taskQueue.size() >= maxQueueSize && !exitRequested) {
+        spaceCond.wait(_lock);
+    }
+
+    if (exitRequested) {
+        BOOST_THROW_EXCEPTION(ExitRequestedException(__CLASS_NAME__));
+    }
+}
+
+
+uint64_t ExtFaceBlockDeliverer::getQueueDepth() {
+    lock_guard<mutex> lock(m);
+    return taskQueue.size();
+}
+
+
+uint64_t ExtFaceBlockDeliverer::getMaxQueueSize() const {
+    return maxQueueSize;
+}
+
+
+uint64_t ExtFaceBlockDeliverer::getLastDeliveryLatencyMs() const {
+    return lastDeliveryLatencyMs;
+}
+
+
+uint64_t ExtFaceBlockDeliverer::getMaxDeliveryLatencyMs() const {
+    return maxDeliveryLatencyMs;
+}
+
+
+void ExtFaceBlockDeliverer::exit() {
+    lock_guard<mutex> lock(m);
+    exitRequested = true;
+    queueCond.notify_all();
+    spaceCond.notify_all();
+}
+
+
+void ExtFaceBlockDeliverer::deliveryThreadLoop(ExtFaceBlockDeliverer *_deliverer) {
+
+    CHECK_ARGUMENT(_deliverer != nullptr);
+
+    auto sChain = _deliverer->sChain;
+
+    setThreadName("extFaceDeliver", sChain->getNode()->getConsensusEngine());
+
+    sChain->waitOnGlobalStartBarrier();
+
+    logThreadLocal_ = sChain->getNode()->getLog();
+
+    try {
+        while (!sChain->getNode()->isExitRequested()) {
+
+            ptr<ExtFaceDeliveryTask> task;
+
+            {
+                unique_lock<mutex> lock(_deliverer->m);
+
+                while (_deliverer->taskQueue.empty() && !_deliverer->exitRequested) {
+                    _deliverer->queueCond.wait(lock);
+                }
+
+                // blocks left in the queue are pushed again by bootstrap on restart
+                if (_deliverer->exitRequested)
+                    return;
+
+                task = _deliverer->taskQueue.front();
+            }
+
+            sChain->deliverBlockToExtFace(task->block);
+
+            auto latency = Time::getCurrentTimeMs() - task->enqueueTimeMs;
+
+            _deliverer->lastDeliveryLatencyMs = latency;
+
+            if (latency > _deliverer->maxDeliveryLatencyMs)
+                _deliverer->maxDeliveryLatencyMs = latency;
+
+            LOG(debug, "EXT_FACE_DELIVERED: BID:" + to_string(task->block->getBlockID()) +
+                       ":LATENCY_MS:" + to_string(latency));
+
+            {
+                lock_guard<mutex> lock(_deliverer->m);
+                _deliverer->taskQueue.pop_front();
+                _deliverer->spaceCond.notify_all();
+            }
+        }
+    } catch (ExitRequestedException &) {
+        return;
+    } catch (exception &e) {
+        Exception::logNested(e);
+        sChain->getNode()->exitOnFatalError(e.what());
+    } catch (FatalError *e) {
+        sChain->getNode()->exitOnFatalError(e->getMessage());
+    }
+}
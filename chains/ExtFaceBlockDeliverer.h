@@ -0,0 +1,103 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ExtFaceBlockDeliverer.h
+    @author agent
+    @date 2026
+*/
+
+#pragma once
+
+
+class Schain;
+class CommittedBlock;
+class TransactionList;
+
+
+/**
+ * Committed block waiting to be passed to the external face
+ */
+class ExtFaceDeliveryTask {
+public:
+    ptr<CommittedBlock> block;
+    uint64_t enqueueTimeMs = 0;
+};
+
+
+/**
+ * Bounded in-order queue of committed blocks, consumed by a single thread that calls
+ * createBlock() on the external face, so that block execution does not stall consensus.
+ * A block stays in the queue until the external face returns.
+ */
+class ExtFaceBlockDeliverer {
+
+    Schain *sChain;
+
+    const uint64_t maxQueueSize;
+
+    mutex m;
+
+    condition_variable queueCond;
+
+    condition_variable spaceCond;
+
+    deque<ptr<ExtFaceDeliveryTask>> taskQueue;
+
+    bool exitRequested = false;
+
+    atomic<uint64_t> lastDeliveryLatencyMs = 0;
+
+    atomic<uint64_t> maxDeliveryLatencyMs = 0;
+
+    void waitForSpace(unique_lock<mutex> &_lock);
+
+public:
+
+    ExtFaceBlockDeliverer(Schain *_sChain, uint64_t _maxQueueSize);
+
+    /**
+     * Blocks while the queue is full
+     */
+    void enqueue(ptr<CommittedBlock> _block);
+
+    /**
+     * Transactions of the queued blocks, the external face still returns them as pending
+     */
+    ptr<TransactionList> getUndeliveredTransactions();
+
+    /**
+     * Returns once createBlock() returned for all blocks up to _blockID, so that the state root
+     * of the external face includes them
+     */
+    void waitUntilDelivered(block_id _blockID);
+
+    uint64_t getQueueDepth();
+
+    uint64_t getMaxQueueSize() const;
+
+    /**
+     * @return time between commit and return from createBlock() of the last delivered block
+     */
+    uint64_t getLastDeliveryLatencyMs() const;
+
+    uint64_t getMaxDeliveryLatencyMs() const;
+
+    void exit();
+
+    static void deliveryThreadLoop(ExtFaceBlockDeliverer *_deliverer);
+};
@@ -0,0 +1,41 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ExtFaceBlockDelivererThreadPool.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "threads/WorkerThreadPool.h"
+#include "ExtFaceBlockDeliverer.h"
+#include "ExtFaceBlockDelivererThreadPool.h"
+
+
+// blocks have to reach the external face in order, so there is a single delivery thread
+ExtFaceBlockDelivererThreadPool::ExtFaceBlockDelivererThreadPool(ExtFaceBlockDeliverer *_deliverer, Agent *_agent)
+        : WorkerThreadPool(num_threads(1), _agent, false), deliverer(_deliverer) {
+    CHECK_ARGUMENT(_deliverer != nullptr);
+}
+
+void ExtFaceBlockDelivererThreadPool::createThread(uint64_t /*_threadNumber*/) {
+    threadpool.push_back(make_shared<thread>(ExtFaceBlockDeliverer::deliveryThreadLoop, deliverer));
+}
@@ -41,8 +41,10 @@
 #include "node/Node.h"
 #include "pendingqueue/PendingTransactionsAgent.h"
 #include "utils/Time.h"
+#include "threads/MPSCQueue.h"
 
 #include "blockfinalize/client/BlockFinalizeDownloader.h"
+#include "blockfinalize/client/BlockFinalizeDownloadAgent.h"
 #include "blockproposal/server/BlockProposalServerAgent.h"
 #include "catchup/client/CatchupClientAgent.h"
 #include "catchup/server/CatchupServerAgent.h"
@@ -85,6 +87,11 @@
 
 #include "Schain.h"
 #include "SchainMessageThreadPool.h"
+#include "SchainMessageShardThreadPool.h"
+#include "CatchupBlockVerifier.h"
+#include "CatchupBlockVerifierThreadPool.h"
+#include "ExtFaceBlockDeliverer.h"
+#include "ExtFaceBlockDelivererThreadPool.h"
 #include "SchainTest.h"
 #include "TestConfig.h"
 #include "crypto/CryptoManager.h"
@@ -92,6 +99,7 @@
 #include "crypto/bls_include.h"
 #include "db/BlockDB.h"
 #include "db/CacheLevelDB.h"
+#include "db/ConsensusStateDB.h"
 #include "db/ProposalHashDB.h"
 #include "libBLS/bls/BLSPrivateKeyShare.h"
 #include "monitoring/LivelinessMonitor.h"
@@ -106,11 +114,32 @@ void Schain::postMessage( ptr< MessageEnvelope > m ) {
 
     ASSERT( m );
     ASSERT( ( uint64_t ) m->getMessage()->getBlockId() != 0 );
-    {
-        lock_guard< mutex > lock( messageMutex );
-        messageQueue.push( m );
-        messageCond.notify_all();
+
+    messageQueue->push( m );
+}
+
+
+void Schain::dispatchMessage( ptr< MessageEnvelope > _m ) {
+    auto type = _m->getMessage()->getMessageType();
+
+    if ( shardQueues.empty() || type == MSG_BLOCK_SIGN_BROADCAST ) {
+        getBlockConsensusInstance()->routeAndProcessMessage( _m );
+        return;
+    }
+
+    if ( type == MSG_CONSENSUS_PROPOSAL ) {
+        // every shard starts the binary consensus instances of its own proposers
+        pendingShardMessages += shardQueues.size();
+        for ( auto&& shardQueue : shardQueues )
+            shardQueue->push( _m );
+        return;
     }
+
+    auto proposerIndex = ( uint64_t ) _m->getMessage()->getBlockProposerIndex();
+    CHECK_STATE( proposerIndex > 0 );
+
+    pendingShardMessages++;
+    shardQueues.at( ( proposerIndex - 1 ) % shardQueues.size() )->push( _m );
 }
 
 
@@ -127,47 +156,75 @@ void Schain::messageThreadProcessingLoop( Schain* s ) {
 
         logThreadLocal_ = s->getNode()->getLog();
 
-        queue< ptr< MessageEnvelope > > newQueue;
+        vector< ptr< MessageEnvelope > > batch;
 
         while ( !s->getNode()->isExitRequested() ) {
-            {
-                unique_lock< mutex > mlock( s->messageMutex );
-                while ( s->messageQueue.empty() ) {
-                    s->messageCond.wait( mlock );
+            batch.clear();
+
+            if ( s->messageQueue->waitAndDrain( batch, SCHAIN_MESSAGE_WAIT_MS ) == 0 )
+                continue;
+
+            for ( auto&& m : batch ) {
+                ASSERT( ( uint64_t ) m->getMessage()->getBlockId() != 0 );
+
+                try {
+                    s->dispatchMessage( m );
+                } catch ( exception& e ) {
                     if ( s->getNode()->isExitRequested() ) {
                         s->getNode()->getSockets()->consensusZMQSockets->closeSend();
                         return;
                     }
+                    Exception::logNested( e );
                 }
+            }
 
-                newQueue = s->messageQueue;
+            s->getNode()->getConsensusStateDB()->flushBatch();
+        }
 
-                while ( !s->messageQueue.empty() ) {
-                    s->messageQueue.pop();
-                }
-            }
 
+        s->getNode()->getSockets()->consensusZMQSockets->closeSend();
+    } catch ( FatalError* e ) {
+        s->getNode()->exitOnFatalError( e->getMessage() );
+    }
+}
 
-            while ( !newQueue.empty() ) {
-                ptr< MessageEnvelope > m = newQueue.front();
-                ASSERT( ( uint64_t ) m->getMessage()->getBlockId() != 0 );
 
+void Schain::messageShardProcessingLoop( Schain* s, uint64_t _shard ) {
+    ASSERT( s );
+
+    setThreadName( "msgShardLoop", s->getNode()->getConsensusEngine() );
+
+    s->waitOnGlobalStartBarrier();
+
+    try {
+        logThreadLocal_ = s->getNode()->getLog();
+
+        auto shardQueue = s->shardQueues.at( _shard );
+
+        vector< ptr< MessageEnvelope > > batch;
+
+        while ( !s->getNode()->isExitRequested() ) {
+            batch.clear();
+
+            auto n = shardQueue->waitAndDrain( batch, SCHAIN_MESSAGE_WAIT_MS );
+
+            if ( n == 0 )
+                continue;
+
+            for ( auto&& m : batch ) {
                 try {
-                    s->getBlockConsensusInstance()->routeAndProcessMessage( m );
+                    s->getBlockConsensusInstance()->routeAndProcessMessage( m, _shard );
                 } catch ( exception& e ) {
-                    if ( s->getNode()->isExitRequested() ) {
-                        s->getNode()->getSockets()->consensusZMQSockets->closeSend();
+                    if ( s->getNode()->isExitRequested() )
                         return;
-                    }
                     Exception::logNested( e );
                 }
-
-                newQueue.pop();
             }
-        }
 
+            s->getNode()->getConsensusStateDB()->flushBatch();
 
-        s->getNode()->getSockets()->consensusZMQSockets->closeSend();
+            s->pendingShardMessages -= n;
+        }
     } catch ( FatalError* e ) {
         s->getNode()->exitOnFatalError( e->getMessage() );
     }
@@ -176,6 +233,27 @@ void Schain::messageThreadProcessingLoop( Schain* s ) {
 
 void Schain::startThreads() {
     this->consensusMessageThreadPool->startService();
+    if ( messageShardThreadPool )
+        this->messageShardThreadPool->startService();
+    this->catchupBlockVerifierThreadPool->startService();
+    if ( extFaceBlockDelivererThreadPool )
+        this->extFaceBlockDelivererThreadPool->startService();
+    this->cryptoManager->startService();
+}
+
+
+void Schain::notifyAllConditionVariables() {
+    Agent::notifyAllConditionVariables();
+    if ( messageQueue )
+        messageQueue->close();
+    for ( auto&& shardQueue : shardQueues )
+        shardQueue->close();
+    if ( catchupBlockVerifier )
+        catchupBlockVerifier->exit();
+    if ( extFaceBlockDeliverer )
+        extFaceBlockDeliverer->exit();
+    if ( cryptoManager )
+        cryptoManager->exit();
 }
 
 
@@ -186,8 +264,20 @@ Schain::Schain( weak_ptr< Node > _node, schain_index _schainIndex, const schain_
       extFace( _extFace ),
       schainID( _schainID ),
       consensusMessageThreadPool( new SchainMessageThreadPool( this ) ),
+      catchupBlockVerifier( make_shared< CatchupBlockVerifier >( this ) ),
       node( _node ),
-      schainIndex( _schainIndex ) {
+      schainIndex( _schainIndex ),
+      messageQueue( make_shared< MPSCQueue< ptr< MessageEnvelope > > >() ) {
+    catchupBlockVerifierThreadPool =
+        make_shared< CatchupBlockVerifierThreadPool >( catchupBlockVerifier.get(), this );
+
+    if ( getNode()->getExtFaceQueueSize() > 0 ) {
+        extFaceBlockDeliverer =
+            make_shared< ExtFaceBlockDeliverer >( this, getNode()->getExtFaceQueueSize() );
+        extFaceBlockDelivererThreadPool = make_shared< ExtFaceBlockDelivererThreadPool >(
+            extFaceBlockDeliverer.get(), this );
+    }
+
     // construct monitoring agent early
     monitoringAgent = make_shared< MonitoringAgent >( *this );
     maxExternalBlockProcessingTime =
@@ -219,6 +309,16 @@ Schain::Schain( weak_ptr< Node > _node, schain_index _schainIndex, const schain_
 
         ASSERT( getNodeCount() > 0 );
 
+        auto shardCount =
+            std::min( getNode()->getMessageProcessingShards(), ( uint64_t ) getNodeCount() );
+
+        if ( shardCount > 1 ) {
+            for ( uint64_t i = 0; i < shardCount; i++ ) {
+                shardQueues.push_back( make_shared< MPSCQueue< ptr< MessageEnvelope > > >() );
+            }
+            messageShardThreadPool = make_shared< SchainMessageShardThreadPool >( num_threads( shardCount ), this );
+        }
+
         constructChildAgents();
 
         string x = SchainTest::NONE;
@@ -245,6 +345,9 @@ void Schain::constructChildAgents() {
         blockProposalClient = make_shared< BlockProposalClientAgent >( *this );
         catchupClientAgent = make_shared< CatchupClientAgent >( *this );
 
+        if ( getNodeCount() > 1 )
+            blockFinalizeDownloadAgent = make_shared< BlockFinalizeDownloadAgent >( *this );
+
 
         testMessageGeneratorAgent = make_shared< TestMessageGeneratorAgent >( *this );
         pricingAgent = make_shared< PricingAgent >( *this );
@@ -279,14 +382,28 @@ void Schain::blockCommitsArrivedThroughCatchup( ptr< CommittedBlockList > _block
 
     ASSERT( b->at( 0 )->getBlockID() <= ( uint64_t ) getLastCommittedBlockID() + 1 );
 
-    for ( size_t i = 0; i < b->size(); i++ ) {
-        auto t = b->at( i );
+    auto newBlocks = make_shared< vector< ptr< CommittedBlock > > >();
 
-        if ( ( uint64_t ) t->getBlockID() > getLastCommittedBlockID() ) {
-            processCommittedBlock( t );
-            previosBlockTimeStamp = t->getTimeStamp();
-            previosBlockTimeStampMs = t->getTimeStampMs();
+    for ( auto&& t : *b ) {
+        if ( ( uint64_t ) t->getBlockID() > getLastCommittedBlockID() )
+            newBlocks->push_back( t );
+    }
+
+    // signatures of the following blocks are verified on the pool while earlier blocks commit
+    auto tasks = catchupBlockVerifier->submit( newBlocks );
+
+    for ( size_t i = 0; i < newBlocks->size(); i++ ) {
+        auto t = newBlocks->at( i );
+
+        if ( !catchupBlockVerifier->waitForResult( tasks->at( i ) ) ) {
+            LOG( err, "Rejecting catchup blocks starting from BID:" + to_string( t->getBlockID() ) );
+            catchupBlockVerifier->cancel( tasks );
+            break;
         }
+
+        processCommittedBlock( t );
+        previosBlockTimeStamp = t->getTimeStamp();
+        previosBlockTimeStampMs = t->getTimeStampMs();
     }
 
     if ( committedIDOld < getLastCommittedBlockID() ) {
@@ -328,6 +445,9 @@ void Schain::blockCommitArrived( block_id _committedBlockID, schain_index _propo
 
         auto newCommittedBlock = CommittedBlock::makeObject( committedProposal, _thresholdSig );
 
+        if ( getNode()->isProposalPipelining() )
+            startPipelinedProposal( newCommittedBlock );
+
         processCommittedBlock( newCommittedBlock );
 
         proposeNextBlock( _committedTimeStamp, _committedTimeStampMs );
@@ -356,9 +476,23 @@ void Schain::proposeNextBlock(
 
         ptr< BlockProposal > myProposal;
 
+        auto pipelined = takePipelinedTransactions( _proposedBlockID );
+
         if ( getNode()->getProposalHashDB()->haveProposal( _proposedBlockID, getSchainIndex() ) ) {
             myProposal = getNode()->getBlockProposalDB()->getBlockProposal(
                 _proposedBlockID, getSchainIndex() );
+        } else if ( pipelined != nullptr ) {
+            // the state root is read once the external face executed the previous block
+            waitForExtFaceDelivery( _proposedBlockID - 1 );
+            myProposal = pendingTransactionsAgent->completeBlockProposal(
+                _proposedBlockID, _previousBlockTimeStamp, _previousBlockTimeStampMs, pipelined );
+        } else if ( extFaceBlockDeliverer ) {
+            // transactions of queued blocks are still pending in the external face
+            auto transactions = pendingTransactionsAgent->collectTransactionsForProposal(
+                extFaceBlockDeliverer->getUndeliveredTransactions() );
+            waitForExtFaceDelivery( _proposedBlockID - 1 );
+            myProposal = pendingTransactionsAgent->completeBlockProposal(
+                _proposedBlockID, _previousBlockTimeStamp, _previousBlockTimeStampMs, transactions );
         } else {
             myProposal = pendingTransactionsAgent->buildBlockProposal(
                 _proposedBlockID, _previousBlockTimeStamp, _previousBlockTimeStampMs );
@@ -387,6 +521,61 @@ void Schain::proposeNextBlock(
     }
 }
 
+void Schain::startPipelinedProposal( ptr< CommittedBlock > _block ) {
+    CHECK_ARGUMENT( _block );
+
+    block_id nextBlockID = _block->getBlockID() + 1;
+
+    if ( getNode()->getProposalHashDB()->haveProposal( nextBlockID, getSchainIndex() ) )
+        return;
+
+    // drop transactions left over from a failed commit
+    takePipelinedTransactions( nextBlockID );
+
+    pipelinedBlockID = nextBlockID;
+
+    // the minimal block interval and pulling from the external face now overlap with saving
+    // block N and pushing it to the external face
+    // block N and the queued blocks before it are not executed yet, their transactions are still pending
+    auto excluded = _block->getTransactionList();
+
+    if ( extFaceBlockDeliverer ) {
+        auto transactions = extFaceBlockDeliverer->getUndeliveredTransactions()->getItems();
+        auto items = excluded->getItems();
+        transactions->insert( transactions->end(), items->begin(), items->end() );
+        excluded = make_shared< TransactionList >( transactions );
+    }
+
+    pipelinedTransactions = std::async( std::launch::async, [this, excluded]() {
+        logThreadLocal_ = getNode()->getLog();
+        return pendingTransactionsAgent->collectTransactionsForProposal( excluded );
+    } );
+}
+
+
+ptr< vector< ptr< Transaction > > > Schain::takePipelinedTransactions( block_id _blockID ) {
+    if ( !pipelinedTransactions.valid() )
+        return nullptr;
+
+    auto blockID = pipelinedBlockID;
+    pipelinedBlockID = 0;
+
+    if ( blockID == _blockID )
+        return pipelinedTransactions.get();
+
+    // the chain moved on through catchup, the transactions are stale
+    try {
+        pipelinedTransactions.get();
+    } catch ( ExitRequestedException& ) {
+        throw;
+    } catch ( exception& e ) {
+        Exception::logNested( e );
+    }
+
+    return nullptr;
+}
+
+
 void Schain::processCommittedBlock( ptr< CommittedBlock > _block ) {
     CHECK_STATE( _block->getSignature() != nullptr );
     MONITOR2( __CLASS_NAME__, __FUNCTION__, getMaxExternalBlockProcessingTime() )
@@ -407,6 +596,8 @@ void Schain::processCommittedBlock( ptr< CommittedBlock > _block ) {
                        ":ROOT:" + _block->getStateRoot().convert_to< string >() + ":HASH:" + h +
                        ":BLOCK_TXS:" + to_string( _block->getTransactionCount() ) +
                        ":DMSG:" + to_string( getMessagesCount() ) +
+                       ":EXTQ:" + to_string( getExtFaceQueueDepth() ) +
+                       ":EXTL:" + to_string( getExtFaceDeliveryLatencyMs() ) +
                        ":MPRPS:" + to_string( MyBlockProposal::getTotalObjects() ) +
                        ":RPRPS:" + to_string( ReceivedBlockProposal::getTotalObjects() ) +
                        ":TXS:" + to_string( Transaction::getTotalObjects() ) +
@@ -425,6 +616,12 @@ void Schain::processCommittedBlock( ptr< CommittedBlock > _block ) {
 
         pushBlockToExtFace( _block );
 
+        {
+            lock_guard< mutex > hashLock( lastCommittedBlockHashMutex );
+            lastCommittedBlockHash = _block->getHash();
+            lastCommittedBlockHashID = _block->getBlockID();
+        }
+
         lastCommittedBlockID++;
         lastCommitTime = Time::getCurrentTimeMs();
 
@@ -454,12 +651,33 @@ void Schain::saveBlock( ptr< CommittedBlock >& _block ) {
 void Schain::pushBlockToExtFace( ptr< CommittedBlock >& _block ) {
     CHECK_ARGUMENT( _block );
 
+    if ( extFaceBlockDeliverer ) {
+        extFaceBlockDeliverer->enqueue( _block );
+    } else {
+        deliverBlockToExtFace( _block );
+    }
+}
+
+
+void Schain::waitForExtFaceDelivery( block_id _blockID ) {
+    if ( extFaceBlockDeliverer == nullptr )
+        return;
+
+    MONITOR2( __CLASS_NAME__, __FUNCTION__, getMaxExternalBlockProcessingTime() )
+
+    extFaceBlockDeliverer->waitUntilDelivered( _blockID );
+}
+
+
+void Schain::deliverBlockToExtFace( ptr< CommittedBlock > _block ) {
+    CHECK_ARGUMENT( _block );
+
     MONITOR2( __CLASS_NAME__, __FUNCTION__, getMaxExternalBlockProcessingTime() )
 
     checkForExit();
 
     try {
-        auto tv = _block->getTransactionList()->createTransactionVector();
+        auto tv = _block->getTransactionList()->createTransactionViews();
 
         // auto next_price = // VERIFY PRICING
 
@@ -470,10 +688,12 @@ void Schain::pushBlockToExtFace( ptr< CommittedBlock >& _block ) {
 
 
         if ( extFace ) {
-            extFace->createBlock( *tv, _block->getTimeStamp(), _block->getTimeStampMs(),
+            extFace->createBlockFromViews( *tv, _block->getTimeStamp(), _block->getTimeStampMs(),
                 ( __uint64_t ) _block->getBlockID(), cur_price, _block->getStateRoot() );
             // exit immediately if exit has been requested
             getSchain()->getNode()->exitCheck();
+        } else {
+            testMessageGeneratorAgent->blockDelivered( _block );
         }
 
     } catch ( ExitRequestedException& e ) {
@@ -573,18 +793,25 @@ void Schain::bootstrap( block_id _lastCommittedBlockID, uint64_t _lastCommittedB
     // Step 1: solve block id  mismatch problems
 
 
-    if ( _lastCommittedBlockIDInConsensus == _lastCommittedBlockID + 1 ) {
-        // consensus has one more block than skaled
+    // blocks that were committed but still queued for the external face when the node stopped
+    auto maxLag = std::max( getNode()->getExtFaceQueueSize(), ( uint64_t ) 1 );
+
+    if ( _lastCommittedBlockIDInConsensus > _lastCommittedBlockID &&
+         _lastCommittedBlockIDInConsensus <= _lastCommittedBlockID + maxLag ) {
+        // consensus has more blocks than skaled
         // This happens when starting from a snapshot
         // Since the snapshot is taken just before a block is processed
         try {
-            auto block = getNode()->getBlockDB()->getBlock(
-                _lastCommittedBlockIDInConsensus, getCryptoManager() );
-            if ( block != nullptr ) {
-                // we have one more block in consensus, so we push it out
-
-                pushBlockToExtFace( block );
+            while ( _lastCommittedBlockID < _lastCommittedBlockIDInConsensus ) {
+                auto block = getNode()->getBlockDB()->getBlock(
+                    _lastCommittedBlockID + 1, getCryptoManager() );
+                if ( block == nullptr )
+                    break;
+                // we have more blocks in consensus, so we push them out
+
+                deliverBlockToExtFace( block );
                 _lastCommittedBlockID = _lastCommittedBlockID + 1;
+                _lastCommittedBlockTimeStamp = block->getTimeStamp();
             }
         } catch ( ... ) {
             // Cant read the block form db, may be it is corrupt in the  snapshot
@@ -598,9 +825,10 @@ void Schain::bootstrap( block_id _lastCommittedBlockID, uint64_t _lastCommittedB
                 "_lastCommittedBlockIDInConsensus < _lastCommittedBlockID", __CLASS_NAME__ ) );
         }
 
-        if ( _lastCommittedBlockIDInConsensus > _lastCommittedBlockID + 1 ) {
+        if ( _lastCommittedBlockIDInConsensus > _lastCommittedBlockID + maxLag ) {
             BOOST_THROW_EXCEPTION( InvalidStateException(
-                "_lastCommittedBlockIDInConsensus > _lastCommittedBlockID + 1", __CLASS_NAME__ ) );
+                "_lastCommittedBlockIDInConsensus > _lastCommittedBlockID + " + to_string( maxLag ),
+                __CLASS_NAME__ ) );
         }
     }
 
@@ -626,7 +854,7 @@ void Schain::bootstrap( block_id _lastCommittedBlockID, uint64_t _lastCommittedB
 
         LOG( info, "Jump starting the system with block:" + to_string( _lastCommittedBlockID ) );
         if ( getLastCommittedBlockID() == 0 )
-            this->pricingAgent-> calculatePrice( ConsensusExtFace::transactions_vector(),
+            this->pricingAgent-> calculatePrice( ConsensusExtFace::transaction_views(),
                     0, 0, 0 );
 
         proposeNextBlock( lastCommittedBlockTimeStamp, lastCommittedBlockTimeStampMs );
@@ -634,7 +862,22 @@ void Schain::bootstrap( block_id _lastCommittedBlockID, uint64_t _lastCommittedB
             getNode()->getProposalVectorDB()->getVector( _lastCommittedBlockID + 1 );
         if ( proposalVector ) {
             auto messages = getNode()->getOutgoingMsgDB()->getMessages( _lastCommittedBlockID + 1 );
+
+#ifdef CONSENSUS_STATE_PERSISTENCE
+            // restarted peers resume from their snapshots and only accept votes up to one round
+            // ahead, so earlier rounds of an instance do not need to be rebroadcast
+            map< schain_index, bin_consensus_round > latestRounds;
+            for ( auto&& m : *messages ) {
+                if ( isBinConsensusVote( m ) && m->getRound() > latestRounds[m->getBlockProposerIndex()] )
+                    latestRounds[m->getBlockProposerIndex()] = m->getRound();
+            }
+#endif
+
             for ( auto&& m : *messages ) {
+#ifdef CONSENSUS_STATE_PERSISTENCE
+                if ( isBinConsensusVote( m ) && m->getRound() < latestRounds[m->getBlockProposerIndex()] )
+                    continue;
+#endif
                 getNode()->getNetwork()->broadcastMessage( m );
             }
         }
@@ -646,6 +889,12 @@ void Schain::bootstrap( block_id _lastCommittedBlockID, uint64_t _lastCommittedB
 }
 
 
+bool Schain::isBinConsensusVote( ptr< NetworkMessage > _m ) {
+    CHECK_ARGUMENT( _m );
+    return _m->getMessageType() == MSG_BVB_BROADCAST || _m->getMessageType() == MSG_AUX_BROADCAST;
+}
+
+
 void Schain::healthCheck() {
     std::unordered_set< uint64_t > connections;
     setHealthCheckFile( 1 );
@@ -784,7 +1033,7 @@ void Schain::finalizeDecidedAndSignedBlock(
             // Note that due to the BLS signature proof, 2t hosts out of 3t + 1 total are guaranteed
             // to posess the proposal
 
-            auto agent = make_unique< BlockFinalizeDownloader >( this, _blockId, _proposerIndex );
+            auto agent = make_shared< BlockFinalizeDownloader >( this, _blockId, _proposerIndex );
 
             {
                 const string message = "Finalization download:" + to_string( _blockId ) + ":" +
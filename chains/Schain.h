@@ -43,9 +43,14 @@ class BlockProposalClientAgent;
 class BlockProposalPusherThreadPool;
 
 class BlockFinalizeDownloader;
-class BlockFinalizeDownloaderThreadPool;
+class BlockFinalizeDownloadAgent;
 
 class SchainMessageThreadPool;
+class SchainMessageShardThreadPool;
+class CatchupBlockVerifier;
+class CatchupBlockVerifierThreadPool;
+class ExtFaceBlockDeliverer;
+class ExtFaceBlockDelivererThreadPool;
 
 class TestMessageGeneratorAgent;
 class ConsensusExtFace;
@@ -58,6 +63,7 @@ class CryptoManager;
 class BlockProposalServerAgent;
 
 class MessageEnvelope;
+class NetworkMessage;
 
 class Node;
 class PendingTransactionsAgent;
@@ -72,6 +78,9 @@ class SHAHash;
 class ConsensusBLSSigShare;
 class ThresholdSigShare;
 class BooleanProposalVector;
+class Transaction;
+
+template<typename T> class MPSCQueue;
 
 class Schain : public Agent {
 
@@ -102,10 +111,22 @@ class Schain : public Agent {
 
     ptr<CatchupClientAgent> catchupClientAgent = nullptr;
 
+    ptr<BlockFinalizeDownloadAgent> blockFinalizeDownloadAgent = nullptr;
+
     ptr<PricingAgent> pricingAgent = nullptr;
 
     ptr<SchainMessageThreadPool> consensusMessageThreadPool = nullptr;
 
+    ptr<SchainMessageShardThreadPool> messageShardThreadPool = nullptr;
+
+    ptr<CatchupBlockVerifier> catchupBlockVerifier = nullptr;
+
+    ptr<CatchupBlockVerifierThreadPool> catchupBlockVerifierThreadPool = nullptr;
+
+    ptr<ExtFaceBlockDeliverer> extFaceBlockDeliverer = nullptr;
+
+    ptr<ExtFaceBlockDelivererThreadPool> extFaceBlockDelivererThreadPool = nullptr;
+
 
 
     ptr<IO> io;
@@ -126,11 +147,31 @@ class Schain : public Agent {
     atomic<uint64_t>lastCommittedBlockTimeStamp = 0;
     atomic<uint64_t>lastCommittedBlockTimeStampMs = 0;
 
+    mutex lastCommittedBlockHashMutex;
+
+    // hash of the block lastCommittedBlockHashID, kept in case the block can not be read from the DB
+    ptr<SHAHash> lastCommittedBlockHash = nullptr;
+    block_id lastCommittedBlockHashID = 0;
+
     uint64_t maxExternalBlockProcessingTime = 0;
 
+    /*** Transactions for the pipelinedBlockID proposal, pulled while the previous block is committed
+ */
+    future<ptr<vector<ptr<Transaction>>>> pipelinedTransactions;
+
+    block_id pipelinedBlockID = 0;
+
     /*** Queue of unprocessed messages for this schain instance
  */
-    queue<ptr<MessageEnvelope>> messageQueue;
+    ptr<MPSCQueue<ptr<MessageEnvelope>>> messageQueue;
+
+    /*** Per shard queues of binary consensus messages, empty if messages are processed on a single thread
+ */
+    vector<ptr<MPSCQueue<ptr<MessageEnvelope>>>> shardQueues;
+
+    /*** Messages handed to shards and not processed yet
+ */
+    atomic<uint64_t> pendingShardMessages = 0;
 
     queue<uint64_t> dispatchQueue;
 
@@ -138,8 +179,14 @@ class Schain : public Agent {
 
     void checkForExit();
 
+    void dispatchMessage(ptr<MessageEnvelope> _m);
+
     void proposeNextBlock(uint64_t _previousBlockTimeStamp, uint32_t _previousBlockTimeStampMs);
 
+    void startPipelinedProposal(ptr<CommittedBlock> _block);
+
+    ptr<vector<ptr<Transaction>>> takePipelinedTransactions(block_id _blockID);
+
     void processCommittedBlock(ptr<CommittedBlock> _block);
 
     void startConsensus(const block_id _blockID, ptr<BooleanProposalVector> _propposalVector);
@@ -150,6 +197,8 @@ class Schain : public Agent {
 
     void pushBlockToExtFace(ptr<CommittedBlock> &_block);
 
+    void waitForExtFaceDelivery(block_id _blockID);
+
     ptr<BlockProposal> createEmptyBlockProposal(block_id _blockId);
 
 
@@ -171,6 +220,15 @@ public:
 
     ConsensusExtFace *getExtFace() const;
 
+    /**
+     * Computes the price and calls createBlock() of the external face
+     */
+    void deliverBlockToExtFace(ptr<CommittedBlock> _block);
+
+    uint64_t getExtFaceQueueDepth();
+
+    uint64_t getExtFaceDeliveryLatencyMs();
+
     uint64_t getMaxExternalBlockProcessingTime() const;
 
     Schain(weak_ptr<Node> _node, schain_index _schainIndex, const schain_id &_schainID, ConsensusExtFace *_extFace);
@@ -181,6 +239,8 @@ public:
 
     static void messageThreadProcessingLoop(Schain *_s);
 
+    static void messageShardProcessingLoop(Schain *_s, uint64_t _shard);
+
     uint64_t getLastCommittedBlockTimeStamp();
 
     void setBlockProposerTest(const string &_blockProposerTest);
@@ -197,6 +257,8 @@ public:
 
     void blockCommitsArrivedThroughCatchup(ptr<CommittedBlockList> _blocks);
 
+    void notifyAllConditionVariables() override;
+
     void daProofSigShareArrived(ptr<ThresholdSigShare> _sigShare, ptr<BlockProposal> _proposal);
 
     const ptr<IO> getIo() const;
@@ -207,6 +269,10 @@ public:
 
     ptr<MonitoringAgent> getMonitoringAgent() const;
 
+    ptr<CatchupClientAgent> getCatchupClientAgent() const;
+
+    ptr<BlockFinalizeDownloadAgent> getBlockFinalizeDownloadAgent() const;
+
     schain_index getSchainIndex() const;
 
     ptr<Node> getNode() const;
@@ -223,8 +289,18 @@ public:
 
     node_count getNodeCount();
 
+    /**
+     * @return number of message processing shards, 1 if messages are processed on a single thread
+     */
+    uint64_t getMessageShardCount();
+
     block_id getLastCommittedBlockID() const;
 
+    /**
+     * @return nullptr unless _blockID is the last block committed by this process
+     */
+    ptr<SHAHash> getLastCommittedBlockHash(block_id _blockID);
+
     ptr<CommittedBlock> getBlock(block_id _blockID);
 
     ptr<string> getBlockProposerTest() const;
@@ -235,6 +311,8 @@ public:
 
     void bootstrap(block_id _lastCommittedBlockID, uint64_t _lastCommittedBlockTimeStamp);
 
+    static bool isBinConsensusVote(ptr<NetworkMessage> _m);
+
     uint64_t getTotalTransactions() const;
 
     block_id getBootstrapBlockID() const;
@@ -44,6 +44,7 @@
 #include "pendingqueue/PendingTransactionsAgent.h"
 
 #include "blockfinalize/client/BlockFinalizeDownloader.h"
+#include "blockfinalize/client/BlockFinalizeDownloadAgent.h"
 #include "blockproposal/server/BlockProposalServerAgent.h"
 #include "catchup/client/CatchupClientAgent.h"
 #include "catchup/server/CatchupServerAgent.h"
@@ -95,6 +96,8 @@
 #include "libBLS/bls/BLSPrivateKeyShare.h"
 #include "monitoring/LivelinessMonitor.h"
 #include "Schain.h"
+#include "threads/MPSCQueue.h"
+#include "ExtFaceBlockDeliverer.h"
 
 
 const ptr<IO> Schain::getIo() const {
@@ -114,6 +117,18 @@ ptr<MonitoringAgent> Schain::getMonitoringAgent() const {
     return monitoringAgent;
 }
 
+
+ptr<CatchupClientAgent> Schain::getCatchupClientAgent() const {
+    CHECK_STATE(catchupClientAgent != nullptr)
+    return catchupClientAgent;
+}
+
+
+ptr<BlockFinalizeDownloadAgent> Schain::getBlockFinalizeDownloadAgent() const {
+    CHECK_STATE(blockFinalizeDownloadAgent != nullptr)
+    return blockFinalizeDownloadAgent;
+}
+
 uint64_t Schain::getStartTimeMs() const {
     return startTimeMs;
 }
@@ -122,6 +137,15 @@ block_id Schain::getLastCommittedBlockID() const {
     return lastCommittedBlockID.load();
 }
 
+ptr<SHAHash> Schain::getLastCommittedBlockHash(block_id _blockID) {
+    lock_guard<mutex> lock(lastCommittedBlockHashMutex);
+
+    if (lastCommittedBlockHashID != _blockID)
+        return nullptr;
+
+    return lastCommittedBlockHash;
+}
+
 ptr<BlockProposal> Schain::getBlockProposal(block_id _blockID, schain_index _schainIndex) {
 
     MONITOR(__CLASS_NAME__, __FUNCTION__)
@@ -165,13 +189,13 @@ node_count Schain::getNodeCount() {
 }
 
 
+uint64_t Schain::getMessageShardCount() {
+    return std::max((uint64_t) shardQueues.size(), (uint64_t) 1);
+}
+
+
 transaction_count Schain::getMessagesCount() {
-    size_t cntMessages = 0;
-    { // block
-        lock_guard<mutex> lock(messageMutex);
-        cntMessages = messageQueue.size();
-    } // block
-    return transaction_count(cntMessages);
+    return transaction_count(messageQueue->size() + pendingShardMessages);
 }
 
 
@@ -274,6 +298,18 @@ ConsensusExtFace *Schain::getExtFace() const {
     return extFace;
 }
 
+uint64_t Schain::getExtFaceQueueDepth() {
+    if (extFaceBlockDeliverer == nullptr)
+        return 0;
+    return extFaceBlockDeliverer->getQueueDepth();
+}
+
+uint64_t Schain::getExtFaceDeliveryLatencyMs() {
+    if (extFaceBlockDeliverer == nullptr)
+        return 0;
+    return extFaceBlockDeliverer->getLastDeliveryLatencyMs();
+}
+
 
 uint64_t Schain::getMaxExternalBlockProcessingTime() const {
     return maxExternalBlockProcessingTime;;
@@ -0,0 +1,128 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BLSSigCodec.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+#include "network/Utils.h"
+
+#include "BLSSigCodec.h"
+
+
+BLSSigCodec::BLSSigCodec(uint64_t _cacheSize) : points(_cacheSize) {
+    CHECK_ARGUMENT(_cacheSize > 0);
+}
+
+
+void BLSSigCodec::writeCoordinate(const libff::alt_bn128_Fq &_coordinate, uint8_t *_out) {
+    auto value = _coordinate.as_bigint();
+    for (uint64_t i = 0; i < COORDINATE_SIZE; i++) {
+        _out[COORDINATE_SIZE - 1 - i] = (uint8_t) (value.data[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+
+libff::alt_bn128_Fq BLSSigCodec::readCoordinate(const uint8_t *_in) {
+    libff::bigint<4> value;
+    for (uint64_t i = 0; i < 4; i++) {
+        value.data[i] = 0;
+    }
+    for (uint64_t i = 0; i < COORDINATE_SIZE; i++) {
+        value.data[i / 8] |= ((uint64_t) _in[COORDINATE_SIZE - 1 - i]) << (8 * (i % 8));
+    }
+
+    libff::alt_bn128_Fq result(value);
+
+    // a value above the modulus would be silently reduced, reject it so that the encoding stays unique
+    uint8_t check[COORDINATE_SIZE];
+    writeCoordinate(result, check);
+    CHECK_ARGUMENT2(memcmp(check, _in, COORDINATE_SIZE) == 0, "BLS point coordinate is not reduced");
+
+    return result;
+}
+
+
+ptr<string> BLSSigCodec::encode(const libff::alt_bn128_G1 &_point) {
+
+    auto point = _point;
+    point.to_affine_coordinates();
+
+    uint8_t raw[ENCODED_SIZE];
+    writeCoordinate(point.X, raw);
+    writeCoordinate(point.Y, raw + COORDINATE_SIZE);
+
+    return Utils::carray2Hex(raw, ENCODED_SIZE);
+}
+
+
+ptr<libff::alt_bn128_G1> BLSSigCodec::decodeLegacy(const string &_encoded) {
+
+    auto first = _encoded.find(':');
+    CHECK_ARGUMENT(first != string::npos);
+    auto second = _encoded.find(':', first + 1);
+
+    auto x = _encoded.substr(0, first);
+    auto y = _encoded.substr(first + 1, second == string::npos ? string::npos : second - first - 1);
+
+    CHECK_ARGUMENT2(!x.empty() && !y.empty() &&
+                    x.find_first_not_of("0123456789") == string::npos &&
+                    y.find_first_not_of("0123456789") == string::npos, "Misformatted BLS point:" + _encoded);
+
+    return make_shared<libff::alt_bn128_G1>(libff::alt_bn128_Fq(x.c_str()), libff::alt_bn128_Fq(y.c_str()),
+                                            libff::alt_bn128_Fq::one());
+}
+
+
+ptr<libff::alt_bn128_G1> BLSSigCodec::decode(ptr<string> _encoded) {
+
+    CHECK_ARGUMENT(_encoded != nullptr);
+
+    if (_encoded->find(':') != string::npos) {
+        auto point = decodeLegacy(*_encoded);
+        CHECK_ARGUMENT2(point->is_well_formed(), "BLS point is not on the curve");
+        return point;
+    }
+
+    CHECK_ARGUMENT2(_encoded->size() == 2 * ENCODED_SIZE, "Invalid BLS point size:" + to_string(_encoded->size()));
+
+    string raw(ENCODED_SIZE, '\0');
+    Utils::cArrayFromHex(*_encoded, (uint8_t *) raw.data(), ENCODED_SIZE);
+
+    {
+        LOCK(m)
+        // a copy, since libBLS may normalize the points it is given
+        if (points.exists(raw))
+            return make_shared<libff::alt_bn128_G1>(*points.get(raw));
+    }
+
+    auto point = make_shared<libff::alt_bn128_G1>(readCoordinate((const uint8_t *) raw.data()),
+                                                  readCoordinate((const uint8_t *) raw.data() + COORDINATE_SIZE),
+                                                  libff::alt_bn128_Fq::one());
+
+    CHECK_ARGUMENT2(!point->is_zero() && point->is_well_formed(), "BLS point is not on the curve");
+
+    LOCK(m)
+    points.put(raw, make_shared<libff::alt_bn128_G1>(*point));
+
+    return point;
+}
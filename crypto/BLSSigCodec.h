@@ -0,0 +1,67 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file BLSSigCodec.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_BLSSIGCODEC_H
+#define SKALED_BLSSIGCODEC_H
+
+#include "thirdparty/lrucache.hpp"
+#include "bls_include.h"
+
+
+/**
+ * Compact encoding of sig shares and threshold signatures: the affine X and Y of the G1 point
+ * as 32 byte big endian numbers, written as hex in messages and databases.
+ * Decoded points are cached by their raw bytes, since every share is parsed again when
+ * it is read back from the sig share databases.
+ */
+class BLSSigCodec {
+
+    recursive_mutex m;
+
+    cache::lru_cache<string, ptr<libff::alt_bn128_G1>> points;
+
+    static void writeCoordinate(const libff::alt_bn128_Fq &_coordinate, uint8_t *_out);
+
+    static libff::alt_bn128_Fq readCoordinate(const uint8_t *_in);
+
+    static ptr<libff::alt_bn128_G1> decodeLegacy(const string &_encoded);
+
+public:
+
+    static constexpr uint64_t COORDINATE_SIZE = 32;
+
+    static constexpr uint64_t ENCODED_SIZE = 2 * COORDINATE_SIZE;
+
+    explicit BLSSigCodec(uint64_t _cacheSize);
+
+    static ptr<string> encode(const libff::alt_bn128_G1 &_point);
+
+    /**
+     * Accepts the compact encoding and the decimal "X:Y[:hint]" strings of libBLS written by older versions.
+     * Throws InvalidArgumentException if the point is malformed or not on the curve.
+     */
+    ptr<libff::alt_bn128_G1> decode(ptr<string> _encoded);
+};
+
+
+#endif //SKALED_BLSSIGCODEC_H
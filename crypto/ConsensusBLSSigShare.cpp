@@ -32,6 +32,7 @@
 #include "bls_include.h"
 
 #include "BLSSigShare.h"
+#include "BLSSigCodec.h"
 #include "ConsensusBLSSigShare.h"
 
 
@@ -46,11 +47,14 @@ ConsensusBLSSigShare::ConsensusBLSSigShare(ptr<BLSSigShare> _s, schain_id _schai
 ptr< BLSSigShare > ConsensusBLSSigShare::getBlsSigShare() const {
     return blsSigShare;
 }
-ConsensusBLSSigShare::ConsensusBLSSigShare(ptr<string> _sigShare, schain_id _schainID, block_id _blockID,
-                                           schain_index _signerIndex,
+static string dummy_string("");
+
+ConsensusBLSSigShare::ConsensusBLSSigShare(ptr<libff::alt_bn128_G1> _sigShare, schain_id _schainID,
+                                           block_id _blockID, schain_index _signerIndex,
                                            uint64_t _totalSigners, uint64_t _requiredSigners)
     : ThresholdSigShare(_schainID, _blockID, _signerIndex) {
-    this->blsSigShare = make_shared<BLSSigShare >( _sigShare, ( uint64_t ) _signerIndex,
+    CHECK_ARGUMENT(_sigShare != nullptr);
+    this->blsSigShare = make_shared<BLSSigShare >( _sigShare, dummy_string, ( uint64_t ) _signerIndex,
             _totalSigners, _requiredSigners);
 }
 
@@ -58,6 +62,12 @@ ConsensusBLSSigShare::~ConsensusBLSSigShare() {
 
 }
 
+void ConsensusBLSSigShare::setCompactEncoding(bool _compactEncoding) {
+    compactEncoding = _compactEncoding;
+}
+
 ptr<std::string> ConsensusBLSSigShare::toString() {
-    return getBlsSigShare()->toString();
+    if (!compactEncoding)
+        return getBlsSigShare()->toString();
+    return BLSSigCodec::encode(*getBlsSigShare()->getSigShare());
 }
@@ -37,6 +37,9 @@ class ConsensusBLSSigShare : public ThresholdSigShare {
 
     ptr<BLSSigShare> blsSigShare;
 
+    // old nodes only parse the libBLS string
+    bool compactEncoding = false;
+
 public:
 
 
@@ -45,12 +48,17 @@ public:
     ConsensusBLSSigShare(ptr<BLSSigShare> _s, schain_id _schainId, block_id _blockID);
 
 
-    ConsensusBLSSigShare(ptr<string> _sigShare, schain_id _schainID, block_id _blockID, schain_index _signerIndex,
-                         uint64_t _totalSigners, uint64_t _requiredSigners);
+    ConsensusBLSSigShare(ptr<libff::alt_bn128_G1> _sigShare, schain_id _schainID, block_id _blockID,
+                         schain_index _signerIndex, uint64_t _totalSigners, uint64_t _requiredSigners);
 
 
     ptr< BLSSigShare > getBlsSigShare() const;
 
+    void setCompactEncoding(bool _compactEncoding);
+
+    /**
+     * Compact encoding of BLSSigCodec if enabled, libBLS string otherwise
+     */
     virtual ptr<std::string> toString();
 
     virtual ~ConsensusBLSSigShare();
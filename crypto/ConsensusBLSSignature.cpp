@@ -31,17 +31,11 @@
 #include "thirdparty/json.hpp"
 
 #include "libBLS/bls/BLSSignature.h"
+#include "BLSSigCodec.h"
 #include "ConsensusBLSSignature.h"
 #include "ThresholdSignature.h"
 
 
-ConsensusBLSSignature::ConsensusBLSSignature(
-    ptr< string > _s, block_id _blockID, size_t _totalSigners, size_t _requiredSigners )
-    : ThresholdSignature(_blockID, _totalSigners, _requiredSigners){
-    blsSig = make_shared<BLSSignature>( _s, _totalSigners, _requiredSigners );
-}
-
-
 static string dummy_string("");
 
 ConsensusBLSSignature::ConsensusBLSSignature( ptr< libff::alt_bn128_G1 > _s, block_id _blockID,
@@ -50,8 +44,14 @@ ConsensusBLSSignature::ConsensusBLSSignature( ptr< libff::alt_bn128_G1 > _s, blo
     blsSig = make_shared<BLSSignature>(_s, dummy_string, _totalSigners, _requiredSigners );
 }
 
+void ConsensusBLSSignature::setCompactEncoding(bool _compactEncoding) {
+    compactEncoding = _compactEncoding;
+}
+
 std::shared_ptr<std::string> ConsensusBLSSignature::toString() {
-    return blsSig->toString();
+    if (!compactEncoding)
+        return blsSig->toString();
+    return BLSSigCodec::encode(*blsSig->getSig());
 };
 
 uint64_t ConsensusBLSSignature::getRandom() {
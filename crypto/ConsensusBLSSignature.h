@@ -36,15 +36,19 @@ class ConsensusBLSSignature : public ThresholdSignature {
 
     ptr<BLSSignature> blsSig = nullptr;
 
-public:
-
-    ConsensusBLSSignature(
-        ptr< string > _s, block_id _blockID, size_t _totalSigners, size_t _requiredSigners );
+    // old nodes only parse the libBLS string
+    bool compactEncoding = false;
 
+public:
 
     ConsensusBLSSignature( ptr< libff::alt_bn128_G1 > _s, block_id _blockID, size_t _totalSigners,
         size_t _requiredSigners );
 
+    void setCompactEncoding(bool _compactEncoding);
+
+    /**
+     * Compact encoding of BLSSigCodec if enabled, libBLS string otherwise
+     */
     std::shared_ptr<std::string> toString();
 
     uint64_t getRandom();
@@ -34,16 +34,18 @@
 #include "ConsensusBLSSigShare.h"
 
 #include "BLSSigShareSet.h"
+#include "LagrangeCoeffsCache.h"
 #include "ConsensusSigShareSet.h"
 
 
 using namespace std;
 
 
-ConsensusSigShareSet::ConsensusSigShareSet(block_id _blockId, size_t _totalSigners, size_t _requiredSigners )
-    : ThresholdSigShareSet(_blockId, _totalSigners, _requiredSigners), blsSet(_totalSigners, _requiredSigners)  {
-
-
+ConsensusSigShareSet::ConsensusSigShareSet(block_id _blockId, size_t _totalSigners, size_t _requiredSigners,
+                                           ptr<LagrangeCoeffsCache> _coeffsCache)
+    : ThresholdSigShareSet(_blockId, _totalSigners, _requiredSigners), blsSet(_totalSigners, _requiredSigners),
+      coeffsCache(_coeffsCache) {
+    CHECK_ARGUMENT(_coeffsCache != nullptr);
     totalObjects++;
 }
 
@@ -54,10 +56,24 @@ ConsensusSigShareSet::~ConsensusSigShareSet() {
 
 
 ptr<ThresholdSignature > ConsensusSigShareSet::mergeSignature() {
-    auto blsShare = blsSet.merge();
-    // BOOST_REQUIRE(obj.Verification(hash, common_signature, pk) == false);
-    return make_shared<ConsensusBLSSignature>( blsShare->getSig(), blockId,
-            blsShare->getTotalSigners(), blsShare->getRequiredSigners());
+
+    CHECK_STATE(blsSet.isEnough());
+
+    vector<size_t> signerIndices;
+    vector<libff::alt_bn128_G1> shares;
+
+    for (auto &&item : blsSigShares) {
+        signerIndices.push_back(item.first);
+        shares.push_back(*item.second->getSigShare());
+        if (signerIndices.size() == requiredSigners)
+            break;
+    }
+
+    auto coeffs = coeffsCache->getCoeffs(signerIndices);
+
+    auto sig = make_shared<libff::alt_bn128_G1>(LagrangeCoeffsCache::combine(shares, *coeffs));
+
+    return make_shared<ConsensusBLSSignature>(sig, blockId, totalSigners, requiredSigners);
 }
 
 bool ConsensusSigShareSet::isEnough() {
@@ -80,6 +96,13 @@ bool ConsensusSigShareSet::addSigShare(shared_ptr<ThresholdSigShare> _sigShare)
 
     ASSERT(s != nullptr);
 
-    return blsSet.addSigShare(s->getBlsSigShare());
+    auto blsSigShare = s->getBlsSigShare();
+
+    if (!blsSet.addSigShare(blsSigShare))
+        return false;
+
+    blsSigShares[blsSigShare->getSignerIndex()] = blsSigShare;
+
+    return true;
 }
 
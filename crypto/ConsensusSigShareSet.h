@@ -33,14 +33,21 @@ class Schain;
 class ConsensusBLSSigShare;
 class ConsensusBLSSignature;
 class SHAHash;
+class LagrangeCoeffsCache;
+class BLSSigShare;
 
 class ConsensusSigShareSet : public ThresholdSigShareSet {
 
     BLSSigShareSet blsSet;
 
+    // signer index -> share, ordered as the coefficients of the merged set
+    map<uint64_t, ptr<BLSSigShare>> blsSigShares;
+
+    ptr<LagrangeCoeffsCache> coeffsCache;
 
 public:
-    ConsensusSigShareSet(block_id _blockId, size_t _totalSigners, size_t _requiredSigners );
+    ConsensusSigShareSet(block_id _blockId, size_t _totalSigners, size_t _requiredSigners,
+                         ptr<LagrangeCoeffsCache> _coeffsCache);
 
     ptr<ThresholdSignature> mergeSignature();
 
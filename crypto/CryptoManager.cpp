@@ -41,7 +41,10 @@
 #include "SkaleCommon.h"
 #include "Log.h"
 #include "thirdparty/json.hpp"
+#include "exceptions/ExitRequestedException.h"
+#include "exceptions/InvalidStateException.h"
 #include "messages/NetworkMessage.h"
+#include "messages/NetworkMessageBatch.h"
 #include "chains/Schain.h"
 #include "SHAHash.h"
 #include "ConsensusBLSSigShare.h"
@@ -54,9 +57,18 @@
 #include "node/Node.h"
 #include "monitoring/LivelinessMonitor.h"
 #include "datastructures/BlockProposal.h"
+#include "bls_include.h"
 #include "bls/BLSPrivateKeyShare.h"
+#include "bls/BLSPublicKeyShare.h"
+#include "BLSSigShare.h"
 
 #include "ECDSAVerify.h"
+#include "MockupECDSASigner.h"
+#include "SGXECDSASigner.h"
+#include "SGXECDSASignerThreadPool.h"
+#include "LocalECDSASigner.h"
+#include "LagrangeCoeffsCache.h"
+#include "BLSSigCodec.h"
 #include "CryptoManager.h"
 
 
@@ -66,47 +78,95 @@ CryptoManager::CryptoManager(Schain &_sChain) : sChain(&_sChain) {
     ecdsaVerify = make_shared<ECDSAVerify>();
 
     static string empty = "";
-    sgxIP = _sChain.getNode()->getParamString("sgxIP", empty);
+    auto node = _sChain.getNode();
+    sgxIP = node->getParamString("sgxIP", empty);
+    auto ecdsaKeyFileFullPath = node->getParamString("ecdsaKeyFileFullPath", empty);
 
     if (sgxIP->length() == 0)
         sgxIP = nullptr;
     else {
         sgxEnabled = true;
-        auto node = _sChain.getNode();
         sgxSSLKeyFileFullPath = node->getParamString("sgxKeyFileFullPath", empty);
         sgxSSLCertFileFullPath = node->getParamString("sgxCertFileFullPath", empty);
         sgxECDSAKeyName = node->getParamString("sgxECDSAKeyName", empty);
         if (sgxECDSAKeyName->length() == 0) {
-            auto keyName = std::getenv("sgxECDSAKeyName." + _sChain.getSchainIndex());
+            auto keyName = std::getenv(("sgxECDSAKeyName." + to_string(_sChain.getSchainIndex())).c_str());
             ASSERT(keyName != nullptr);
             sgxECDSAKeyName = make_shared<string>(keyName);
         }
 
 
+        ASSERT(sgxSSLKeyFileFullPath->length() > 0);
+        ASSERT(sgxSSLCertFileFullPath->length() > 0);
+
+        setSGXKeyAndCert(*sgxSSLKeyFileFullPath, *sgxSSLCertFileFullPath);
+    }
+
+    if (sgxEnabled) {
+        CHECK_STATE2(ecdsaKeyFileFullPath->length() == 0, "sgxIP and ecdsaKeyFileFullPath can not be both set");
+        ecdsaSigner = make_shared<SGXECDSASigner>(sgxIP, sgxECDSAKeyName);
+    } else if (ecdsaKeyFileFullPath->length() > 0) {
+        ecdsaSigner = make_shared<LocalECDSASigner>(*ecdsaKeyFileFullPath);
+    } else {
+        ecdsaSigner = make_shared<MockupECDSASigner>();
+    }
+
+    mockupECDSA = dynamic_pointer_cast<MockupECDSASigner>(ecdsaSigner) != nullptr;
+
+    LOG(info, "ECDSA signer:" + *ecdsaSigner->getName());
+
+    // real signatures are verified with the public keys of all nodes, decoded once here
+    if (!mockupECDSA) {
         for (int i = 1; i <= _sChain.getNodeCount(); i++) {
 
             string paramName = "sgxECDSAPublicKey." + to_string(i);
 
-            sgxECDSAPublicKeys.at(i) = node->getParamString(paramName, empty);
-            if (sgxECDSAPublicKeys.at(i)->length() == 0) {
-                auto publicKey = std::getenv(paramName.c_str());
-                ASSERT(publicKey != nullptr);
-                sgxECDSAPublicKeys.at(i) = make_shared<string>(publicKey);
+            auto publicKey = node->getParamString(paramName, empty);
+            if (publicKey->length() == 0) {
+                auto publicKeyEnv = std::getenv(paramName.c_str());
+                ASSERT(publicKeyEnv != nullptr);
+                publicKey = make_shared<string>(publicKeyEnv);
             }
+            sgxECDSAPublicKeys.push_back(publicKey);
+            ecdsaVerify->addPublicKey(i, publicKey);
         }
+    }
 
+    totalSigners = sChain->getTotalSigners();
+    requiredSigners = sChain->getRequiredSigners();
 
-        ASSERT(sgxSSLKeyFileFullPath->length() > 0);
-        ASSERT(sgxSSLCertFileFullPath->length() > 0);
+    lagrangeCoeffsCache = make_shared<LagrangeCoeffsCache>(totalSigners, requiredSigners, LAGRANGE_COEFFS_CACHE_SIZE);
+    blsSigCodec = make_shared<BLSSigCodec>(BLS_SIG_CODEC_CACHE_SIZE);
 
-        setSGXKeyAndCert(*sgxSSLKeyFileFullPath, *sgxSSLCertFileFullPath);
+    // BLS public key shares are given as x0:x1:y0:y1, either for all nodes or for none
+    for (int i = 1; i <= _sChain.getNodeCount(); i++) {
 
-        jsonrpc::HttpClient httpClient("https://" + *sgxIP + ":1026");
-        sgxClient = make_shared<StubClient>(httpClient, jsonrpc::JSONRPC_CLIENT_V2);
+        auto publicKeyShare = node->getParamString("blsPublicKeyShare." + to_string(i), empty);
+
+        if (publicKeyShare->length() == 0) {
+            CHECK_STATE2(blsPublicKeyShares.empty(), "blsPublicKeyShare is not set for node " + to_string(i));
+            continue;
+        }
+
+        CHECK_STATE2(blsPublicKeyShares.size() + 1 == (uint64_t) i,
+                     "blsPublicKeyShare is not set for all nodes before " + to_string(i));
+
+        auto coordinates = make_shared<vector<string>>();
+        stringstream stream(*publicKeyShare);
+        string coordinate;
+        while (getline(stream, coordinate, ':')) {
+            coordinates->push_back(coordinate);
+        }
+
+        CHECK_STATE2(coordinates->size() == 4, "Invalid blsPublicKeyShare." + to_string(i));
+
+        blsPublicKeyShares.push_back(make_shared<BLSPublicKeyShare>(coordinates, totalSigners, requiredSigners));
     }
 
-    totalSigners = sChain->getTotalSigners();
-    requiredSigners = sChain->getRequiredSigners();
+    optimisticSigShareMerge = node->getParamUint64("optimisticSigShareMerge", OPTIMISTIC_SIG_SHARE_MERGE) != 0;
+
+    if (!blsPublicKeyShares.empty() && !optimisticSigShareMerge)
+        LOG(info, "BLS sig shares are verified before merging");
 }
 
 void CryptoManager::setSGXKeyAndCert(string &_keyFullPath, string &_certFullPath) {
@@ -115,6 +175,24 @@ void CryptoManager::setSGXKeyAndCert(string &_keyFullPath, string &_certFullPath
     jsonrpc::HttpClient::setSslClientPort(SGX_SSL_PORT);
 }
 
+void CryptoManager::startService() {
+    auto sgxSigner = dynamic_pointer_cast<SGXECDSASigner>(ecdsaSigner);
+
+    if (sgxSigner == nullptr || sChain == nullptr)
+        return;
+
+    sgxSigner->startBatching();
+    sgxSignerThreadPool = make_shared<SGXECDSASignerThreadPool>(sgxSigner.get(), sChain);
+    sgxSignerThreadPool->startService();
+}
+
+void CryptoManager::exit() {
+    auto sgxSigner = dynamic_pointer_cast<SGXECDSASigner>(ecdsaSigner);
+
+    if (sgxSigner != nullptr)
+        sgxSigner->exit();
+}
+
 Schain *CryptoManager::getSchain() const {
     return sChain;
 }
@@ -123,14 +201,7 @@ Schain *CryptoManager::getSchain() const {
 ptr<string> CryptoManager::sgxSignECDSA(ptr<SHAHash> _hash, string &_keyName, ptr<StubClient> _sgxClient) {
     CHECK_ARGUMENT(_sgxClient);
     auto result = _sgxClient->ecdsaSignMessageHash(16, _keyName, *_hash->toHex());
-    auto status = result["status"].asInt64();
-    CHECK_STATE(status == 0);
-    string r = result["signature_r"].asString();
-    string s = result["signature_r"].asString();
-    string v = result["signature_v"].asString();
-
-    return make_shared<string>(v + ":" + r.substr(2) + ":" + s.substr(2));
-
+    return SGXECDSASigner::parseSignature(result);
 }
 
 void CryptoManager::sgxVerifyECDSA(ptr<SHAHash> _hash, ptr<string> _publicKey, ptr<string> _sig) {
@@ -140,17 +211,17 @@ void CryptoManager::sgxVerifyECDSA(ptr<SHAHash> _hash, ptr<string> _publicKey, p
 
 ptr<string> CryptoManager::signECDSA(ptr<SHAHash> _hash) {
     CHECK_ARGUMENT(_hash);
-    if (sgxEnabled) {
-        return sgxSignECDSA(_hash, *sgxECDSAKeyName, sgxClient);
-    } else {
-        return _hash->toHex();
-    }
+    return ecdsaSigner->sign(_hash);
 }
 
-bool CryptoManager::verifyECDSA(ptr<SHAHash> _hash, ptr<string> _sig) {
+bool CryptoManager::verifyECDSA(ptr<SHAHash> _hash, ptr<string> _sig, schain_index _signerIndex) {
     CHECK_ARGUMENT(_hash != nullptr)
     CHECK_ARGUMENT(_sig != nullptr)
-    return *_sig == *(_hash->toHex());
+
+    if (mockupECDSA)
+        return *_sig == *(_hash->toHex());
+
+    return ecdsaVerify->verify(_hash, _sig, _signerIndex);
 }
 
 
@@ -180,7 +251,9 @@ ptr<ThresholdSigShare> CryptoManager::signSigShare(ptr<SHAHash> _hash, block_id
 
         auto blsShare = sChain->getNode()->getBlsPrivateKey()->sign(hash, (uint64_t) sChain->getSchainIndex());
 
-        return make_shared<ConsensusBLSSigShare>(blsShare, sChain->getSchainID(), _blockId);
+        auto sigShare = make_shared<ConsensusBLSSigShare>(blsShare, sChain->getSchainID(), _blockId);
+        sigShare->setCompactEncoding(isCompactBLSEncoding());
+        return sigShare;
 
 
     } else {
@@ -195,19 +268,281 @@ ptr<ThresholdSigShare> CryptoManager::signSigShare(ptr<SHAHash> _hash, block_id
 ptr<ThresholdSigShareSet>
 CryptoManager::createSigShareSet(block_id _blockId) {
     if (getSchain()->getNode()->isBlsEnabled()) {
-        return make_shared<ConsensusSigShareSet>(_blockId, totalSigners, requiredSigners);
+        return make_shared<ConsensusSigShareSet>(_blockId, totalSigners, requiredSigners, lagrangeCoeffsCache);
     } else {
         return make_shared<MockupSigShareSet>(_blockId, totalSigners, requiredSigners);
     }
 }
 
 
+void CryptoManager::peerBLSEncodingArrived(schain_index _peerIndex, bool _compact) {
+    CHECK_ARGUMENT(_peerIndex != sChain->getSchainIndex());
+
+    lock_guard<mutex> lock(compactBLSPeersLock);
+
+    if (_compact) {
+        compactBLSPeers.insert(_peerIndex);
+    } else {
+        compactBLSPeers.erase(_peerIndex);
+    }
+}
+
+
+bool CryptoManager::isCompactBLSEncoding() {
+    if (totalSigners <= 1 || !sChain->getNode()->isCompactBLSEncoding())
+        return false;
+
+    lock_guard<mutex> lock(compactBLSPeersLock);
+
+    // shares and signatures end up in blocks and messages that every other peer must parse
+    for (uint64_t i = 1; i <= totalSigners; i++) {
+        if (i != (uint64_t) sChain->getSchainIndex() && compactBLSPeers.count(schain_index(i)) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+
+/* Random linear combination of shares of the same hash: e(sum r_i * S_i, G2) == e(H, sum r_i * PK_i) */
+static bool verifyBLSSigShareBatch(const libff::alt_bn128_G1 &_hashPoint,
+                                   const vector<pair<ptr<libff::alt_bn128_G1>, ptr<libff::alt_bn128_G2>>> &_shares,
+                                   uint64_t _begin, uint64_t _end) {
+
+    static thread_local random_device randomDevice;
+
+    auto sigSum = libff::alt_bn128_G1::zero();
+    auto publicKeySum = libff::alt_bn128_G2::zero();
+
+    for (uint64_t i = _begin; i < _end; i++) {
+        // 64 bit coefficients are enough to catch a bad share, and cost a quarter of full scalars
+        libff::bigint<1> r((((uint64_t) randomDevice() << 32) | randomDevice()) | 1);
+        sigSum = sigSum + r * *_shares.at(i).first;
+        publicKeySum = publicKeySum + r * *_shares.at(i).second;
+    }
+
+    return libff::alt_bn128_ate_reduced_pairing(sigSum, libff::alt_bn128_G2::one()) ==
+           libff::alt_bn128_ate_reduced_pairing(_hashPoint, publicKeySum);
+}
+
+/* Adds positions of bad shares in [_begin, _end) to _badPositions, returns true if there were any */
+static bool findBadBLSSigShares(const libff::alt_bn128_G1 &_hashPoint,
+                                const vector<pair<ptr<libff::alt_bn128_G1>, ptr<libff::alt_bn128_G2>>> &_shares,
+                                uint64_t _begin, uint64_t _end, bool _knownToFail,
+                                vector<uint64_t> &_badPositions) {
+
+    if (!_knownToFail && verifyBLSSigShareBatch(_hashPoint, _shares, _begin, _end))
+        return false;
+
+    if (_end - _begin == 1) {
+        _badPositions.push_back(_begin);
+        return true;
+    }
+
+    auto middle = _begin + (_end - _begin) / 2;
+
+    // if the left half is good, the bad share is in the right half and it does not need another check
+    auto leftFailed = findBadBLSSigShares(_hashPoint, _shares, _begin, middle, false, _badPositions);
+    findBadBLSSigShares(_hashPoint, _shares, middle, _end, !leftFailed, _badPositions);
+
+    return true;
+}
+
+vector<uint64_t> CryptoManager::findBadBLSSigSharePositions(
+        const libff::alt_bn128_G1 &_hashPoint,
+        const vector<pair<ptr<libff::alt_bn128_G1>, ptr<libff::alt_bn128_G2>>> &_shares) {
+
+    vector<uint64_t> badPositions;
+
+    if (!_shares.empty())
+        findBadBLSSigShares(_hashPoint, _shares, 0, _shares.size(), false, badPositions);
+
+    return badPositions;
+}
+
+ptr<vector<schain_index>>
+CryptoManager::verifySigShares(ptr<SHAHash> _hash, const vector<ptr<ThresholdSigShare>> &_sigShares) {
+
+    CHECK_ARGUMENT(_hash != nullptr);
+
+    MONITOR(__CLASS_NAME__, __FUNCTION__)
+
+    auto badShares = make_shared<vector<schain_index>>();
+
+    if (!getSchain()->getNode()->isBlsEnabled()) {
+        // mockup shares are hashes
+        for (auto &&share : _sigShares) {
+            CHECK_ARGUMENT(share != nullptr);
+            if (*share->toString() != *_hash->toHex())
+                badShares->push_back(share->getSignerIndex());
+        }
+        return badShares;
+    }
+
+    if (blsPublicKeyShares.empty() || _sigShares.empty())
+        return badShares;
+
+    vector<pair<ptr<libff::alt_bn128_G1>, ptr<libff::alt_bn128_G2>>> shares;
+
+    for (auto &&share : _sigShares) {
+        auto blsShare = dynamic_pointer_cast<ConsensusBLSSigShare>(share);
+        CHECK_ARGUMENT(blsShare != nullptr);
+        auto index = (uint64_t) share->getSignerIndex();
+        CHECK_ARGUMENT(index > 0 && index <= blsPublicKeyShares.size());
+        shares.push_back({blsShare->getBlsSigShare()->getSigShare(), blsPublicKeyShares.at(index - 1)->getPublicKey()});
+    }
+
+    auto hash = make_shared<std::array<uint8_t, 32>>();
+    memcpy(hash->data(), _hash->data(), 32);
+
+    signatures::Bls bls(requiredSigners, totalSigners);
+    auto hashPoint = bls.HashtoG1(hash);
+
+    for (auto &&position : findBadBLSSigSharePositions(hashPoint, shares)) {
+        badShares->push_back(_sigShares.at(position)->getSignerIndex());
+    }
+
+    return badShares;
+}
+
+ptr<ThresholdSignature> CryptoManager::mergeAndVerifySigShares(ptr<SHAHash> _hash, block_id _blockId,
+                                                               const vector<ptr<ThresholdSigShare>> &_sigShares) {
+    try {
+        auto sigShareSet = createSigShareSet(_blockId);
+
+        for (auto &&share : _sigShares) {
+            if (sigShareSet->isEnough())
+                break;
+            sigShareSet->addSigShare(share);
+        }
+
+        CHECK_STATE(sigShareSet->isEnough());
+
+        auto signature = sigShareSet->mergeSignature();
+        CHECK_STATE(signature != nullptr);
+
+        auto blsSignature = dynamic_pointer_cast<ConsensusBLSSignature>(signature);
+        if (blsSignature != nullptr)
+            blsSignature->setCompactEncoding(isCompactBLSEncoding());
+
+        checkThresholdSig(_hash, signature);
+
+        return signature;
+    } catch (ExitRequestedException &) { throw; } catch (exception &e) {
+        LOG(warn, "Merged signature did not verify:BID:" + to_string(_blockId) + ":" + e.what());
+        return nullptr;
+    }
+}
+
+ptr<ThresholdSignature> CryptoManager::mergeSigShares(ptr<SHAHash> _hash, block_id _blockId,
+                                                      const vector<ptr<ThresholdSigShare>> &_sigShares,
+                                                      vector<schain_index> &_badShares,
+                                                      schain_index _latestSigner) {
+    CHECK_ARGUMENT(_hash != nullptr);
+    CHECK_ARGUMENT(_sigShares.size() >= requiredSigners);
+
+    // in the honest case this is a single verification instead of checking every share
+    if (optimisticSigShareMerge) {
+        auto signature = mergeAndVerifySigShares(_hash, _blockId, _sigShares);
+        if (signature != nullptr)
+            return signature;
+    }
+
+    auto badShares = verifySigShares(_hash, _sigShares);
+
+    if (!badShares->empty()) {
+        _badShares.insert(_badShares.end(), badShares->begin(), badShares->end());
+        return nullptr;
+    }
+
+    if (getSchain()->getNode()->isBlsEnabled() && blsPublicKeyShares.empty()) {
+        auto signature = searchSigShareSubsets(_hash, _blockId, _sigShares, _latestSigner);
+        if (signature == nullptr)
+            LOG(warn, "Could not merge sig shares, waiting for more:BID:" + to_string(_blockId) +
+                      ":SHARES:" + to_string(_sigShares.size()));
+        return signature;
+    }
+
+    if (!optimisticSigShareMerge) {
+        auto signature = mergeAndVerifySigShares(_hash, _blockId, _sigShares);
+        if (signature != nullptr)
+            return signature;
+    }
+
+    BOOST_THROW_EXCEPTION(InvalidStateException("Merged signature did not verify and no bad shares found",
+                                                __CLASS_NAME__));
+}
+
+
+ptr<ThresholdSignature> CryptoManager::searchSigShareSubsets(ptr<SHAHash> _hash, block_id _blockId,
+                                                             const vector<ptr<ThresholdSigShare>> &_sigShares,
+                                                             schain_index _latestSigner) {
+    // earlier quorums were tried when the earlier shares arrived, so each new one has to be in the quorum
+    ptr<ThresholdSigShare> latest = nullptr;
+    vector<ptr<ThresholdSigShare>> others;
+
+    for (auto &&share : _sigShares) {
+        if (latest == nullptr && share->getSignerIndex() == _latestSigner) {
+            latest = share;
+        } else {
+            others.push_back(share);
+        }
+    }
+
+    uint64_t pick = (latest != nullptr) ? requiredSigners - 1 : requiredSigners;
+
+    if (others.size() < pick)
+        return nullptr;
+
+    // combinations of pick out of the other shares, in lexicographic order
+    vector<uint64_t> positions(pick);
+
+    for (uint64_t i = 0; i < pick; i++) {
+        positions.at(i) = i;
+    }
+
+    for (uint64_t attempt = 0; attempt < SIG_SHARE_MERGE_MAX_SUBSETS; attempt++) {
+        vector<ptr<ThresholdSigShare>> quorum;
+
+        if (latest != nullptr)
+            quorum.push_back(latest);
+
+        for (auto &&position : positions) {
+            quorum.push_back(others.at(position));
+        }
+
+        auto signature = mergeAndVerifySigShares(_hash, _blockId, quorum);
+
+        if (signature != nullptr)
+            return signature;
+
+        int64_t i = (int64_t) pick - 1;
+
+        while (i >= 0 && positions.at(i) == others.size() - pick + (uint64_t) i)
+            i--;
+
+        if (i < 0)
+            break;
+
+        positions.at(i)++;
+
+        for (uint64_t j = i + 1; j < pick; j++) {
+            positions.at(j) = positions.at(j - 1) + 1;
+        }
+    }
+
+    return nullptr;
+}
+
+
 ptr<ThresholdSigShare>
 CryptoManager::createSigShare(ptr<string> _sigShare, schain_id _schainID, block_id _blockID,
                               schain_index _signerIndex) {
     if (getSchain()->getNode()->isBlsEnabled()) {
-        return make_shared<ConsensusBLSSigShare>(_sigShare, _schainID, _blockID, _signerIndex,
-                                                 totalSigners, requiredSigners);
+        auto sigShare = make_shared<ConsensusBLSSigShare>(blsSigCodec->decode(_sigShare), _schainID, _blockID,
+                                                          _signerIndex, totalSigners, requiredSigners);
+        sigShare->setCompactEncoding(isCompactBLSEncoding());
+        return sigShare;
     } else {
         return make_shared<MockupSigShare>(_sigShare, _schainID, _blockID, _signerIndex,
                                            totalSigners, requiredSigners);
@@ -227,11 +562,15 @@ ptr<string> CryptoManager::signNetworkMsg(NetworkMessage &_msg) {
     return signature;
 }
 
+future<ptr<string>> CryptoManager::signNetworkMsgAsync(NetworkMessage &_msg) {
+    return ecdsaSigner->signAsync(_msg.getHash());
+}
+
 bool CryptoManager::verifyNetworkMsg(NetworkMessage &_msg) {
     auto sig = _msg.getECDSASig();
     auto hash = _msg.getHash();
 
-    if (!verifyECDSA(hash, sig)) {
+    if (!verifyECDSA(hash, sig, _msg.getSrcSchainIndex())) {
         LOG(warn, "ECDSA sig did not verify");
         return false;
     }
@@ -239,6 +578,22 @@ bool CryptoManager::verifyNetworkMsg(NetworkMessage &_msg) {
     return true;
 }
 
+future<ptr<string>> CryptoManager::signNetworkMsgBatchAsync(NetworkMessageBatch &_batch) {
+    return ecdsaSigner->signAsync(_batch.getHash());
+}
+
+bool CryptoManager::verifyNetworkMsgBatch(NetworkMessageBatch &_batch) {
+    auto sig = _batch.getECDSASig();
+    auto hash = _batch.getHash();
+
+    if (!verifyECDSA(hash, sig, _batch.getSrcSchainIndex())) {
+        LOG(warn, "ECDSA batch sig did not verify");
+        return false;
+    }
+
+    return true;
+}
+
 bool CryptoManager::verifyProposalECDSA(ptr<BlockProposal> _proposal, ptr<string> _hashStr, ptr<string> _signature) {
     CHECK_ARGUMENT(_proposal != nullptr);
     CHECK_ARGUMENT(_hashStr != nullptr)
@@ -251,7 +606,11 @@ bool CryptoManager::verifyProposalECDSA(ptr<BlockProposal> _proposal, ptr<string
         return false;
     }
 
-    if (!verifyECDSA(hash, _signature)) {
+    // empty blocks are not signed by a proposer
+    if (_proposal->getProposerIndex() == 0)
+        return true;
+
+    if (!verifyECDSA(hash, _signature, _proposal->getProposerIndex())) {
         LOG(warn, "ECDSA sig did not verify");
         return false;
     }
@@ -262,6 +621,27 @@ ptr<ThresholdSignature>
 CryptoManager::verifyThresholdSig(ptr<SHAHash> _hash, ptr<string> _signature, block_id _blockId) {
     MONITOR(__CLASS_NAME__, __FUNCTION__)
 
+    ptr<ThresholdSignature> sig;
+
+    if (getSchain()->getNode()->isBlsEnabled()) {
+        auto blsSig = make_shared<ConsensusBLSSignature>(blsSigCodec->decode(_signature), _blockId,
+                                                         requiredSigners, totalSigners);
+        blsSig->setCompactEncoding(isCompactBLSEncoding());
+        sig = blsSig;
+    } else {
+        sig = make_shared<MockupSignature>(_signature, _blockId, requiredSigners, totalSigners);
+    }
+
+    checkThresholdSig(_hash, sig);
+
+    return sig;
+}
+
+
+void CryptoManager::checkThresholdSig(ptr<SHAHash> _hash, ptr<ThresholdSignature> _signature) {
+
+    CHECK_ARGUMENT(_hash != nullptr);
+    CHECK_ARGUMENT(_signature != nullptr);
 
     if (getSchain()->getNode()->isBlsEnabled()) {
 
@@ -269,24 +649,19 @@ CryptoManager::verifyThresholdSig(ptr<SHAHash> _hash, ptr<string> _signature, bl
 
         memcpy(hash->data(), _hash->data(), 32);
 
-
-        auto sig = make_shared<ConsensusBLSSignature>(_signature, _blockId, requiredSigners, totalSigners);
+        auto blsSig = dynamic_pointer_cast<ConsensusBLSSignature>(_signature);
+        CHECK_STATE(blsSig != nullptr);
 
         if (!sChain->getNode()->getBlsPublicKey()->VerifySig(hash,
-                                                             sig->getBlsSig(), requiredSigners, totalSigners)) {
+                                                             blsSig->getBlsSig(), requiredSigners, totalSigners)) {
             BOOST_THROW_EXCEPTION(InvalidArgumentException("BLS Signature did not verify",
                                                            __CLASS_NAME__));
         }
-        return sig;
     } else {
-
-        auto sig = make_shared<MockupSignature>(_signature, _blockId, requiredSigners, totalSigners);
-
-        if (*sig->toString() != *_hash->toHex()) {
+        if (*_signature->toString() != *_hash->toHex()) {
             BOOST_THROW_EXCEPTION(InvalidArgumentException("Mockup threshold signature did not verify",
                                                            __CLASS_NAME__));
         }
-        return sig;
     }
 }
 
@@ -373,7 +748,19 @@ CryptoManager::CryptoManager(uint64_t totalSigners, uint64_t requiredSigners, co
           sgxSSLKeyFileFullPath(sgxSslKeyFileFullPath), sgxSSLCertFileFullPath(sgxSslCertFileFullPath),
           sgxECDSAKeyName(sgxEcdsaKeyName), sgxECDSAPublicKeys(sgxEcdsaPublicKeys) {
     ecdsaVerify = make_shared<ECDSAVerify>();
+    lagrangeCoeffsCache = make_shared<LagrangeCoeffsCache>(totalSigners, requiredSigners, LAGRANGE_COEFFS_CACHE_SIZE);
+    blsSigCodec = make_shared<BLSSigCodec>(BLS_SIG_CODEC_CACHE_SIZE);
     this->sgxEnabled = sgxIp != nullptr;
+
+    if (sgxEnabled) {
+        ecdsaSigner = make_shared<SGXECDSASigner>(sgxIp, sgxEcdsaKeyName);
+        mockupECDSA = false;
+        for (uint64_t i = 0; i < sgxEcdsaPublicKeys.size(); i++) {
+            ecdsaVerify->addPublicKey(i + 1, sgxEcdsaPublicKeys.at(i));
+        }
+    } else {
+        ecdsaSigner = make_shared<MockupECDSASigner>();
+    }
 }
 
 
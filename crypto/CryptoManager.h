@@ -36,16 +36,27 @@ class ConsensusBLSSigShare;
 class ThresholdSigShareSet;
 class ThresholdSigShare;
 class BlockProposal;
+class NetworkMessageBatch;
 class ThresholdSignature;
 class StubClient;
 class ECP;
 
+namespace libff {
+    class alt_bn128_G1;
+    class alt_bn128_G2;
+}
+
 namespace CryptoPP {
     class ECP;
     template <class EC, class H> struct ECDSA;
 }
 
 class ECDSAVerify;
+class ECDSASigner;
+class BLSPublicKeyShare;
+class LagrangeCoeffsCache;
+class BLSSigCodec;
+class SGXECDSASignerThreadPool;
 
 class CryptoManager {
 
@@ -53,31 +64,59 @@ private:
 
     ptr<ECDSAVerify> ecdsaVerify;
 
+    ptr<ECDSASigner> ecdsaSigner;
+
+    ptr<SGXECDSASignerThreadPool> sgxSignerThreadPool;
+
 
     uint64_t  totalSigners;
     uint64_t  requiredSigners;
 
     bool sgxEnabled = false;
 
+    // signatures are hashes, used when neither SGX nor a local key is configured
+    bool mockupECDSA = true;
+
     ptr<string> sgxIP;
     ptr<string> sgxSSLKeyFileFullPath;
     ptr<string> sgxSSLCertFileFullPath;
     ptr<string> sgxECDSAKeyName;
     vector<ptr<string>> sgxECDSAPublicKeys;
 
-private:
+    // BLS public key shares of all nodes, sig shares are verified before merging only if they are set
+    vector<ptr<BLSPublicKeyShare>> blsPublicKeyShares;
+
+    ptr<LagrangeCoeffsCache> lagrangeCoeffsCache;
+
+    ptr<BLSSigCodec> blsSigCodec;
+
+    mutex compactBLSPeersLock;
+
+    // other peers that advertised they parse the compact encoding, used only once every peer has
+    set<schain_index> compactBLSPeers;
 
-    ptr<StubClient> sgxClient;
+    // merge first and check shares only if the merged signature does not verify
+    bool optimisticSigShareMerge = true;
 
+private:
 
     Schain* sChain = nullptr;
 
     ptr<string> signECDSA(ptr<SHAHash> _hash);
 
-    bool verifyECDSA(ptr<SHAHash> _hash, ptr<string> _sig);
+    bool verifyECDSA(ptr<SHAHash> _hash, ptr<string> _sig, schain_index _signerIndex);
 
     ptr<ThresholdSigShare> signSigShare(ptr<SHAHash> _hash, block_id _blockId);
 
+    ptr<ThresholdSignature> mergeAndVerifySigShares(ptr<SHAHash> _hash, block_id _blockId,
+                                                    const vector<ptr<ThresholdSigShare>> &_sigShares);
+
+    ptr<ThresholdSignature> searchSigShareSubsets(ptr<SHAHash> _hash, block_id _blockId,
+                                                  const vector<ptr<ThresholdSigShare>> &_sigShares,
+                                                  schain_index _latestSigner);
+
+    void checkThresholdSig(ptr<SHAHash> _hash, ptr<ThresholdSignature> _signature);
+
     //EC_KEY* ecdsaKey;
 
 
@@ -91,12 +130,52 @@ public:
 
     CryptoManager(Schain& sChain);
 
+    void startService();
+
+    void exit();
+
     Schain *getSchain() const;
 
     ptr<ThresholdSignature> verifyThresholdSig(ptr<SHAHash> _hash, ptr<string> _signature, block_id _blockId);
 
     ptr<ThresholdSigShareSet> createSigShareSet(block_id _blockId);
 
+    /**
+     * Records whether a peer advertised support for the compact BLS encoding in its messages
+     */
+    void peerBLSEncodingArrived(schain_index _peerIndex, bool _compact);
+
+    /**
+     * @return true if this node and every other peer parse the compact BLS encoding
+     */
+    bool isCompactBLSEncoding();
+
+    /**
+     * Verifies shares of different signers over the same hash as a batch,
+     * bisecting on failure to find the bad ones
+     * @return signer indices of the shares that did not verify
+     */
+    ptr<vector<schain_index>> verifySigShares(ptr<SHAHash> _hash, const vector<ptr<ThresholdSigShare>> &_sigShares);
+
+    /**
+     * Checks BLS shares of _hashPoint against the public key shares paired with them
+     * @return positions of the shares that did not verify
+     */
+    static vector<uint64_t> findBadBLSSigSharePositions(
+            const libff::alt_bn128_G1 &_hashPoint,
+            const vector<pair<ptr<libff::alt_bn128_G1>, ptr<libff::alt_bn128_G2>>> &_shares);
+
+    /**
+     * Merges a quorum out of _sigShares into a verified threshold signature.
+     * Without per-node BLS public keys bad shares can not be told apart, so quorums
+     * with the share of _latestSigner are tried instead
+     * @return nullptr if no signature verified. Signers of shares that did not verify are added to
+     * _badShares, if it stays empty the caller needs to wait for more shares
+     */
+    ptr<ThresholdSignature> mergeSigShares(ptr<SHAHash> _hash, block_id _blockId,
+                                           const vector<ptr<ThresholdSigShare>> &_sigShares,
+                                           vector<schain_index> &_badShares, schain_index _latestSigner = 0);
+
     ptr<ThresholdSigShare>
     createSigShare(ptr<string> _sigShare, schain_id _schainID, block_id _blockID, schain_index _signerIndex);
 
@@ -112,13 +191,19 @@ public:
 
     ptr<string> signNetworkMsg(NetworkMessage& _msg);
 
+    future<ptr<string>> signNetworkMsgAsync(NetworkMessage& _msg);
+
     bool verifyNetworkMsg(NetworkMessage &_msg);
 
+    future<ptr<string>> signNetworkMsgBatchAsync(NetworkMessageBatch &_batch);
+
+    bool verifyNetworkMsgBatch(NetworkMessageBatch &_batch);
+
     static ptr<void> decodeSGXPublicKey(ptr<string> _keyHex);
     static pair<ptr<string>, ptr<string>> generateSGXECDSAKey(ptr<StubClient> _c);
     static void generateSSLClientCertAndKey(string &_fullPathToDir);
     static void setSGXKeyAndCert(string &_keyFullPath, string &_certFullPath);
-    ptr<string> sgxSignECDSA(ptr<SHAHash> _hash, string& _keyName,  ptr<StubClient> _sgxClient);
+    static ptr<string> sgxSignECDSA(ptr<SHAHash> _hash, string& _keyName,  ptr<StubClient> _sgxClient);
     void sgxVerifyECDSA(ptr<SHAHash> _hash, ptr<string> _publicKey, ptr<string> _sig);
 
 };
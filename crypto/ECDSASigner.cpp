@@ -0,0 +1,40 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ECDSASigner.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+
+#include "ECDSASigner.h"
+
+
+future<ptr<string>> ECDSASigner::signAsync(ptr<SHAHash> _hash) {
+    promise<ptr<string>> result;
+    try {
+        result.set_value(sign(_hash));
+    } catch (...) {
+        result.set_exception(current_exception());
+    }
+    return result.get_future();
+}
+
+
+ECDSASigner::~ECDSASigner() {}
@@ -0,0 +1,52 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ECDSASigner.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_ECDSASIGNER_H
+#define SKALED_ECDSASIGNER_H
+
+
+class SHAHash;
+
+/**
+ * Backend that produces ECDSA signatures of consensus messages and proposals.
+ * Signatures are returned as "v:r:s" hex strings.
+ */
+class ECDSASigner {
+
+public:
+
+    virtual ptr<string> sign(ptr<SHAHash> _hash) = 0;
+
+    /**
+     * Starts signing without waiting for the signature. Backends that can not
+     * sign asynchronously return an already completed future.
+     */
+    virtual future<ptr<string>> signAsync(ptr<SHAHash> _hash);
+
+    virtual ptr<string> getName() = 0;
+
+    virtual ~ECDSASigner();
+};
+
+
+#endif //SKALED_ECDSASIGNER_H
@@ -6,445 +6,553 @@
 
 
 #include <gmp.h>
-#include <stdbool.h>
 #include "SkaleCommon.h"
 #include "Log.h"
 #include "SHAHash.h"
 #include "ECDSAVerify.h"
 
-/*Verify the integrity of a message using it's signature*/
 
+// p = 2^256 - P_C
+static const unsigned long P_C = 0x1000003D1;
 
 
-
-
-/*Set a point from another point*/
-void ECDSAVerify::point_set(point R, point P)
-{
-    //Copy the point
-    mpz_set(R->x, P->x);
-    mpz_set(R->y, P->y);
-    //Including infinity settings
-    R->infinity = P->infinity;
+AffinePoint::AffinePoint() {
+    mpz_init2(x, 256);
+    mpz_init2(y, 256);
 }
 
+AffinePoint::~AffinePoint() {
+    mpz_clear(x);
+    mpz_clear(y);
+}
 
-/*Make R a copy of P*/
+JacobianPoint::JacobianPoint() {
+    mpz_init2(x, 320);
+    mpz_init2(y, 320);
+    mpz_init2(z, 320);
+}
 
-void ECDSAVerify::point_copy(point R, point P)
-{
-    //Same as point set
-    point_set(R, P);
+JacobianPoint::~JacobianPoint() {
+    mpz_clear(x);
+    mpz_clear(y);
+    mpz_clear(z);
 }
 
+ECDSAPublicKey::ECDSAPublicKey(uint64_t _tableSize) : table(_tableSize), lambdaTable(_tableSize) {}
 
-/*Release point*/
-void ECDSAVerify::point_clear(point p)
-{
-    mpz_clear(p->x);
-    mpz_clear(p->y);
-    free(p);
+ECDSAScratch::ECDSAScratch() {
+    for (uint64_t i = 0; i < SIZE; i++)
+        mpz_init2(t[i], 640);
 }
 
-/*Set point to be a infinity*/
-void ECDSAVerify::point_at_infinity(point p)
-{
-    p->infinity = true;
+ECDSAScratch::~ECDSAScratch() {
+    for (uint64_t i = 0; i < SIZE; i++)
+        mpz_clear(t[i]);
 }
 
-/*Initialize a point*/
-point ECDSAVerify::point_init()
-{
-    point p;
-    p = (point) calloc(sizeof(struct point_s), 1);
-    mpz_init(p->x);
-    mpz_init(p->y);
-    p->infinity = false;
-    return p;
-}
 
+ptr<vector<AffinePoint>> ECDSAVerify::gTable = nullptr;
 
+once_flag ECDSAVerify::gTableOnce;
 
-void ECDSAVerify::number_theory_inverse(mpz_t R, mpz_t A, mpz_t P) {
-    mpz_invert(R, A, P);
-}
 
+ECDSAVerify::ECDSAVerify() {
+    mpz_init_set_str(p, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F", 16);
+    mpz_init_set_str(n, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141", 16);
+    mpz_init_set_str(gx, "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", 16);
+    mpz_init_set_str(gy, "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", 16);
+
+    // lambda * (x, y) = (beta * x, y)
+    mpz_init_set_str(beta, "7AE96A2B657C07106E64479EAC3434E99CF0497512F58995C1396C28719501EE", 16);
+    mpz_init_set_str(lambda, "5363AD4CC05C30E0A5261C028812645A122E22EA20816678DF02967C1B23BD72", 16);
+
+    // short basis of the lattice used to split scalars, (a1, b1) and (a2, b2)
+    mpz_init_set_str(a1, "3086D221A7D46BCDE86C90E49284EB15", 16);
+    mpz_init_set_str(minusB1, "E4437ED6010E88286F547FA90ABFE4C3", 16);
+    mpz_init_set_str(a2, "114CA50F7A8E2F3F657C1108D9D44CFD8", 16);
+    mpz_init_set_str(b2, "3086D221A7D46BCDE86C90E49284EB15", 16);
+
+    call_once(gTableOnce, [this]() { computeGTable(); });
+}
 
-void ECDSAVerify::number_theory_exp_modp_ui(mpz_t R, mpz_t a, unsigned long int k, mpz_t P) {
-    //Do this using gmp number theory implementation
-    mpz_powm_ui(R, a, k, P);
+ECDSAVerify::~ECDSAVerify() {
+    mpz_clear(p);
+    mpz_clear(n);
+    mpz_clear(gx);
+    mpz_clear(gy);
+    mpz_clear(beta);
+    mpz_clear(lambda);
+    mpz_clear(a1);
+    mpz_clear(minusB1);
+    mpz_clear(a2);
+    mpz_clear(b2);
 }
 
 
-/*Set point R = 2P*/
-void ECDSAVerify::point_doubling(point R, point P, domain_parameters curve)
-{
-    //If at infinity
-    if(P->infinity)
-    {
-        R->infinity = true;
-    }else{
-        //Initialize slope variable
-
-        //Initialize temporary variables
-        mpz_t s, t1, t2, t3, t4, t5;
-        mpz_init(s); mpz_init(t1); mpz_init(t2); mpz_init(t3); mpz_init(t4); mpz_init(t5);
-
-        //Calculate slope
-        //s = (3*Px² + a) / (2*Py) mod p
-        number_theory_exp_modp_ui(t1, P->x, 2, curve->p);	//t1 = Px² mod p
-        mpz_mul_ui(t2, t1, 3);				//t2 = 3 * t1
-        mpz_mod(t3, t2, curve->p);			//t3 = t2 mod p
-        mpz_add(t4, t3, curve->a);			//t4 = t3 + a
-        mpz_mod(t5, t4, curve->p);			//t5 = t4 mod p
-
-        mpz_mul_ui(t1, P->y, 2);			//t1 = 2*Py
-        number_theory_inverse(t2, t1, curve->p);		//t2 = t1^-1 mod p
-        mpz_mul(t1, t5, t2);				//t1 = t5 * t2
-        mpz_mod(s, t1, curve->p);			//s = t1 mod p
-
-        //Calculate Rx
-        //Rx = s² - 2*Px mod p
-        number_theory_exp_modp_ui(t1, s, 2, curve->p);//t1 = s² mod p
-        mpz_mul_ui(t2, P->x, 2);		//t2 = Px*2
-        mpz_mod(t3, t2, curve->p);		//t3 = t2 mod p
-        mpz_sub(t4, t1, t3);			//t4 = t1 - t3
-        mpz_mod(R->x, t4, curve->p);	//Rx = t4 mod p
-
-        //Calculate Ry using algorithm shown to the right of the commands
-        //Ry = s(Px-Rx) - Py mod p
-        mpz_sub(t1, P->x, R->x);			//t1 = Px - Rx
-        mpz_mul(t2, s, t1);					//t2 = s*t1
-        mpz_sub(t3, t2, P->y);				//t3 = t2 - Py
-        mpz_mod(R->y, t3, curve->p);	//Ry = t3 mod p
-
-        //Clear variables, release memory
-        mpz_clear(t1); mpz_clear(t2); mpz_clear(t3); mpz_clear(t4); mpz_clear(t5); mpz_clear(s);
+/* r = r mod p for 0 <= r, using p = 2^256 - P_C instead of a division */
+void ECDSAVerify::reduce(mpz_t _r, mpz_t _tmp) {
+    while (mpz_sizeinbase(_r, 2) > 256) {
+        mpz_tdiv_q_2exp(_tmp, _r, 256);
+        mpz_tdiv_r_2exp(_r, _r, 256);
+        mpz_addmul_ui(_r, _tmp, P_C);
     }
+    if (mpz_cmp(_r, p) >= 0)
+        mpz_sub(_r, _r, p);
 }
 
-/*Compare two points return 1 if not the same, returns 0 if they are the same*/
+void ECDSAVerify::mulMod(mpz_t _r, const mpz_t _a, const mpz_t _b, mpz_t _tmp) {
+    mpz_mul(_r, _a, _b);
+    reduce(_r, _tmp);
+}
 
-bool ECDSAVerify::point_cmp(point P, point Q)
-{
-    //If at infinity
-    if(P->infinity && Q->infinity)
-        return true;
-    else if(P->infinity || Q->infinity)
-        return false;
-    else
-        return !mpz_cmp(P->x,Q->x) && !mpz_cmp(P->y,Q->y);
+/* r = a - b mod p for a, b in [0, p) */
+void ECDSAVerify::subMod(mpz_t _r, const mpz_t _a, const mpz_t _b) {
+    mpz_sub(_r, _a, _b);
+    if (mpz_sgn(_r) < 0)
+        mpz_add(_r, _r, p);
 }
 
 
-/*Set R to the additive inverse of P, in the curve curve*/
-void ECDSAVerify::point_inverse(point R, point P, domain_parameters curve)
-{
-    //If at infinity
-    if(P->infinity)
-    {
-        R->infinity = true;
-    }else{
-        //Set Rx = Px
-        mpz_set(R->x, P->x);
+/* P = 2P, dbl-2009-l for a = 0 */
+void ECDSAVerify::pointDouble(JacobianPoint &_p, ECDSAScratch &_s) {
+
+    if (mpz_sgn(_p.z) == 0)
+        return;
+
+    auto &A = _s.t[0];
+    auto &B = _s.t[1];
+    auto &C = _s.t[2];
+    auto &D = _s.t[3];
+    auto &E = _s.t[4];
+    auto &F = _s.t[5];
+    auto &tmp = _s.t[11];
+
+    mulMod(A, _p.x, _p.x, tmp);
+    mulMod(B, _p.y, _p.y, tmp);
+    mulMod(C, B, B, tmp);
+
+    // D = 2 * ((X + B)^2 - A - C)
+    mpz_add(D, _p.x, B);
+    mulMod(D, D, D, tmp);
+    subMod(D, D, A);
+    subMod(D, D, C);
+    mpz_mul_2exp(D, D, 1);
+    reduce(D, tmp);
+
+    mpz_mul_ui(E, A, 3);
+    reduce(E, tmp);
+    mulMod(F, E, E, tmp);
+
+    // Z3 = 2 * Y * Z
+    mulMod(_p.z, _p.y, _p.z, tmp);
+    mpz_mul_2exp(_p.z, _p.z, 1);
+    reduce(_p.z, tmp);
+
+    // X3 = F - 2 * D
+    mpz_mul_2exp(A, D, 1);
+    reduce(A, tmp);
+    subMod(_p.x, F, A);
+
+    // Y3 = E * (D - X3) - 8 * C
+    subMod(D, D, _p.x);
+    mulMod(_p.y, E, D, tmp);
+    mpz_mul_2exp(C, C, 3);
+    reduce(C, tmp);
+    subMod(_p.y, _p.y, C);
+}
 
-        //Set Ry = -Py mod p = p - Ry (Since, Ry < p and Ry is positive)
-        mpz_sub(R->y, curve->p, P->y);
+
+/* P = P + Q or P = P - Q, madd-2007-bl */
+void ECDSAVerify::pointAddAffine(JacobianPoint &_p, const AffinePoint &_q, bool _negate, ECDSAScratch &_s) {
+
+    auto &qy = _s.t[0];
+    auto &Z1Z1 = _s.t[1];
+    auto &U2 = _s.t[2];
+    auto &S2 = _s.t[3];
+    auto &H = _s.t[4];
+    auto &R = _s.t[5];
+    auto &HH = _s.t[6];
+    auto &I = _s.t[7];
+    auto &J = _s.t[8];
+    auto &V = _s.t[9];
+    auto &tmp = _s.t[11];
+
+    if (_negate) {
+        mpz_sub(qy, p, _q.y);
+    } else {
+        mpz_set(qy, _q.y);
     }
-}
 
-/*Addition of point P + Q = result*/
-void ECDSAVerify::point_addition(point result, point P, point Q, domain_parameters curve)
-{
-    //If Q is at infinity, set result to P
-    if(Q->infinity)
-    {
-        point_set(result, P);
+    if (mpz_sgn(_p.z) == 0) {
+        mpz_set(_p.x, _q.x);
+        mpz_set(_p.y, qy);
+        mpz_set_ui(_p.z, 1);
+        return;
+    }
 
-        //If P is at infinity set result to be Q
-    }else if(P->infinity){
-        point_set(result, Q);
+    mulMod(Z1Z1, _p.z, _p.z, tmp);
+    mulMod(U2, _q.x, Z1Z1, tmp);
+    mulMod(S2, qy, _p.z, tmp);
+    mulMod(S2, S2, Z1Z1, tmp);
 
-        //If the points are the same use point doubling
-    }else if(point_cmp(P,Q))
-    {
-        point_doubling(result, Q, curve);
-    }else{
-        //Calculate the inverse point
-        point iQ = point_init();
-        point_inverse(iQ, Q, curve);
-        bool is_inverse = point_cmp(iQ,P);
-        point_clear(iQ);
-
-        //If it is the inverse
-        if(is_inverse)
-        {
-            //result must be point at infinity
-            point_at_infinity(result);
-        }else{
-            //Initialize slope variable
-            mpz_t s;mpz_init(s);
-            //Initialize temporary variables
-            mpz_t t1, t2, t3, t4, t5 ;
-            mpz_init(t1); mpz_init(t2); mpz_init(t3); mpz_init(t4);  mpz_init(t5);
-            /*
-            Modulo algebra rules:
-            (b1 + b2) mod  n = (b2 mod n) + (b1 mod n) mod n
-            (b1 * b2) mod  n = (b2 mod n) * (b1 mod n) mod n
-            */
-
-            //Calculate slope
-            //s = (Py - Qy)/(Px-Qx) mod p
-            mpz_sub(t1, P->y, Q->y);
-            mpz_sub(t2, P->x, Q->x);
-            //Using Modulo to stay within the group!
-            number_theory_inverse(t3, t2, curve->p); //Handle errors
-            mpz_mul(t4, t1, t3);
-            mpz_mod(s, t4, curve->p);
-
-            //Calculate Rx using algorithm shown to the right of the commands
-            //Rx = s² - Px - Qx = (s² mod p) - (Px mod p) - (Qx mod p) mod p
-            number_theory_exp_modp_ui(t1, s, 2, curve->p);	//t1 = s² mod p
-            mpz_mod(t2, P->x, curve->p);		//t2 = Px mod p
-            mpz_mod(t3, Q->x, curve->p);		//t3 = Qx mod p
-            mpz_sub(t4, t1, t2);				//t4 = t1 - t2
-            mpz_sub(t5, t4, t3);				//t5 = t4 - t3
-            mpz_mod(result->x, t5, curve->p);	//R->x = t5 mod p
-
-            //Calculate Ry using algorithm shown to the right of the commands
-            //Ry = s(Px-Rx) - Py mod p
-            mpz_sub(t1, P->x, result->x);		//t1 = Px - Rx
-            mpz_mul(t2, s, t1);					//t2 = s*t1
-            mpz_sub(t3, t2, P->y);				//t3 = t2 - Py
-            mpz_mod(result->y, t3, curve->p);	//Ry = t3 mod p
-
-            //Clear variables, release memory
-            mpz_clear(t1);mpz_clear(t2); mpz_clear(t3); mpz_clear(t4); mpz_clear(t5); mpz_clear(s);
+    subMod(H, U2, _p.x);
+    subMod(R, S2, _p.y);
+
+    if (mpz_sgn(H) == 0) {
+        if (mpz_sgn(R) == 0) {
+            pointDouble(_p, _s);
+        } else {
+            mpz_set_ui(_p.z, 0);
         }
+        return;
     }
+
+    mpz_mul_2exp(R, R, 1);
+    reduce(R, tmp);
+
+    mulMod(HH, H, H, tmp);
+    mpz_mul_2exp(I, HH, 2);
+    reduce(I, tmp);
+    mulMod(J, H, I, tmp);
+    mulMod(V, _p.x, I, tmp);
+
+    // 2 * Y1 * J, before Y1 is overwritten
+    mulMod(S2, _p.y, J, tmp);
+    mpz_mul_2exp(S2, S2, 1);
+    reduce(S2, tmp);
+
+    // Z3 = (Z1 + H)^2 - Z1Z1 - HH
+    mpz_add(_p.z, _p.z, H);
+    mulMod(_p.z, _p.z, _p.z, tmp);
+    subMod(_p.z, _p.z, Z1Z1);
+    subMod(_p.z, _p.z, HH);
+
+    // X3 = r^2 - J - 2 * V
+    mulMod(_p.x, R, R, tmp);
+    subMod(_p.x, _p.x, J);
+    subMod(_p.x, _p.x, V);
+    subMod(_p.x, _p.x, V);
+
+    // Y3 = r * (V - X3) - 2 * Y1 * J
+    subMod(V, V, _p.x);
+    mulMod(_p.y, R, V, tmp);
+    subMod(_p.y, _p.y, S2);
 }
 
-/*Perform scalar multiplication to P, with the factor multiplier, over the curve curve*/
-void ECDSAVerify::point_multiplication(point R, mpz_t multiplier, point P, domain_parameters curve)
-{
-    //If at infinity R is also at infinity
-    if(P->infinity)
-    {
-        R->infinity = true;
-    }else{
-        //Initializing variables
-        point x = point_init();
-        point_copy(x, P);
-        point t = point_init();
-        point_copy(t, x);
-
-        //Set R = point at infinity
-        point_at_infinity(R);
-
-/*
-Loops through the integer bit per bit, if a bit is 1 then x is added to the result. Looping through the multiplier in this manner allows us to use as many point doubling operations as possible. No reason to say 5P=P+P+P+P+P, when you might as well just use 5P=2(2P)+P.
-This is not the most effecient method of point multiplication, but it's faster than P+P+P+... which is not computational feasiable.
-*/
-        uint64_t bits = mpz_sizeinbase(multiplier, 2);
-        uint64_t bit = 0;
-        while(bit <= bits)
-        {
-            if(mpz_tstbit(multiplier, bit))
-            {
-                point_addition(t, x, R, curve);
-                point_copy(R, t);
-            }
-            point_doubling(t, x, curve);
-            point_copy(x, t);
-            bit++;
-        }
 
-        //Release temporary variables
-        point_clear(x);
-        point_clear(t);
-    }
-}
+void ECDSAVerify::toAffine(AffinePoint &_r, const JacobianPoint &_p, ECDSAScratch &_s) {
 
+    CHECK_STATE(mpz_sgn(_p.z) != 0);
 
-/*Initialize a signature*/
-signature ECDSAVerify::signature_init() {
-    signature sig;
-    sig = (signature) calloc(sizeof(struct signature_s), 1);
-    mpz_init(sig->r);
-    mpz_init(sig->s);
-    sig->v = 0;
-    return sig;
-}
+    auto &zInv = _s.t[0];
+    auto &zInv2 = _s.t[1];
+    auto &tmp = _s.t[11];
 
-/*Set signature from hexadecimal strings*/
-void ECDSAVerify::signature_set_hex(signature sig, char* v, char *r, char *s) {
-    mpz_set_str(sig->r, r, 16);
-    mpz_set_str(sig->s, s, 16);
-    sig->v = std::strtoul(v, 0, 16);
+    CHECK_STATE(mpz_invert(zInv, _p.z, p) != 0);
+    mulMod(zInv2, zInv, zInv, tmp);
+    mulMod(_r.x, _p.x, zInv2, tmp);
+    mulMod(zInv2, zInv2, zInv, tmp);
+    mulMod(_r.y, _p.y, zInv2, tmp);
 }
 
-void ECDSAVerify::signature_verify(ptr<SHAHash> hash, ptr<string> publicKeyHex, ptr<string> sigStr) {
 
-    bool result = false;
+/* gTable[i * G_WINDOW_SIZE + j - 1] = j * 2^(G_WINDOW_BITS * i) * G */
+void ECDSAVerify::computeGTable() {
 
-    CHECK_ARGUMENT(publicKeyHex);
-    CHECK_ARGUMENT(sigStr);
-    CHECK_ARGUMENT(sigStr->size() > 10);
-    cerr << *publicKeyHex<< endl;
-    CHECK_ARGUMENT(publicKeyHex->size() == 2 * 64);
+    auto table = make_shared<vector<AffinePoint>>(G_WINDOWS * G_WINDOW_SIZE);
 
-    signature sig = signature_init();
+    ECDSAScratch s;
+    AffinePoint base;
+    JacobianPoint acc;
 
-    auto firstColon = sigStr->find(":");
-    cerr << firstColon;
-    CHECK_STATE(firstColon == 1);
-    auto secondColon = sigStr->find(":", 2);
-    CHECK_STATE(secondColon != string::npos);
+    mpz_set(base.x, gx);
+    mpz_set(base.y, gy);
 
-    auto vStr = sigStr->substr(0, 1);
-    auto rStr = sigStr->substr(2, secondColon - 1);
-    auto sStr = sigStr->substr(secondColon + 1);
+    for (uint64_t i = 0; i < G_WINDOWS; i++) {
 
-    signature_set_hex(sig, (char*) vStr.c_str(), (char*) rStr.c_str(), (char*) sStr.c_str());
+        mpz_set_ui(acc.z, 0);
 
+        for (uint64_t j = 1; j <= G_WINDOW_SIZE; j++) {
+            pointAddAffine(acc, base, false, s);
+            toAffine(table->at(i * G_WINDOW_SIZE + j - 1), acc, s);
+        }
 
-    mpz_t message;
-    mpz_init(message);
-    auto hashHex = hash->toHex();
-    if (mpz_set_str(message, hashHex->c_str(), 16) == -1) {
-        mpz_clear(message);
-        CHECK_STATE2(false, "mpz_set_str(hashHex) failed");
+        // base of the next window is 2^G_WINDOW_BITS times the current base
+        pointAddAffine(acc, base, false, s);
+        toAffine(base, acc, s);
     }
 
+    gTable = table;
+}
 
-    auto pKeyXStr = publicKeyHex->substr(0, 64);
-    auto pKeyYStr = publicKeyHex->substr(64);
 
-    auto public_key = point_init();
-    point_set_hex(public_key, (char*) pKeyXStr.c_str(), (char*) pKeyYStr.c_str());
+/* k = k1 + k2 * lambda mod n with |k1|, |k2| < 2^129 */
+void ECDSAVerify::splitScalar(mpz_t _k1, mpz_t _k2, const mpz_t _k, ECDSAScratch &_s) {
 
+    auto &c1 = _s.t[0];
+    auto &c2 = _s.t[1];
+    auto &halfN = _s.t[2];
+    auto &tmp = _s.t[3];
 
-    //Initialize variables
-    mpz_t one, w, u1, u2, t, tt2;
-    mpz_init(one); mpz_init(w); mpz_init(u1);
-    mpz_init(u2); mpz_init(t); mpz_init(tt2);
+    mpz_tdiv_q_2exp(halfN, n, 1);
 
-    mpz_set_ui(one, 1);
+    // c1 = round(b2 * k / n), c2 = round(-b1 * k / n)
+    mpz_mul(c1, b2, _k);
+    mpz_add(c1, c1, halfN);
+    mpz_fdiv_q(c1, c1, n);
 
-    point x = point_init();
-    point t1 = point_init();
-    point t2 = point_init();
+    mpz_mul(c2, minusB1, _k);
+    mpz_add(c2, c2, halfN);
+    mpz_fdiv_q(c2, c2, n);
 
-    CHECK_STATE(curve != nullptr);
-    CHECK_STATE(sig != nullptr);
+    // k1 = k - c1 * a1 - c2 * a2
+    mpz_set(_k1, _k);
+    mpz_mul(tmp, c1, a1);
+    mpz_sub(_k1, _k1, tmp);
+    mpz_mul(tmp, c2, a2);
+    mpz_sub(_k1, _k1, tmp);
 
+    // k2 = -c1 * b1 - c2 * b2
+    mpz_mul(_k2, c1, minusB1);
+    mpz_mul(tmp, c2, b2);
+    mpz_sub(_k2, _k2, tmp);
+}
 
-    if (mpz_cmp(sig->r, one) < 0 &&
-        mpz_cmp(curve->n, sig->r) <= 0 &&
-        mpz_cmp(sig->s, one) < 0 &&
-        mpz_cmp(curve->n, sig->s) <= 0) {
-        goto clean;
+
+/* width-WNAF_WIDTH NAF of |k|, least significant digit first, returns the number of digits */
+uint64_t ECDSAVerify::computeWNAF(int8_t *_digits, const mpz_t _k) {
+
+    mpz_t k;
+    mpz_init(k);
+    mpz_abs(k, _k);
+
+    uint64_t length = 0;
+
+    while (mpz_sgn(k) != 0) {
+        int64_t digit = 0;
+        if (mpz_odd_p(k)) {
+            digit = (int64_t) mpz_fdiv_ui(k, 1 << WNAF_WIDTH);
+            if (digit >= (1 << (WNAF_WIDTH - 1)))
+                digit -= (1 << WNAF_WIDTH);
+            if (digit > 0) {
+                mpz_sub_ui(k, k, (unsigned long) digit);
+            } else {
+                mpz_add_ui(k, k, (unsigned long) -digit);
+            }
+        }
+        _digits[length++] = (int8_t) digit;
+        mpz_tdiv_q_2exp(k, k, 1);
     }
 
-    //w = s¯¹ mod n
-    number_theory_inverse(w, sig->s, curve->n);
+    mpz_clear(k);
 
-    //u1 = message * w mod n
-    mpz_mod(tt2, message, curve->n);
-    mpz_mul(t, tt2, w);
-    mpz_mod(u1, t, curve->n);
+    return length;
+}
 
-    //u2 = r*w mod n
-    mpz_mul(t, sig->r, w);
-    mpz_mod(u2, t, curve->n);
 
-    //x = u1*G+u2*Q
-    point_multiplication(t1, u1, curve->G, curve);
-    point_multiplication(t2, u2, public_key, curve);
-    point_addition(x, t1, t2, curve);
+ptr<ECDSAPublicKey> ECDSAVerify::decodePublicKey(ptr<string> _publicKeyHex) {
 
-    //Get the result, by comparing x value with r and verifying that x is NOT at infinity
+    CHECK_ARGUMENT(_publicKeyHex != nullptr);
+    CHECK_ARGUMENT2(_publicKeyHex->size() == 2 * 64, "Incorrect ECDSA public key length");
 
-    result = mpz_cmp(sig->r, x->x) == 0 && !x->infinity;
+    auto key = make_shared<ECDSAPublicKey>(WNAF_TABLE_SIZE);
 
-    clean:
+    ECDSAScratch s;
+    AffinePoint q;
+    AffinePoint q2;
+    JacobianPoint acc;
 
-    point_clear(public_key);
-    point_clear(x);
-    point_clear(t1);
-    point_clear(t2);
+    CHECK_ARGUMENT2(mpz_set_str(q.x, _publicKeyHex->substr(0, 64).c_str(), 16) == 0 &&
+                    mpz_set_str(q.y, _publicKeyHex->substr(64).c_str(), 16) == 0,
+                    "ECDSA public key is not hex");
 
-    mpz_clear(one); mpz_clear(w); mpz_clear(u1); mpz_clear(u2); mpz_clear(t);
-    mpz_clear(tt2); mpz_clear(message);
+    CHECK_ARGUMENT2(mpz_cmp(q.x, p) < 0 && mpz_cmp(q.y, p) < 0, "ECDSA public key is out of range");
 
-    CHECK_STATE2(result, "Incorrect ECDSA signature");
-}
+    // y^2 = x^3 + 7
+    auto &lhs = s.t[5];
+    auto &rhs = s.t[6];
+    auto &tmp = s.t[11];
+    mulMod(lhs, q.y, q.y, tmp);
+    mulMod(rhs, q.x, q.x, tmp);
+    mulMod(rhs, rhs, q.x, tmp);
+    mpz_add_ui(rhs, rhs, 7);
+    reduce(rhs, tmp);
+    CHECK_ARGUMENT2(mpz_cmp(lhs, rhs) == 0, "ECDSA public key is not on secp256k1");
 
-/*Sets the name of a curve*/
-void ECDSAVerify::domain_parameters_set_name(domain_parameters curve, char* name)
-{
-    int len = strlen(name);
-    curve->name = (char*)calloc( sizeof(char) * (len+1), 1 );
-    curve->name[len] = '\0';
-    strncpy(curve->name, name, len+1);
-}
+    // table[i] = (2 * i + 1) * Q
+    mpz_set_ui(acc.z, 0);
+    pointAddAffine(acc, q, false, s);
+    pointDouble(acc, s);
+    toAffine(q2, acc, s);
+
+    mpz_set(key->table.at(0).x, q.x);
+    mpz_set(key->table.at(0).y, q.y);
+
+    mpz_set_ui(acc.z, 0);
+    pointAddAffine(acc, q, false, s);
 
+    for (uint64_t i = 1; i < WNAF_TABLE_SIZE; i++) {
+        pointAddAffine(acc, q2, false, s);
+        toAffine(key->table.at(i), acc, s);
+    }
+
+    for (uint64_t i = 0; i < WNAF_TABLE_SIZE; i++) {
+        mulMod(key->lambdaTable.at(i).x, key->table.at(i).x, beta, tmp);
+        mpz_set(key->lambdaTable.at(i).y, key->table.at(i).y);
+    }
 
-/*Set point from strings of a base from 2-62*/
-void ECDSAVerify::point_set_str(point p, char *x, char *y, int base)
-{
-    mpz_set_str(p->x, x, base);
-    mpz_set_str(p->y, y, base);
+    return key;
 }
 
 
-/*Set point from hexadecimal strings*/
-void ECDSAVerify::point_set_hex(point p, char *x, char *y)
-{
-    point_set_str(p,x,y,16);
+void ECDSAVerify::addPublicKey(schain_index _index, ptr<string> _publicKeyHex) {
+    auto key = decodePublicKey(_publicKeyHex);
+    unique_lock<shared_mutex> lock(publicKeysLock);
+    publicKeys[(uint64_t) _index] = key;
 }
 
-/*Set domain parameters from hexadecimal string*/
-void ECDSAVerify::domain_parameters_set_hex(domain_parameters curve, char* name, char* p, char* a, char* b, char* Gx, char* Gy, char* n, char* h)
-{
-    domain_parameters_set_name(curve, name);
-    mpz_set_str(curve->p, p, 16);
-    mpz_set_str(curve->a, a, 16);
-    mpz_set_str(curve->b, b, 16);
-    point_set_hex(curve->G, Gx, Gy);
-    mpz_set_str(curve->n, n, 16);
-    mpz_set_str(curve->h, h, 16);
+bool ECDSAVerify::hasPublicKey(schain_index _index) {
+    shared_lock<shared_mutex> lock(publicKeysLock);
+    return publicKeys.count((uint64_t) _index) > 0;
 }
 
 
+bool ECDSAVerify::verify(ptr<SHAHash> _hash, ptr<string> _sig, schain_index _signerIndex) {
 
-/*Load a curve depending on it's curve number, defined by the enum*/
-void ECDSAVerify::domain_parameters_load_curve(domain_parameters out) {
-            domain_parameters_set_hex(out, (char*)"secp256k1", (char*)
-                                      "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F",
-                                      (char*)"0000000000000000000000000000000000000000000000000000000000000000",
-                                      (char*)"0000000000000000000000000000000000000000000000000000000000000007",
-                                      (char*)"79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798",
-                                      (char*)"483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8",
-                                      (char*)"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141",
-                                      (char*)"01");
+    ptr<ECDSAPublicKey> key;
+
+    {
+        shared_lock<shared_mutex> lock(publicKeysLock);
+        auto result = publicKeys.find((uint64_t) _signerIndex);
+        CHECK_STATE2(result != publicKeys.end(), "No ECDSA public key for node " + to_string(_signerIndex));
+        key = result->second;
+    }
+
+    return verify(_hash, _sig, key);
 }
 
 
-ECDSAVerify::ECDSAVerify() {
-    curve = domain_parameters_init();
-    domain_parameters_load_curve(curve);
+void ECDSAVerify::signature_verify(ptr<SHAHash> hash, ptr<string> publicKeyHex, ptr<string> sigStr) {
+    CHECK_STATE2(verify(hash, sigStr, decodePublicKey(publicKeyHex)), "Incorrect ECDSA signature");
 }
 
-/*Initialize a curve*/
-domain_parameters ECDSAVerify::domain_parameters_init()
-{
-    curve = (domain_parameters) calloc(sizeof(struct domain_parameters_s), 1);
-
-    //Initialize all members
-    mpz_init(curve->p); mpz_init(curve->a); mpz_init(curve->b);
-    curve->G = point_init();
-    mpz_init(curve->n);
-    mpz_init(curve->h);
-    return curve;
+
+bool ECDSAVerify::verify(ptr<SHAHash> _hash, ptr<string> _sig, ptr<ECDSAPublicKey> _publicKey) {
+
+    CHECK_ARGUMENT(_hash != nullptr);
+    CHECK_ARGUMENT(_sig != nullptr);
+    CHECK_ARGUMENT(_publicKey != nullptr);
+
+    // "v:r:s", v is the recovery id and is not needed to verify
+    auto firstColon = _sig->find(':');
+    if (firstColon == string::npos || firstColon == 0)
+        return false;
+    auto secondColon = _sig->find(':', firstColon + 1);
+    if (secondColon == string::npos)
+        return false;
+
+    auto rStr = _sig->substr(firstColon + 1, secondColon - firstColon - 1);
+    auto sStr = _sig->substr(secondColon + 1);
+
+    if (rStr.empty() || sStr.empty() || rStr.size() > 64 || sStr.size() > 64)
+        return false;
+
+    ECDSAScratch s;
+
+    mpz_t r, sig, z, u1, u2, k1, k2;
+    mpz_inits(r, sig, z, u1, u2, k1, k2, (mpz_ptr) 0);
+
+    bool result = false;
+
+    JacobianPoint acc;
+
+    int8_t digits1[260];
+    int8_t digits2[260];
+
+    uint8_t u1Bytes[32];
+    size_t u1Length = 0;
+
+    uint64_t length1, length2, length;
+
+    if (mpz_set_str(r, rStr.c_str(), 16) != 0 || mpz_set_str(sig, sStr.c_str(), 16) != 0)
+        goto clean;
+
+    if (mpz_sgn(r) <= 0 || mpz_cmp(r, n) >= 0 || mpz_sgn(sig) <= 0 || mpz_cmp(sig, n) >= 0)
+        goto clean;
+
+    // the hash is signed as is
+    mpz_import(z, SHA_HASH_LEN, 1, 1, 1, 0, _hash->data());
+    mpz_mod(z, z, n);
+
+    // u1 = z / s, u2 = r / s
+    CHECK_STATE(mpz_invert(u2, sig, n) != 0);
+    mpz_mul(u1, z, u2);
+    mpz_mod(u1, u1, n);
+    mpz_mul(u2, r, u2);
+    mpz_mod(u2, u2, n);
+
+    // u2 * Q = k1 * Q + k2 * lambda * Q
+    splitScalar(k1, k2, u2, s);
+
+    length1 = computeWNAF(digits1, k1);
+    length2 = computeWNAF(digits2, k2);
+    length = std::max(length1, length2);
+
+    mpz_set_ui(acc.z, 0);
+
+    for (uint64_t i = length; i-- > 0;) {
+
+        pointDouble(acc, s);
+
+        if (i < length1 && digits1[i] != 0) {
+            auto digit = digits1[i];
+            pointAddAffine(acc, _publicKey->table.at(std::abs(digit) >> 1),
+                           (digit < 0) != (mpz_sgn(k1) < 0), s);
+        }
+
+        if (i < length2 && digits2[i] != 0) {
+            auto digit = digits2[i];
+            pointAddAffine(acc, _publicKey->lambdaTable.at(std::abs(digit) >> 1),
+                           (digit < 0) != (mpz_sgn(k2) < 0), s);
+        }
+    }
+
+    // u1 * G from the table, one window per byte of u1
+    memset(u1Bytes, 0, sizeof(u1Bytes));
+    mpz_export(u1Bytes, &u1Length, -1, 1, 0, 0, u1);
+
+    for (uint64_t i = 0; i < u1Length; i++) {
+        if (u1Bytes[i] != 0)
+            pointAddAffine(acc, gTable->at(i * G_WINDOW_SIZE + u1Bytes[i] - 1), false, s);
+    }
+
+    if (mpz_sgn(acc.z) == 0)
+        goto clean;
+
+    {
+        // x(R) mod n == r, compared in Jacobian coordinates to avoid an inversion: X == r * Z^2
+        auto &zz = s.t[0];
+        auto &rzz = s.t[1];
+        auto &tmp = s.t[11];
+
+        mulMod(zz, acc.z, acc.z, tmp);
+        mulMod(rzz, r, zz, tmp);
+
+        if (mpz_cmp(rzz, acc.x) == 0) {
+            result = true;
+        } else {
+            // x(R) can be in [n, p)
+            mpz_add(r, r, n);
+            if (mpz_cmp(r, p) < 0) {
+                mulMod(rzz, r, zz, tmp);
+                result = mpz_cmp(rzz, acc.x) == 0;
+            }
+        }
+    }
+
+    clean:
+
+    mpz_clears(r, sig, z, u1, u2, k1, k2, (mpz_ptr) 0);
+
+    return result;
 }
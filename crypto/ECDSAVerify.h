@@ -6,71 +6,150 @@
 #define SKALED_ECDSAVERIFY_H
 
 
-typedef struct point_s* point;
-struct point_s
-{
+#include <gmp.h>
+
+
+class SHAHash;
+
+
+/* Affine point of a precomputed table */
+class AffinePoint {
+public:
     mpz_t x;
     mpz_t y;
-    bool infinity;
+
+    AffinePoint();
+
+    AffinePoint(const AffinePoint &) = delete;
+
+    AffinePoint &operator=(const AffinePoint &) = delete;
+
+    ~AffinePoint();
 };
 
-/*Type that represents a curve*/
-typedef struct domain_parameters_s* domain_parameters;
-struct domain_parameters_s
-{
-    char* name;
-    mpz_t p;	//Prime
-    mpz_t a;	//'a' parameter of the elliptic curve
-    mpz_t b;	//'b' parameter of the elliptic curve
-    point G;	//Generator point of the curve, also known as base point.
-    mpz_t n;
-    mpz_t h;
+
+/* Point in Jacobian coordinates (X / Z^2, Y / Z^3), Z == 0 is the point at infinity */
+class JacobianPoint {
+public:
+    mpz_t x;
+    mpz_t y;
+    mpz_t z;
+
+    JacobianPoint();
+
+    JacobianPoint(const JacobianPoint &) = delete;
+
+    JacobianPoint &operator=(const JacobianPoint &) = delete;
+
+    ~JacobianPoint();
+};
+
+
+/* Decoded public key with odd multiples of Q and of lambda * Q */
+class ECDSAPublicKey {
+public:
+    vector<AffinePoint> table;
+    vector<AffinePoint> lambdaTable;
+
+    explicit ECDSAPublicKey(uint64_t _tableSize);
 };
 
 
-/*Type for representing a signature*/
-struct signature_s
-{
-    mpz_t r;
-    mpz_t s;
-    unsigned int v;
+/* Temporaries of a single verification, so that the hot path does not allocate */
+class ECDSAScratch {
+public:
+    static constexpr uint64_t SIZE = 12;
+
+    mpz_t t[SIZE];
+
+    ECDSAScratch();
+
+    ECDSAScratch(const ECDSAScratch &) = delete;
+
+    ECDSAScratch &operator=(const ECDSAScratch &) = delete;
+
+    ~ECDSAScratch();
 };
 
-typedef struct signature_s* signature;
 
+/**
+ * secp256k1 ECDSA verification of "v:r:s" signatures.
+ *
+ * u1 * G is computed from a shared table of multiples of G (one addition per byte of u1, no doublings).
+ * u2 * Q is split with the GLV endomorphism into two 128 bit scalars that are multiplied together
+ * using width-5 NAF and odd multiples of Q and lambda * Q cached per node.
+ */
 class ECDSAVerify {
 
+    static constexpr uint64_t G_WINDOW_BITS = 8;
+    static constexpr uint64_t G_WINDOWS = 256 / G_WINDOW_BITS;
+    static constexpr uint64_t G_WINDOW_SIZE = (1 << G_WINDOW_BITS) - 1;
+
+    static constexpr uint64_t WNAF_WIDTH = 5;
+    static constexpr uint64_t WNAF_TABLE_SIZE = 1 << (WNAF_WIDTH - 2);
+
+    mpz_t p;
+    mpz_t n;
+    mpz_t gx;
+    mpz_t gy;
+    mpz_t beta;
+    mpz_t lambda;
+    mpz_t a1;
+    mpz_t minusB1;
+    mpz_t a2;
+    mpz_t b2;
+
+    static ptr<vector<AffinePoint>> gTable;
+
+    static once_flag gTableOnce;
+
+    shared_mutex publicKeysLock;
+
+    map<uint64_t, ptr<ECDSAPublicKey>> publicKeys;
+
+    void reduce(mpz_t _r, mpz_t _tmp);
+
+    void mulMod(mpz_t _r, const mpz_t _a, const mpz_t _b, mpz_t _tmp);
 
-    domain_parameters curve;
-
-    static void point_set(point R, point P);
-    static void point_copy(point R, point P);
-    static void point_clear(point p);
-    static void point_at_infinity(point p);
-    static point point_init();
-    static void number_theory_inverse(mpz_t R, mpz_t A, mpz_t P);
-    static void number_theory_exp_modp_ui(mpz_t R, mpz_t a, unsigned long int k, mpz_t P);
-    static void point_doubling(point R, point P, domain_parameters curve);
-    static bool point_cmp(point P, point Q);
-    static void point_inverse(point R, point P, domain_parameters curve);
-    static void point_addition(point result, point P, point Q, domain_parameters curve);
-    static void point_multiplication(point R, mpz_t multiplier, point P, domain_parameters curve);
-    static void domain_parameters_set_name(domain_parameters curve, char* name);
-    static void point_set_str(point p, char *x, char *y, int base);
-    static void point_set_hex(point p, char *x, char *y);
-    static void domain_parameters_set_hex(
-            domain_parameters curve, char* name, char* p, char* a, char* b, char* Gx, char* Gy, char* n, char* h);
-    static void domain_parameters_load_curve(domain_parameters out);
-
-        /*Initialize a curve*/
-    domain_parameters domain_parameters_init();
-    void signature_set_hex(signature sig, char* v, char *r, char *s);
+    void subMod(mpz_t _r, const mpz_t _a, const mpz_t _b);
+
+    void pointDouble(JacobianPoint &_p, ECDSAScratch &_s);
+
+    void pointAddAffine(JacobianPoint &_p, const AffinePoint &_q, bool _negate, ECDSAScratch &_s);
+
+    void toAffine(AffinePoint &_r, const JacobianPoint &_p, ECDSAScratch &_s);
+
+    void computeGTable();
+
+    void splitScalar(mpz_t _k1, mpz_t _k2, const mpz_t _k, ECDSAScratch &_s);
+
+    static uint64_t computeWNAF(int8_t *_digits, const mpz_t _k);
+
+    bool verify(ptr<SHAHash> _hash, ptr<string> _sig, ptr<ECDSAPublicKey> _publicKey);
 
 public:
 
     ECDSAVerify();
 
-    signature signature_init();
+    ~ECDSAVerify();
+
+    ptr<ECDSAPublicKey> decodePublicKey(ptr<string> _publicKeyHex);
+
+    /**
+     * Decodes and caches the public key of a node, has to be called before verify()
+     */
+    void addPublicKey(schain_index _index, ptr<string> _publicKeyHex);
+
+    bool hasPublicKey(schain_index _index);
+
+    /**
+     * @return true if the signature verifies with the cached public key of the node
+     */
+    bool verify(ptr<SHAHash> _hash, ptr<string> _sig, schain_index _signerIndex);
+
+    /**
+     * Verifies with a public key given as hex of x and y, throws if the signature does not verify
+     */
     void signature_verify(ptr<SHAHash> hash, ptr<string> publicKeyHex, ptr<string> sigStr);
 };
 
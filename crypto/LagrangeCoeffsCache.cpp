@@ -0,0 +1,83 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file LagrangeCoeffsCache.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "LagrangeCoeffsCache.h"
+
+
+LagrangeCoeffsCache::LagrangeCoeffsCache(uint64_t _totalSigners, uint64_t _requiredSigners, uint64_t _cacheSize)
+        : totalSigners(_totalSigners), requiredSigners(_requiredSigners), coeffs(_cacheSize) {
+    CHECK_ARGUMENT(_requiredSigners > 0 && _requiredSigners <= _totalSigners);
+    CHECK_ARGUMENT(_cacheSize > 0);
+}
+
+
+ptr<vector<libff::alt_bn128_Fr>> LagrangeCoeffsCache::getCoeffs(const vector<size_t> &_signerIndices) {
+
+    CHECK_ARGUMENT(_signerIndices.size() == requiredSigners);
+
+    signatures::Bls bls(requiredSigners, totalSigners);
+
+    // sets of committees larger than the mask are not cached
+    if (totalSigners > 64)
+        return make_shared<vector<libff::alt_bn128_Fr>>(bls.LagrangeCoeffs(_signerIndices));
+
+    uint64_t mask = 0;
+
+    for (auto &&index : _signerIndices) {
+        CHECK_ARGUMENT(index > 0 && index <= totalSigners);
+        mask |= ((uint64_t) 1) << (index - 1);
+    }
+
+    {
+        LOCK(m)
+        if (coeffs.exists(mask))
+            return coeffs.get(mask);
+    }
+
+    auto result = make_shared<vector<libff::alt_bn128_Fr>>(bls.LagrangeCoeffs(_signerIndices));
+
+    LOCK(m)
+    coeffs.put(mask, result);
+
+    return result;
+}
+
+
+libff::alt_bn128_G1 LagrangeCoeffsCache::combine(const vector<libff::alt_bn128_G1> &_shares,
+                                                 const vector<libff::alt_bn128_Fr> &_coeffs) {
+
+    CHECK_ARGUMENT(_shares.size() == _coeffs.size());
+    CHECK_ARGUMENT(!_shares.empty());
+
+    // Bos-Coster shares doublings between the scalars, which wins over separate multiplications
+    auto result = libff::multi_exp<libff::alt_bn128_G1, libff::alt_bn128_Fr, libff::multi_exp_method_bos_coster>(
+            _shares.cbegin(), _shares.cend(), _coeffs.cbegin(), _coeffs.cend(), 1);
+
+    result.to_affine_coordinates();
+
+    return result;
+}
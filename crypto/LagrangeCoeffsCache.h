@@ -0,0 +1,62 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file LagrangeCoeffsCache.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_LAGRANGECOEFFSCACHE_H
+#define SKALED_LAGRANGECOEFFSCACHE_H
+
+#include "thirdparty/lrucache.hpp"
+#include "bls_include.h"
+
+
+/**
+ * Lagrange coefficients of signer index sets, keyed by the bitmask of the set.
+ * A committee keeps merging the same few sets, so the field inversions are done once per set.
+ */
+class LagrangeCoeffsCache {
+
+    recursive_mutex m;
+
+    const uint64_t totalSigners;
+
+    const uint64_t requiredSigners;
+
+    cache::lru_cache<uint64_t, ptr<vector<libff::alt_bn128_Fr>>> coeffs;
+
+public:
+
+    LagrangeCoeffsCache(uint64_t _totalSigners, uint64_t _requiredSigners, uint64_t _cacheSize);
+
+    /**
+     * @param _signerIndices sorted 1-based indices of the signers
+     */
+    ptr<vector<libff::alt_bn128_Fr>> getCoeffs(const vector<size_t> &_signerIndices);
+
+    /**
+     * Combines signature shares with the coefficients of their signers as a single multi-scalar multiplication
+     */
+    static libff::alt_bn128_G1 combine(const vector<libff::alt_bn128_G1> &_shares,
+                                       const vector<libff::alt_bn128_Fr> &_coeffs);
+};
+
+
+#endif //SKALED_LAGRANGECOEFFSCACHE_H
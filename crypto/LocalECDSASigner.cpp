@@ -0,0 +1,256 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file LocalECDSASigner.cpp
+    @author agent
+    @date 2026
+*/
+
+#include <sys/stat.h>
+
+#include "openssl/bn.h"
+#include "openssl/ecdsa.h"
+#include "openssl/err.h"
+#include "openssl/obj_mac.h"
+#include "openssl/pem.h"
+
+#include "SkaleCommon.h"
+#include "Log.h"
+
+#include "network/Utils.h"
+#include "SHAHash.h"
+#include "LocalECDSASigner.h"
+
+
+using bn_ctx_ptr = unique_ptr<BN_CTX, decltype(&BN_CTX_free)>;
+using ec_point_ptr = unique_ptr<EC_POINT, decltype(&EC_POINT_free)>;
+using ecdsa_sig_ptr = unique_ptr<ECDSA_SIG, decltype(&ECDSA_SIG_free)>;
+
+
+LocalECDSASigner::LocalECDSASigner(const string &_keyFileFullPath) {
+
+    auto file = fopen(_keyFileFullPath.c_str(), "r");
+
+    CHECK_STATE2(file != nullptr, "Could not open ECDSA key file " + _keyFileFullPath);
+
+    key = PEM_read_ECPrivateKey(file, nullptr, nullptr, nullptr);
+
+    fclose(file);
+
+    CHECK_STATE2(key != nullptr, "Could not read ECDSA key from " + _keyFileFullPath);
+
+    if (EC_GROUP_get_curve_name(EC_KEY_get0_group(key)) != NID_secp256k1) {
+        EC_KEY_free(key);
+        key = nullptr;
+        CHECK_STATE2(false, "ECDSA key is not a secp256k1 key:" + _keyFileFullPath);
+    }
+
+    publicKey = encodePublicKey(key);
+}
+
+LocalECDSASigner::~LocalECDSASigner() {
+    if (key != nullptr)
+        EC_KEY_free(key);
+}
+
+
+ptr<string> LocalECDSASigner::sign(ptr<SHAHash> _hash) {
+
+    CHECK_ARGUMENT(_hash != nullptr);
+
+    // the hash is signed as is, the same way the SGX wallet does it
+    ecdsa_sig_ptr signature(ECDSA_do_sign(_hash->data(), SHA_HASH_LEN, key), ECDSA_SIG_free);
+    CHECK_STATE2(signature != nullptr, "ECDSA_do_sign failed");
+
+    const BIGNUM *r = nullptr;
+    const BIGNUM *s = nullptr;
+
+    ECDSA_SIG_get0(signature.get(), &r, &s);
+
+    CHECK_STATE(r != nullptr && s != nullptr);
+
+    bn_ctx_ptr ctx(BN_CTX_new(), BN_CTX_free);
+    CHECK_STATE(ctx != nullptr);
+
+    auto group = EC_KEY_get0_group(key);
+    auto order = EC_GROUP_get0_order(group);
+
+    BN_CTX_start(ctx.get());
+
+    auto lowS = BN_CTX_get(ctx.get());
+    auto halfOrder = BN_CTX_get(ctx.get());
+
+    CHECK_STATE(halfOrder != nullptr);
+
+    CHECK_STATE(BN_rshift1(halfOrder, order));
+
+    // low s form, as the SGX wallet returns it
+    if (BN_cmp(s, halfOrder) > 0) {
+        CHECK_STATE(BN_sub(lowS, order, s));
+    } else {
+        CHECK_STATE(BN_copy(lowS, s) != nullptr);
+    }
+
+    auto recoveryID = getRecoveryID(_hash, r, lowS, ctx.get());
+
+    uint8_t rBytes[32];
+    uint8_t sBytes[32];
+
+    CHECK_STATE(BN_bn2binpad(r, rBytes, sizeof(rBytes)) == sizeof(rBytes));
+    CHECK_STATE(BN_bn2binpad(lowS, sBytes, sizeof(sBytes)) == sizeof(sBytes));
+
+    BN_CTX_end(ctx.get());
+
+    return make_shared<string>(to_string(recoveryID) + ":" + *Utils::carray2Hex(rBytes, sizeof(rBytes)) + ":" +
+                               *Utils::carray2Hex(sBytes, sizeof(sBytes)));
+}
+
+
+uint32_t LocalECDSASigner::getRecoveryID(ptr<SHAHash> _hash, const BIGNUM *_r, const BIGNUM *_s, BN_CTX *_ctx) {
+
+    CHECK_ARGUMENT(_hash != nullptr);
+
+    // only public values are involved, so the variable time arithmetic does not leak the key
+    auto group = EC_KEY_get0_group(key);
+    auto order = EC_GROUP_get0_order(group);
+
+    ec_point_ptr rPoint(EC_POINT_new(group), EC_POINT_free);
+    ec_point_ptr recovered(EC_POINT_new(group), EC_POINT_free);
+    CHECK_STATE(rPoint != nullptr && recovered != nullptr);
+
+    BN_CTX_start(_ctx);
+
+    auto z = BN_CTX_get(_ctx);
+    auto rInv = BN_CTX_get(_ctx);
+    auto u1 = BN_CTX_get(_ctx);
+    auto u2 = BN_CTX_get(_ctx);
+    auto x = BN_CTX_get(_ctx);
+
+    CHECK_STATE(x != nullptr);
+
+    CHECK_STATE(BN_bin2bn(_hash->data(), SHA_HASH_LEN, z) != nullptr);
+    CHECK_STATE(BN_mod_inverse(rInv, _r, order, _ctx) != nullptr);
+
+    // Q = r^-1 * (s * R - z * G)
+    CHECK_STATE(BN_mod_mul(u1, z, rInv, order, _ctx));
+    CHECK_STATE(BN_sub(u1, order, u1));
+    CHECK_STATE(BN_nnmod(u1, u1, order, _ctx));
+    CHECK_STATE(BN_mod_mul(u2, _s, rInv, order, _ctx));
+
+    for (uint32_t recoveryID = 0; recoveryID < 4; recoveryID++) {
+
+        // R.x is r, or r + n for the rare R.x above the group order
+        CHECK_STATE(BN_copy(x, _r) != nullptr);
+
+        if (recoveryID & 2)
+            CHECK_STATE(BN_add(x, x, order));
+
+        if (!EC_POINT_set_compressed_coordinates_GFp(group, rPoint.get(), x, recoveryID & 1, _ctx)) {
+            ERR_clear_error();
+            continue;
+        }
+
+        CHECK_STATE(EC_POINT_mul(group, recovered.get(), u1, rPoint.get(), u2, _ctx));
+
+        if (EC_POINT_cmp(group, recovered.get(), EC_KEY_get0_public_key(key), _ctx) == 0) {
+            BN_CTX_end(_ctx);
+            return recoveryID;
+        }
+    }
+
+    BN_CTX_end(_ctx);
+
+    CHECK_STATE2(false, "Could not derive ECDSA recovery id");
+
+    return 0;
+}
+
+ptr<string> LocalECDSASigner::getName() {
+    return make_shared<string>("local");
+}
+
+ptr<string> LocalECDSASigner::getPublicKey() {
+    return publicKey;
+}
+
+
+ptr<string> LocalECDSASigner::encodePublicKey(EC_KEY *_key) {
+
+    CHECK_ARGUMENT(_key != nullptr);
+
+    bn_ctx_ptr ctx(BN_CTX_new(), BN_CTX_free);
+    CHECK_STATE(ctx != nullptr);
+
+    BN_CTX_start(ctx.get());
+
+    auto x = BN_CTX_get(ctx.get());
+    auto y = BN_CTX_get(ctx.get());
+
+    CHECK_STATE(y != nullptr);
+
+    CHECK_STATE(EC_POINT_get_affine_coordinates_GFp(EC_KEY_get0_group(_key), EC_KEY_get0_public_key(_key),
+                                                    x, y, ctx.get()));
+
+    uint8_t xy[64];
+
+    CHECK_STATE(BN_bn2binpad(x, xy, 32) == 32);
+    CHECK_STATE(BN_bn2binpad(y, xy + 32, 32) == 32);
+
+    BN_CTX_end(ctx.get());
+
+    return Utils::carray2Hex(xy, sizeof(xy));
+}
+
+
+ptr<string> LocalECDSASigner::generateKeyFile(const string &_keyFileFullPath) {
+
+    auto newKey = EC_KEY_new_by_curve_name(NID_secp256k1);
+
+    CHECK_STATE(newKey != nullptr);
+
+    EC_KEY_set_asn1_flag(newKey, OPENSSL_EC_NAMED_CURVE);
+
+    if (!EC_KEY_generate_key(newKey)) {
+        EC_KEY_free(newKey);
+        CHECK_STATE2(false, "Could not generate ECDSA key");
+    }
+
+    auto file = fopen(_keyFileFullPath.c_str(), "w");
+
+    if (file == nullptr) {
+        EC_KEY_free(newKey);
+        CHECK_STATE2(false, "Could not create ECDSA key file " + _keyFileFullPath);
+    }
+
+    chmod(_keyFileFullPath.c_str(), S_IRUSR | S_IWUSR);
+
+    auto written = PEM_write_ECPrivateKey(file, newKey, nullptr, nullptr, 0, nullptr, nullptr);
+
+    fclose(file);
+
+    ptr<string> result = nullptr;
+
+    if (written)
+        result = encodePublicKey(newKey);
+
+    EC_KEY_free(newKey);
+
+    CHECK_STATE2(result != nullptr, "Could not write ECDSA key file " + _keyFileFullPath);
+
+    return result;
+}
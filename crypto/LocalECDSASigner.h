@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file LocalECDSASigner.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_LOCALECDSASIGNER_H
+#define SKALED_LOCALECDSASIGNER_H
+
+
+#include "openssl/ec.h"
+
+#include "ECDSASigner.h"
+
+
+/**
+ * In-process secp256k1 signer that uses a private key from a PEM file.
+ * The key is not protected by SGX, so this signer is meant for tests and
+ * for deployments that accept keeping the key on disk.
+ */
+class LocalECDSASigner : public ECDSASigner {
+
+    EC_KEY* key = nullptr;
+
+    ptr<string> publicKey;
+
+    static ptr<string> encodePublicKey(EC_KEY* _key);
+
+    /**
+     * Finds which of the four candidate R points recovers our public key from the signature
+     */
+    uint32_t getRecoveryID(ptr<SHAHash> _hash, const BIGNUM* _r, const BIGNUM* _s, BN_CTX* _ctx);
+
+public:
+
+    explicit LocalECDSASigner(const string& _keyFileFullPath);
+
+    ~LocalECDSASigner() override;
+
+    ptr<string> sign(ptr<SHAHash> _hash) override;
+
+    ptr<string> getName() override;
+
+    /**
+     * @return public key as hex of x and y, the format of sgxECDSAPublicKey config params
+     */
+    ptr<string> getPublicKey();
+
+    /**
+     * Generates a new secp256k1 key and saves it to a PEM file
+     * @return public key of the generated key
+     */
+    static ptr<string> generateKeyFile(const string& _keyFileFullPath);
+};
+
+
+#endif //SKALED_LOCALECDSASIGNER_H
@@ -0,0 +1,44 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file MockupECDSASigner.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_MOCKUPECDSASIGNER_H
+#define SKALED_MOCKUPECDSASIGNER_H
+
+
+#include "ECDSASigner.h"
+
+
+/**
+ * Test signer, the signature is the hex of the hash
+ */
+class MockupECDSASigner : public ECDSASigner {
+
+public:
+
+    ptr<string> sign(ptr<SHAHash> _hash) override;
+
+    ptr<string> getName() override;
+};
+
+
+#endif //SKALED_MOCKUPECDSASIGNER_H
@@ -0,0 +1,237 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file SGXECDSASigner.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+#include "exceptions/ExitRequestedException.h"
+
+#include "stubclient.h"
+#include "jsonrpccpp/common/batchcall.h"
+#include "jsonrpccpp/common/batchresponse.h"
+
+#include "chains/Schain.h"
+#include "node/Node.h"
+#include "SHAHash.h"
+#include "CryptoManager.h"
+#include "SGXECDSASigner.h"
+
+
+SGXECDSASigner::SGXECDSASigner(ptr<string> _sgxIP, ptr<string> _keyName) : sgxIP(_sgxIP), keyName(_keyName) {
+    CHECK_ARGUMENT(_sgxIP != nullptr);
+    CHECK_ARGUMENT(_keyName != nullptr);
+
+    // StubClient keeps a reference to the connector, so the connector lives as long as the signer
+    httpClient = make_shared<jsonrpc::HttpClient>("https://" + *_sgxIP + ":" + to_string(SGX_SSL_PORT));
+    sgxClient = make_shared<StubClient>(*httpClient, jsonrpc::JSONRPC_CLIENT_V2);
+}
+
+ptr<string> SGXECDSASigner::sign(ptr<SHAHash> _hash) {
+    CHECK_ARGUMENT(_hash != nullptr);
+
+    {
+        lock_guard<mutex> lock(m);
+        if (!batching)
+            return CryptoManager::sgxSignECDSA(_hash, *keyName, sgxClient);
+    }
+
+    // synchronous callers still share batches with everyone else
+    return signAsync(_hash).get();
+}
+
+future<ptr<string>> SGXECDSASigner::signAsync(ptr<SHAHash> _hash) {
+    CHECK_ARGUMENT(_hash != nullptr);
+
+    auto request = make_shared<SGXSignRequest>();
+    request->hash = _hash;
+    auto result = request->result.get_future();
+
+    {
+        lock_guard<mutex> lock(m);
+
+        if (!batching) {
+            try {
+                request->result.set_value(CryptoManager::sgxSignECDSA(_hash, *keyName, sgxClient));
+            } catch (...) {
+                request->result.set_exception(current_exception());
+            }
+            return result;
+        }
+
+        if (exitRequested) {
+            request->result.set_exception(make_exception_ptr(ExitRequestedException(__CLASS_NAME__)));
+            return result;
+        }
+
+        requestQueue.push_back(request);
+    }
+
+    queueCond.notify_one();
+
+    return result;
+}
+
+ptr<string> SGXECDSASigner::getName() {
+    return make_shared<string>("sgx");
+}
+
+void SGXECDSASigner::startBatching() {
+    lock_guard<mutex> lock(m);
+    batching = true;
+}
+
+void SGXECDSASigner::exit() {
+
+    deque<ptr<SGXSignRequest>> pending;
+
+    {
+        lock_guard<mutex> lock(m);
+        exitRequested = true;
+        pending.swap(requestQueue);
+    }
+
+    queueCond.notify_all();
+
+    for (auto &&request : pending) {
+        request->result.set_exception(make_exception_ptr(ExitRequestedException(__CLASS_NAME__)));
+    }
+}
+
+
+ptr<vector<ptr<SGXSignRequest>>> SGXECDSASigner::waitForBatch() {
+
+    auto batch = make_shared<vector<ptr<SGXSignRequest>>>();
+
+    unique_lock<mutex> lock(m);
+
+    while (requestQueue.empty() && !exitRequested) {
+        queueCond.wait(lock);
+    }
+
+    while (!requestQueue.empty() && batch->size() < SGX_SIGN_MAX_BATCH_SIZE) {
+        batch->push_back(requestQueue.front());
+        requestQueue.pop_front();
+    }
+
+    return batch;
+}
+
+
+void SGXECDSASigner::signBatch(ptr<vector<ptr<SGXSignRequest>>> _batch, StubClient &_client) {
+
+    CHECK_ARGUMENT(_batch != nullptr && !_batch->empty());
+
+    if (_batch->size() == 1) {
+        auto request = _batch->front();
+        try {
+            auto result = _client.ecdsaSignMessageHash(16, *keyName, *request->hash->toHex());
+            request->result.set_value(parseSignature(result));
+        } catch (...) {
+            request->result.set_exception(current_exception());
+        }
+        return;
+    }
+
+    jsonrpc::BatchCall call;
+    vector<int> ids;
+
+    for (auto &&request : *_batch) {
+        Json::Value p;
+        p["base"] = 16;
+        p["keyName"] = *keyName;
+        p["messageHash"] = *request->hash->toHex();
+        ids.push_back(call.addCall("ecdsaSignMessageHash", p));
+    }
+
+    jsonrpc::BatchResponse response;
+
+    try {
+        response = _client.CallProcedures(call);
+    } catch (...) {
+        // the whole batch failed, report the error to every caller
+        for (auto &&request : *_batch) {
+            request->result.set_exception(current_exception());
+        }
+        return;
+    }
+
+    for (uint64_t i = 0; i < _batch->size(); i++) {
+        auto request = _batch->at(i);
+        try {
+            Json::Value id(ids.at(i));
+            CHECK_STATE2(response.getErrorCode(id) == 0, "SGX batch sign failed:" + response.getErrorMessage(id));
+            Json::Value result;
+            response.getResult(id, result);
+            request->result.set_value(parseSignature(result));
+        } catch (...) {
+            request->result.set_exception(current_exception());
+        }
+    }
+}
+
+
+ptr<string> SGXECDSASigner::parseSignature(const Json::Value &_result) {
+    CHECK_STATE(_result.isObject() && _result.isMember("status"));
+    auto status = _result["status"].asInt64();
+    CHECK_STATE(status == 0);
+    string r = _result["signature_r"].asString();
+    string s = _result["signature_s"].asString();
+    string v = _result["signature_v"].asString();
+
+    CHECK_STATE(r.size() > 2 && s.size() > 2);
+
+    return make_shared<string>(v + ":" + r.substr(2) + ":" + s.substr(2));
+}
+
+
+void SGXECDSASigner::workerThreadSignLoop(SGXECDSASigner *_signer, Schain *_sChain) {
+
+    CHECK_ARGUMENT(_signer != nullptr);
+    CHECK_ARGUMENT(_sChain != nullptr);
+
+    setThreadName("sgxSign", _sChain->getNode()->getConsensusEngine());
+
+    _sChain->waitOnGlobalStartBarrier();
+
+    logThreadLocal_ = _sChain->getNode()->getLog();
+
+    // a connection per thread, kept open between batches
+    jsonrpc::HttpClient client("https://" + *_signer->sgxIP + ":" + to_string(SGX_SSL_PORT));
+    StubClient sgxClient(client, jsonrpc::JSONRPC_CLIENT_V2);
+
+    try {
+        while (!_sChain->getNode()->isExitRequested()) {
+
+            auto batch = _signer->waitForBatch();
+
+            if (batch->empty())
+                return;
+
+            _signer->signBatch(batch, sgxClient);
+        }
+    } catch (ExitRequestedException &) {
+        return;
+    } catch (FatalError *e) {
+        _sChain->getNode()->exitOnFatalError(e->getMessage());
+    }
+}
@@ -0,0 +1,109 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file SGXECDSASigner.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_SGXECDSASIGNER_H
+#define SKALED_SGXECDSASIGNER_H
+
+
+#include "ECDSASigner.h"
+
+class Schain;
+class StubClient;
+
+namespace Json {
+    class Value;
+}
+
+namespace jsonrpc {
+    class HttpClient;
+}
+
+
+/**
+ * Pending signature of a hash, completed by a signing thread
+ */
+class SGXSignRequest {
+public:
+    ptr<SHAHash> hash;
+    promise<ptr<string>> result;
+};
+
+
+/**
+ * Signs through the JSON-RPC interface of the SGX wallet.
+ *
+ * Once batching is started, sign requests of all threads go to a queue. Signing threads
+ * take everything that accumulated in the queue and send it as a single JSON-RPC batch,
+ * so the wallet round trip is paid once per batch instead of once per message.
+ */
+class SGXECDSASigner : public ECDSASigner {
+
+    ptr<string> sgxIP;
+
+    ptr<string> keyName;
+
+    ptr<jsonrpc::HttpClient> httpClient;
+
+    ptr<StubClient> sgxClient;
+
+    mutex m;
+
+    condition_variable queueCond;
+
+    deque<ptr<SGXSignRequest>> requestQueue;
+
+    bool batching = false;
+
+    bool exitRequested = false;
+
+    ptr<vector<ptr<SGXSignRequest>>> waitForBatch();
+
+    void signBatch(ptr<vector<ptr<SGXSignRequest>>> _batch, StubClient &_client);
+
+public:
+
+    SGXECDSASigner(ptr<string> _sgxIP, ptr<string> _keyName);
+
+    ptr<string> sign(ptr<SHAHash> _hash) override;
+
+    future<ptr<string>> signAsync(ptr<SHAHash> _hash) override;
+
+    ptr<string> getName() override;
+
+    /**
+     * Routes sign requests through the queue, signing threads have to be running
+     */
+    void startBatching();
+
+    void exit();
+
+    /**
+     * Converts an ecdsaSignMessageHash result to a "v:r:s" signature
+     */
+    static ptr<string> parseSignature(const Json::Value &_result);
+
+    static void workerThreadSignLoop(SGXECDSASigner *_signer, Schain *_sChain);
+};
+
+
+#endif //SKALED_SGXECDSASIGNER_H
@@ -0,0 +1,522 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file SHA256Hasher.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#include "SHA256Hasher.h"
+
+
+static const uint32_t SHA256_K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t SHA256_IV[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+
+static inline uint32_t loadBigEndian32(const uint8_t *_p) {
+    return ((uint32_t) _p[0] << 24) | ((uint32_t) _p[1] << 16) | ((uint32_t) _p[2] << 8) | (uint32_t) _p[3];
+}
+
+static inline void storeBigEndian32(uint8_t *_p, uint32_t _value) {
+    _p[0] = (uint8_t) (_value >> 24);
+    _p[1] = (uint8_t) (_value >> 16);
+    _p[2] = (uint8_t) (_value >> 8);
+    _p[3] = (uint8_t) _value;
+}
+
+static inline uint32_t rotr(uint32_t _x, uint32_t _n) {
+    return (_x >> _n) | (_x << (32 - _n));
+}
+
+
+static void compressSoftware(uint32_t *_state, const uint8_t *_blocks, uint64_t _blockCount) {
+
+    uint32_t w[64];
+
+    for (uint64_t block = 0; block < _blockCount; block++, _blocks += 64) {
+
+        for (int t = 0; t < 16; t++) {
+            w[t] = loadBigEndian32(_blocks + 4 * t);
+        }
+
+        for (int t = 16; t < 64; t++) {
+            auto s0 = rotr(w[t - 15], 7) ^ rotr(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            auto s1 = rotr(w[t - 2], 17) ^ rotr(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        auto a = _state[0], b = _state[1], c = _state[2], d = _state[3];
+        auto e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+
+        for (int t = 0; t < 64; t++) {
+            auto t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[t] + w[t];
+            auto t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        _state[0] += a;
+        _state[1] += b;
+        _state[2] += c;
+        _state[3] += d;
+        _state[4] += e;
+        _state[5] += f;
+        _state[6] += g;
+        _state[7] += h;
+    }
+}
+
+
+#if defined(__x86_64__)
+
+__attribute__((target("sha,sse4.1")))
+static void compressSHANI(uint32_t *_state, const uint8_t *_blocks, uint64_t _blockCount) {
+
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // the SHA instructions keep the state as ABEF and CDGH
+    auto tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &_state[0]), 0xB1);
+    auto state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &_state[4]), 0x1B);
+    auto state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (uint64_t block = 0; block < _blockCount; block++, _blocks += 64) {
+
+        auto savedState0 = state0;
+        auto savedState1 = state1;
+
+        __m128i w[4];
+
+#pragma GCC unroll 16
+        for (int i = 0; i < 16; i++) {
+
+            __m128i words;
+
+            if (i < 4) {
+                words = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (_blocks + 16 * i)), byteSwapMask);
+            } else {
+                words = _mm_add_epi32(_mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]),
+                                      _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+                words = _mm_sha256msg2_epu32(words, w[(i + 3) % 4]);
+            }
+
+            w[i % 4] = words;
+
+            auto message = _mm_add_epi32(words, _mm_loadu_si128((const __m128i *) &SHA256_K[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(message, 0x0E));
+        }
+
+        state0 = _mm_add_epi32(state0, savedState0);
+        state1 = _mm_add_epi32(state1, savedState1);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+    _mm_storeu_si128((__m128i *) &_state[0], state0);
+    _mm_storeu_si128((__m128i *) &_state[4], state1);
+}
+
+
+#define AVX2_ROTR(_X_, _N_) _mm256_or_si256(_mm256_srli_epi32(_X_, _N_), _mm256_slli_epi32(_X_, 32 - (_N_)))
+
+/* One block of each of 8 independent messages, _states is word-major (_states[word][lane]) */
+__attribute__((target("avx2")))
+static void compressAVX2(uint32_t (*_states)[8], const uint8_t *const *_blocks) {
+
+    __m256i w[16];
+
+    __m256i s[8];
+
+    for (int i = 0; i < 8; i++) {
+        s[i] = _mm256_loadu_si256((const __m256i *) _states[i]);
+    }
+
+    auto a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int t = 0; t < 64; t++) {
+
+        __m256i words;
+
+        if (t < 16) {
+            words = _mm256_setr_epi32(
+                    loadBigEndian32(_blocks[0] + 4 * t), loadBigEndian32(_blocks[1] + 4 * t),
+                    loadBigEndian32(_blocks[2] + 4 * t), loadBigEndian32(_blocks[3] + 4 * t),
+                    loadBigEndian32(_blocks[4] + 4 * t), loadBigEndian32(_blocks[5] + 4 * t),
+                    loadBigEndian32(_blocks[6] + 4 * t), loadBigEndian32(_blocks[7] + 4 * t));
+        } else {
+            auto w15 = w[(t - 15) % 16];
+            auto w2 = w[(t - 2) % 16];
+            auto s0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(w15, 7), AVX2_ROTR(w15, 18)),
+                                       _mm256_srli_epi32(w15, 3));
+            auto s1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(w2, 17), AVX2_ROTR(w2, 19)),
+                                       _mm256_srli_epi32(w2, 10));
+            words = _mm256_add_epi32(_mm256_add_epi32(w[t % 16], s0), _mm256_add_epi32(w[(t - 7) % 16], s1));
+        }
+
+        w[t % 16] = words;
+
+        auto sigma1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(e, 6), AVX2_ROTR(e, 11)), AVX2_ROTR(e, 25));
+        auto choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        auto t1 = _mm256_add_epi32(_mm256_add_epi32(h, sigma1),
+                                   _mm256_add_epi32(_mm256_add_epi32(choose, _mm256_set1_epi32(SHA256_K[t])),
+                                                    words));
+        auto sigma0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(a, 2), AVX2_ROTR(a, 13)), AVX2_ROTR(a, 22));
+        auto majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        auto t2 = _mm256_add_epi32(sigma0, majority);
+
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+
+    __m256i result[8] = {a, b, c, d, e, f, g, h};
+
+    for (int i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i *) _states[i], _mm256_add_epi32(s[i], result[i]));
+    }
+}
+
+
+/* Position of a message that is being hashed in an AVX2 lane */
+class SHA256Lane {
+public:
+    const uint8_t *data = nullptr;
+    uint64_t fullBlocks = 0;
+    uint64_t totalBlocks = 0;
+    uint64_t nextBlock = 0;
+    uint64_t messageIndex = 0;
+    uint8_t tail[128];
+
+    void start(const uint8_t *_data, uint64_t _len, uint64_t _messageIndex) {
+        data = _data;
+        fullBlocks = _len / 64;
+        nextBlock = 0;
+        messageIndex = _messageIndex;
+
+        auto remaining = _len % 64;
+        auto tailBlocks = (remaining + 9 <= 64) ? 1 : 2;
+        totalBlocks = fullBlocks + tailBlocks;
+
+        memset(tail, 0, sizeof(tail));
+        if (remaining > 0)
+            memcpy(tail, _data + 64 * fullBlocks, remaining);
+        tail[remaining] = 0x80;
+
+        uint64_t bitLen = _len * 8;
+        for (int i = 0; i < 8; i++) {
+            tail[64 * tailBlocks - 1 - i] = (uint8_t) (bitLen >> (8 * i));
+        }
+    }
+
+    const uint8_t *getBlock() const {
+        if (nextBlock < fullBlocks)
+            return data + 64 * nextBlock;
+        return tail + 64 * (nextBlock - fullBlocks);
+    }
+};
+
+
+static void hashManyAVX2(uint64_t _begin, uint64_t _end, const uint8_t *const *_data, const uint64_t *_lens,
+                         uint8_t *_digests) {
+
+    static const uint8_t idleBlock[64] = {0};
+
+    uint32_t states[8][8];
+    SHA256Lane lanes[8];
+    bool active[8];
+
+    uint64_t next = _begin;
+    uint64_t activeCount = 0;
+
+    auto assign = [&](int _lane) {
+        active[_lane] = next < _end;
+        if (!active[_lane])
+            return;
+        lanes[_lane].start(_data[next], _lens[next], next);
+        for (int i = 0; i < 8; i++) {
+            states[i][_lane] = SHA256_IV[i];
+        }
+        next++;
+        activeCount++;
+    };
+
+    for (int lane = 0; lane < 8; lane++) {
+        assign(lane);
+    }
+
+    while (activeCount > 0) {
+
+        const uint8_t *blocks[8];
+
+        for (int lane = 0; lane < 8; lane++) {
+            blocks[lane] = active[lane] ? lanes[lane].getBlock() : idleBlock;
+        }
+
+        compressAVX2(states, blocks);
+
+        for (int lane = 0; lane < 8; lane++) {
+            if (!active[lane])
+                continue;
+
+            if (++lanes[lane].nextBlock < lanes[lane].totalBlocks)
+                continue;
+
+            auto digest = _digests + SHA_HASH_LEN * lanes[lane].messageIndex;
+            for (int i = 0; i < 8; i++) {
+                storeBigEndian32(digest + 4 * i, states[i][lane]);
+            }
+
+            activeCount--;
+            assign(lane);
+        }
+    }
+}
+
+#endif
+
+
+bool SHA256Hasher::isSupported(Implementation _implementation) {
+
+    if (_implementation == SOFTWARE)
+        return true;
+
+#if defined(__x86_64__)
+
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    bool hasSSSE3 = (ecx & (1 << 9)) != 0;
+    bool hasSSE41 = (ecx & (1 << 19)) != 0;
+    bool hasOSXSAVE = (ecx & (1 << 27)) != 0;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    if (_implementation == SHA_NI)
+        return (ebx & (1 << 29)) != 0 && hasSSSE3 && hasSSE41;
+
+    if (_implementation == AVX2 && (ebx & (1 << 5)) != 0 && hasOSXSAVE) {
+        // the OS has to save YMM registers
+        uint32_t xcr0Low = 0, xcr0High = 0;
+        __asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+        return (xcr0Low & 6) == 6;
+    }
+
+#endif
+
+    return false;
+}
+
+
+SHA256Hasher::Implementation SHA256Hasher::detectImplementation() {
+    if (isSupported(SHA_NI))
+        return SHA_NI;
+    if (isSupported(AVX2))
+        return AVX2;
+    return SOFTWARE;
+}
+
+
+atomic<SHA256Hasher::Implementation> SHA256Hasher::implementation(SHA256Hasher::detectImplementation());
+
+
+SHA256Hasher::Implementation SHA256Hasher::getImplementation() {
+    return implementation;
+}
+
+
+void SHA256Hasher::setImplementation(Implementation _implementation) {
+    CHECK_ARGUMENT2(isSupported(_implementation),
+                    "SHA256 implementation is not supported by the CPU:" + getImplementationName(_implementation));
+    implementation = _implementation;
+}
+
+
+string SHA256Hasher::getImplementationName(Implementation _implementation) {
+    switch (_implementation) {
+        case SHA_NI:
+            return "SHA-NI";
+        case AVX2:
+            return "AVX2";
+        default:
+            return "software";
+    }
+}
+
+
+void SHA256Hasher::compress(uint32_t *_state, const uint8_t *_blocks, uint64_t _blockCount) {
+#if defined(__x86_64__)
+    if (implementation == SHA_NI) {
+        compressSHANI(_state, _blocks, _blockCount);
+        return;
+    }
+#endif
+    compressSoftware(_state, _blocks, _blockCount);
+}
+
+
+SHA256Hasher::SHA256Hasher() {
+    memcpy(state, SHA256_IV, sizeof(state));
+}
+
+
+void SHA256Hasher::update(const uint8_t *_data, uint64_t _len) {
+
+    totalLen += _len;
+
+    if (bufferLen > 0) {
+        auto count = std::min(_len, 64 - bufferLen);
+        memcpy(buffer + bufferLen, _data, count);
+        bufferLen += count;
+        _data += count;
+        _len -= count;
+
+        if (bufferLen < 64)
+            return;
+
+        compress(state, buffer, 1);
+        bufferLen = 0;
+    }
+
+    if (_len >= 64) {
+        compress(state, _data, _len / 64);
+        _data += _len - _len % 64;
+        _len %= 64;
+    }
+
+    if (_len > 0) {
+        memcpy(buffer, _data, _len);
+        bufferLen = _len;
+    }
+}
+
+
+void SHA256Hasher::final(uint8_t *_digest) {
+
+    uint64_t bitLen = totalLen * 8;
+
+    buffer[bufferLen++] = 0x80;
+
+    if (bufferLen > 56) {
+        memset(buffer + bufferLen, 0, 64 - bufferLen);
+        compress(state, buffer, 1);
+        bufferLen = 0;
+    }
+
+    memset(buffer + bufferLen, 0, 56 - bufferLen);
+
+    for (int i = 0; i < 8; i++) {
+        buffer[63 - i] = (uint8_t) (bitLen >> (8 * i));
+    }
+
+    compress(state, buffer, 1);
+
+    for (int i = 0; i < 8; i++) {
+        storeBigEndian32(_digest + 4 * i, state[i]);
+    }
+}
+
+
+void SHA256Hasher::hash(const uint8_t *_data, uint64_t _len, uint8_t *_digest) {
+    SHA256Hasher hasher;
+    hasher.update(_data, _len);
+    hasher.final(_digest);
+}
+
+
+void SHA256Hasher::hashRange(uint64_t _begin, uint64_t _end, const uint8_t *const *_data, const uint64_t *_lens,
+                             uint8_t *_digests) {
+#if defined(__x86_64__)
+    // with SHA-NI a single lane is faster than 8 lanes of AVX2
+    if (implementation == AVX2 && _end - _begin > 1) {
+        hashManyAVX2(_begin, _end, _data, _lens, _digests);
+        return;
+    }
+#endif
+
+    for (uint64_t i = _begin; i < _end; i++) {
+        hash(_data[i], _lens[i], _digests + SHA_HASH_LEN * i);
+    }
+}
+
+
+void SHA256Hasher::hashMany(uint64_t _count, const uint8_t *const *_data, const uint64_t *_lens,
+                            uint8_t *_digests) {
+
+    CHECK_ARGUMENT(_count == 0 || (_data != nullptr && _lens != nullptr && _digests != nullptr));
+
+    uint64_t threadCount = std::min((uint64_t) SHA_HASH_THREADS, (uint64_t) thread::hardware_concurrency());
+
+    if (_count < SHA_HASH_PARALLEL_MIN_MESSAGES || threadCount < 2) {
+        hashRange(0, _count, _data, _lens, _digests);
+        return;
+    }
+
+    auto chunkSize = (_count + threadCount - 1) / threadCount;
+
+    vector<thread> threads;
+
+    for (uint64_t begin = chunkSize; begin < _count; begin += chunkSize) {
+        auto end = std::min(begin + chunkSize, _count);
+        threads.emplace_back(hashRange, begin, end, _data, _lens, _digests);
+    }
+
+    hashRange(0, std::min(chunkSize, _count), _data, _lens, _digests);
+
+    for (auto &&t : threads) {
+        t.join();
+    }
+}
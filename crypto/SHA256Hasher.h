@@ -0,0 +1,88 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file SHA256Hasher.h
+    @author agent
+    @date 2026
+*/
+
+#ifndef SKALED_SHA256HASHER_H
+#define SKALED_SHA256HASHER_H
+
+
+/**
+ * SHA-256 with SHA-NI on CPUs that have it, AVX2 8-lane multi-buffer hashing of many messages otherwise,
+ * and a portable implementation that all paths have to agree with.
+ */
+class SHA256Hasher {
+
+public:
+
+    enum Implementation {
+        SOFTWARE, AVX2, SHA_NI
+    };
+
+private:
+
+    static atomic<Implementation> implementation;
+
+    uint32_t state[8];
+
+    uint8_t buffer[64];
+
+    uint64_t bufferLen = 0;
+
+    uint64_t totalLen = 0;
+
+    static void compress(uint32_t *_state, const uint8_t *_blocks, uint64_t _blockCount);
+
+    static void hashRange(uint64_t _begin, uint64_t _end, const uint8_t *const *_data, const uint64_t *_lens,
+                          uint8_t *_digests);
+
+public:
+
+    SHA256Hasher();
+
+    void update(const uint8_t *_data, uint64_t _len);
+
+    void final(uint8_t *_digest);
+
+    static void hash(const uint8_t *_data, uint64_t _len, uint8_t *_digest);
+
+    /**
+     * Hashes _count messages into _digests (SHA_HASH_LEN bytes each), in parallel lanes and
+     * for large batches also across threads
+     */
+    static void hashMany(uint64_t _count, const uint8_t *const *_data, const uint64_t *_lens, uint8_t *_digests);
+
+    static bool isSupported(Implementation _implementation);
+
+    static Implementation detectImplementation();
+
+    static Implementation getImplementation();
+
+    /**
+     * Used by tests and benchmarks, fails if the CPU does not support the implementation
+     */
+    static void setImplementation(Implementation _implementation);
+
+    static string getImplementationName(Implementation _implementation);
+};
+
+
+#endif //SKALED_SHA256HASHER_H
@@ -29,6 +29,7 @@
 #include "network/Utils.h"
 #include "exceptions/InvalidArgumentException.h"
 
+#include "SHA256Hasher.h"
 #include "SHAHash.h"
 
 void SHAHash::print() {
@@ -90,11 +91,7 @@ ptr<SHAHash> SHAHash::calculateHash(ptr<vector<uint8_t>> _data) {
 
     auto digest = make_shared<array<uint8_t, SHA_HASH_LEN> >();
 
-
-    CryptoPP::SHA256 hashObject;
-
-    hashObject.Update(_data->data(), _data->size());
-    hashObject.Final(digest->data());
+    SHA256Hasher::hash(_data->data(), _data->size(), digest->data());
 
     auto hash = make_shared<SHAHash>(digest);
 
@@ -106,18 +103,16 @@ ptr<SHAHash> SHAHash::merkleTreeMerge(ptr<SHAHash> _left, ptr<SHAHash> _right) {
     CHECK_ARGUMENT(_left != nullptr);
     CHECK_ARGUMENT(_right != nullptr);
 
-    auto concatenation = make_shared<vector<uint8_t>>();
-    concatenation->reserve(2 * SHA_HASH_LEN);
+    uint8_t concatenation[2 * SHA_HASH_LEN];
 
-    auto leftHash = _left->getHash();
+    memcpy(concatenation, _left->getHash()->data(), SHA_HASH_LEN);
+    memcpy(concatenation + SHA_HASH_LEN, _right->getHash()->data(), SHA_HASH_LEN);
 
-    concatenation->insert(concatenation->end(), leftHash->begin(), leftHash->end());
-
-    auto rightHash = _right->getHash();
-    concatenation->insert(concatenation->end(), rightHash->begin(), rightHash->end());
+    auto digest = make_shared<array<uint8_t, SHA_HASH_LEN> >();
 
+    SHA256Hasher::hash(concatenation, sizeof(concatenation), digest->data());
 
-    return calculateHash(concatenation);
+    return make_shared<SHAHash>(digest);
 }
 
 ptr<array<uint8_t, SHA_HASH_LEN>> SHAHash::getHash() const {
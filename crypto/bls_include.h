@@ -52,6 +52,7 @@
 #pragma GCC diagnostic ignored "-Wreorder"
 
 #include <libff/algebra/curves/alt_bn128/alt_bn128_g1.hpp>
+#include <libff/algebra/scalar_multiplication/multiexp.hpp>
 
 
 #include "bls.h"
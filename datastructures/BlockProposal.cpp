@@ -34,6 +34,7 @@
 #include "exceptions/InvalidArgumentException.h"
 #include "exceptions/ParsingException.h"
 #include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
 #include "crypto/CryptoManager.h"
 #include "network/Buffer.h"
 #include "node/ConsensusEngine.h"
@@ -44,6 +45,7 @@
 #include "datastructures/BlockProposalFragment.h"
 #include "datastructures/BlockProposalFragmentList.h"
 #include "headers/BlockProposalRequestHeader.h"
+#include "utils/ReedSolomon.h"
 
 
 #include "Transaction.h"
@@ -62,7 +64,7 @@ ptr<SHAHash> BlockProposal::getHash() {
 
 
 void BlockProposal::calculateHash() {
-    CryptoPP::SHA256 sha3;
+    SHA256Hasher sha3;
 
 
     SHA3_UPDATE(sha3, proposerIndex);
@@ -80,14 +82,14 @@ void BlockProposal::calculateHash() {
     // export into 8-bit unsigned values, most significant bit first:
     auto sr = Utils::u256ToBigEndianArray(getStateRoot());
     auto v = Utils::carray2Hex(sr->data(),  sr->size());
-    sha3.Update((unsigned char *) v->data(), v->size());
+    sha3.update((unsigned char *) v->data(), v->size());
 
     if (transactionList->size() > 0) {
         auto merkleRoot = transactionList->calculateTopMerkleRoot();
-        sha3.Update(merkleRoot->getHash()->data(), SHA_HASH_LEN);
+        sha3.update(merkleRoot->getHash()->data(), SHA_HASH_LEN);
     }
     auto buf = make_shared<array<uint8_t, SHA_HASH_LEN>>();
-    sha3.Final(buf->data());
+    sha3.final(buf->data());
     hash = make_shared<SHAHash>(buf);
 };
 
@@ -287,7 +289,8 @@ ptr<BlockProposal> BlockProposal::deserialize(ptr<vector<uint8_t> > _serializedP
                                                blockHeader->getTimeStampMs(),
                                                blockHeader->getSignature(), nullptr);
 
-    _manager->verifyProposalECDSA(proposal, blockHeader->getBlockHash(), blockHeader->getSignature());
+    CHECK_STATE2(_manager->verifyProposalECDSA(proposal, blockHeader->getBlockHash(), blockHeader->getSignature()),
+                 "Proposal ECDSA sig did not verify");
 
     proposal->serializedProposal = _serializedProposal;
 
@@ -346,6 +349,30 @@ ptr<BlockProposalFragment> BlockProposal::getFragment(uint64_t _totalFragments,
                                               sBlock->size(), getHash()->toHex());
 }
 
+ptr<BlockProposalFragment> BlockProposal::getErasureCodedFragment(uint64_t _totalFragments,
+                                                                  uint64_t _dataFragments,
+                                                                  fragment_index _index) {
+    CHECK_ARGUMENT(_dataFragments > 0);
+    CHECK_ARGUMENT(_dataFragments <= _totalFragments);
+    CHECK_ARGUMENT(_index > 0);
+    CHECK_ARGUMENT(_index <= _totalFragments);
+    LOCK(m)
+
+    auto sBlock = serialize();
+
+    auto shard = ReedSolomon::encodeShard(*sBlock, _dataFragments, _totalFragments, (uint64_t) _index - 1);
+
+    auto fragmentData = make_shared<vector<uint8_t>>();
+    fragmentData->reserve(shard->size() + 2);
+
+    fragmentData->push_back('<');
+    fragmentData->insert(fragmentData->end(), shard->begin(), shard->end());
+    fragmentData->push_back('>');
+
+    return make_shared<BlockProposalFragment>(getBlockID(), _totalFragments, _index, fragmentData,
+                                              sBlock->size(), getHash()->toHex());
+}
+
 ptr<TransactionList> BlockProposal::deserializeTransactions(ptr<BlockProposalHeader> _header,
                                                             ptr<string> _headerString,
                                                             ptr<vector<uint8_t> > _serializedBlock) {
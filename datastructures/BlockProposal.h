@@ -127,6 +127,9 @@ public:
 
     ptr<BlockProposalFragment> getFragment(uint64_t _totalFragments, fragment_index _index);
 
+    ptr<BlockProposalFragment> getErasureCodedFragment(uint64_t _totalFragments, uint64_t _dataFragments,
+                                                       fragment_index _index);
+
     u256 getStateRoot() const;
 
 };
@@ -31,17 +31,22 @@
 #include "Log.h"
 #include "exceptions/SerializeException.h"
 
+#include "utils/ReedSolomon.h"
 #include "BlockProposalFragment.h"
 
 
 #include "BlockProposalFragmentList.h"
 
 BlockProposalFragmentList::BlockProposalFragmentList(const block_id &_blockId,
-                                                       const uint64_t _totalFragments) :
+                                                       const uint64_t _totalFragments,
+                                                       const uint64_t _dataFragments) :
         blockID(_blockId),
         totalFragments(
-                _totalFragments) {
+                _totalFragments),
+        dataFragments(_dataFragments == 0 ? _totalFragments : _dataFragments) {
     CHECK_ARGUMENT(totalFragments > 0);
+    CHECK_ARGUMENT(dataFragments <= totalFragments);
+    CHECK_ARGUMENT(!isErasureCoded() || totalFragments <= ReedSolomon::MAX_SHARDS);
 
     for (uint64_t i = 1; i <= totalFragments; i++) {
         missingFragments.push_back(i);
@@ -54,7 +59,7 @@ uint64_t BlockProposalFragmentList::nextIndexToRetrieve() {
 
     LOCK(m);
 
-    if (missingFragments.size() == 0) {
+    if (missingFragments.size() == 0 || isComplete()) {
         return 0;
     }
 
@@ -73,7 +78,30 @@ uint64_t BlockProposalFragmentList::nextIndexToRetrieve() {
     ASSERT2(false, "nextIndexToRetrieve assertion failure"); // SHOULD NEVER BE HERE
 }
 
-bool BlockProposalFragmentList::addFragment(ptr<BlockProposalFragment> _fragment, uint64_t &nextIndex) {
+uint64_t BlockProposalFragmentList::nextIndexToRetrieve(const set<fragment_index> &_inFlight) {
+
+    LOCK(m);
+
+    if (missingFragments.size() == 0 || isComplete()) {
+        return 0;
+    }
+
+    // prefer fragments nobody is downloading yet
+    vector<uint64_t> candidates;
+
+    for (auto &&element: missingFragments) {
+        if (_inFlight.count(element) == 0)
+            candidates.push_back(element);
+    }
+
+    if (candidates.empty())
+        return nextIndexToRetrieve();
+
+    return candidates.at(ubyte(gen) % candidates.size());
+}
+
+bool BlockProposalFragmentList::addFragment(ptr<BlockProposalFragment> _fragment, uint64_t &nextIndex,
+                                            uint64_t _dataFragments) {
 
     CHECK_ARGUMENT(_fragment->getBlockId() == blockID);
     CHECK_ARGUMENT(_fragment->getIndex() > 0)
@@ -82,6 +110,13 @@ bool BlockProposalFragmentList::addFragment(ptr<BlockProposalFragment> _fragment
 
     LOCK(m)
 
+    nextIndex = 0;
+
+    // the list may have switched to plain slices while the fragment was downloaded
+    if (_dataFragments != (isErasureCoded() ? (uint64_t) dataFragments : 0)) {
+        return false;
+    }
+
     if (blockHash == nullptr) {
         blockHash = _fragment->getBlockHash();
         blockSize = _fragment->getBlockSize();
@@ -92,8 +127,14 @@ bool BlockProposalFragmentList::addFragment(ptr<BlockProposalFragment> _fragment
 
     checkSanity();
 
+    if (isErasureCoded()) {
+        CHECK_ARGUMENT(_fragment->serialize()->size() - 2 == ReedSolomon::getShardSize(blockSize, dataFragments));
+    }
 
-    nextIndex = 0;
+    // enough fragments arrived already
+    if (isComplete()) {
+        return false;
+    }
 
     if (fragments.find(_fragment->getIndex()) != fragments.end()) {
         return false;
@@ -136,6 +177,10 @@ bool BlockProposalFragmentList::isComplete() {
 
     checkSanity();
 
+    if (isErasureCoded()) {
+        return fragments.size() >= dataFragments;
+    }
+
     if (fragments.size() == totalFragments) {
         for (uint64_t i = 1; i <= totalFragments; i++) {
             CHECK_STATE(fragments.find(i) != fragments.end())
@@ -167,6 +212,25 @@ ptr<vector<uint8_t>> BlockProposalFragmentList::serialize() {
 
     uint64_t totalLen = 0;
 
+    if (isErasureCoded()) {
+        try {
+            map<uint64_t, ptr<vector<uint8_t>>> shards;
+
+            for (auto &&item : fragments) {
+                shards[(uint64_t) item.first - 1] = make_shared<vector<uint8_t>>(item.second->begin() + 1,
+                                                                                 item.second->end() - 1);
+            }
+
+            result = ReedSolomon::decode(shards, dataFragments, totalFragments, blockSize);
+        } catch (...) {
+            throw_with_nested(SerializeException("Could not decode fragments", __CLASS_NAME__));
+        }
+
+        CHECK_STATE((*result)[sizeof(uint64_t)] == '{');
+        CHECK_STATE(result->back() == '>');
+        return result;
+    }
+
     try {
 
         for (auto &&item : fragments) {
@@ -193,6 +257,33 @@ ptr<vector<uint8_t>> BlockProposalFragmentList::serialize() {
 }
 
 
+bool BlockProposalFragmentList::isErasureCoded() const {
+    return dataFragments < totalFragments;
+}
+
+uint64_t BlockProposalFragmentList::getDataFragments() const {
+    return dataFragments;
+}
+
+void BlockProposalFragmentList::switchToPlainFragments() {
+    LOCK(m)
+
+    if (!isErasureCoded())
+        return;
+
+    CHECK_STATE(!isSerialized);
+
+    dataFragments = totalFragments;
+
+    fragments.clear();
+    missingFragments.clear();
+
+    for (uint64_t i = 1; i <= totalFragments; i++) {
+        missingFragments.push_back(i);
+    }
+}
+
+
 boost::random::mt19937 BlockProposalFragmentList::gen;
 
 boost::random::uniform_int_distribution<> BlockProposalFragmentList::ubyte(0, 1024);
\ No newline at end of file
@@ -49,6 +49,9 @@ class BlockProposalFragmentList : public DataStructure {
 
     const uint64_t  totalFragments;
 
+    // fragments needed to restore the block, less than totalFragments if erasure coded
+    atomic<uint64_t>  dataFragments;
+
     map<fragment_index, ptr<vector<uint8_t>>> fragments;
 
     list<uint64_t> missingFragments;
@@ -61,14 +64,31 @@ class BlockProposalFragmentList : public DataStructure {
     static boost::random::uniform_int_distribution<> ubyte;
 
 public:
-    BlockProposalFragmentList(const block_id &_blockId, const uint64_t _totalFragments);
+    BlockProposalFragmentList(const block_id &_blockId, const uint64_t _totalFragments,
+                              const uint64_t _dataFragments = 0);
 
-    bool addFragment(ptr<BlockProposalFragment> _fragment, uint64_t& _nextIndexToRetrieve);
+    /**
+     * _dataFragments is what the fragment was coded with, 0 for a plain slice.
+     * Fragments that do not match the coding of the list are rejected.
+     */
+    bool addFragment(ptr<BlockProposalFragment> _fragment, uint64_t& _nextIndexToRetrieve,
+                     uint64_t _dataFragments = 0);
 
     uint64_t nextIndexToRetrieve();
 
+    uint64_t nextIndexToRetrieve(const set<fragment_index> &_inFlight);
+
     bool isComplete();
 
+    bool isErasureCoded() const;
+
+    uint64_t getDataFragments() const;
+
+    /**
+     * Drops erasure coded fragments and falls back to a plain slice from every peer
+     */
+    void switchToPlainFragments();
+
     ptr<vector<uint8_t >> serialize();
 
 };
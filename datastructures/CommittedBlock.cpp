@@ -99,7 +99,8 @@ ptr<CommittedBlock> CommittedBlock::deserialize(ptr<vector<uint8_t> > _serialize
                                       blockHeader->getSignature(),
                                       blockHeader->getThresholdSig());
 
-    _manager->verifyProposalECDSA(block, blockHeader->getBlockHash(), blockHeader->getSignature());
+    CHECK_STATE2(_manager->verifyProposalECDSA(block, blockHeader->getBlockHash(), blockHeader->getSignature()),
+                 "Block ECDSA sig did not verify");
     return block;
 }
 
@@ -24,6 +24,7 @@
 #include "SkaleCommon.h"
 #include "Log.h"
 #include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
 #include "ListOfHashes.h"
 
 
@@ -33,26 +34,46 @@ ptr<SHAHash> ListOfHashes::calculateTopMerkleRoot() {
 
     CHECK_STATE(hashCount() > 0);
 
-    vector<ptr<SHAHash>> hashes;
-    hashes.reserve(hashCount() + 1);
+    calculateHashes();
 
-    for (uint64_t i = 0; i < hashCount(); i++) {
-        hashes.push_back(getHash(i));
+    uint64_t count = hashCount();
+
+    // a level of the tree is a flat array, so that all merges of the level are hashed as one batch
+    vector<uint8_t> level((count + 1) * SHA_HASH_LEN);
+
+    for (uint64_t i = 0; i < count; i++) {
+        memcpy(level.data() + i * SHA_HASH_LEN, getHash(i)->getHash()->data(), SHA_HASH_LEN);
     }
 
-    while (hashes.size() > 1) {
+    vector<const uint8_t *> pairs;
+    vector<uint64_t> pairLens;
+
+    while (count > 1) {
+
+        if (count % 2 == 1) {
+            memcpy(level.data() + count * SHA_HASH_LEN, level.data() + (count - 1) * SHA_HASH_LEN, SHA_HASH_LEN);
+            count++;
+        }
 
-        if (hashes.size() % 2 == 1)
-            hashes.push_back(hashes.back());
+        pairs.clear();
+        pairLens.assign(count / 2, 2 * SHA_HASH_LEN);
 
-        for (uint64_t j = 0; j < hashes.size() / 2; j++) {
-            hashes[j] = SHAHash::merkleTreeMerge(hashes[2 * j], hashes[2 * j + 1]);
+        for (uint64_t j = 0; j < count / 2; j++) {
+            pairs.push_back(level.data() + 2 * j * SHA_HASH_LEN);
         }
 
-        hashes.resize(hashes.size() / 2);
+        vector<uint8_t> nextLevel((count / 2 + 1) * SHA_HASH_LEN);
+
+        SHA256Hasher::hashMany(count / 2, pairs.data(), pairLens.data(), nextLevel.data());
+
+        level.swap(nextLevel);
+        count /= 2;
     }
 
-    return hashes.front();
+    auto root = make_shared<array<uint8_t, SHA_HASH_LEN>>();
+    memcpy(root->data(), level.data(), SHA_HASH_LEN);
+
+    return make_shared<SHAHash>(root);
 
 }
 
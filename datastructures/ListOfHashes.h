@@ -30,6 +30,11 @@ class SHAHAsh;
 
 class ListOfHashes : public DataStructure {
 
+protected:
+
+    // lets lists compute the hashes of all items at once before the tree is built
+    virtual void calculateHashes() {}
+
 public:
 
     virtual uint64_t hashCount() = 0;
@@ -125,6 +125,32 @@ void test_committed_block_fragment_defragment(bool _fail) {
             REQUIRE(*imp->serialize() == *t->serialize());
         }
 
+        // erasure coded fragments, any dataFragments of them restore the block
+        uint64_t dataFragments = i - i / 3;
+
+        if (dataFragments < (uint64_t) i) {
+            auto codedList = make_shared<BlockProposalFragmentList>(i, i, dataFragments);
+
+            REQUIRE(codedList->isErasureCoded());
+
+            // parity fragments first, so that decoding is exercised
+            uint64_t added = 0;
+
+            for (int j = i; j >= 1 && !codedList->isComplete(); j--) {
+                codedList->addFragment(t->getErasureCodedFragment(i, dataFragments, j), next, dataFragments);
+                added++;
+            }
+
+            REQUIRE(added == dataFragments);
+            REQUIRE(next == 0);
+
+            auto imp = CommittedBlock::defragment(codedList, cryptoManager);
+
+            REQUIRE(imp != nullptr);
+
+            REQUIRE(*imp->serialize() == *t->serialize());
+        }
+
     }
 
 
@@ -154,6 +180,8 @@ void test_tx_serialize_deserialize(bool _fail) {
             } else {
                 auto imp = Transaction::deserialize(out, 0, out->size(), true);
                 REQUIRE(imp != nullptr);
+                // the same bytes resolve to the already hashed object
+                REQUIRE(imp == t);
             }
         }
     }
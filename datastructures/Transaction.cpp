@@ -36,6 +36,7 @@
 #include "Log.h"
 #include "chains/Schain.h"
 #include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
 
 
 
@@ -45,33 +46,68 @@
 
 ptr< SHAHash > Transaction::getHash() {
 
-    LOCK(m)
-
-    if ( hash )
-        return hash;
+    if ( !hashCalculated ) {
+        call_once( hashOnce, [this]() { setHash( SHAHash::calculateHash( data ) ); } );
+    }
 
-    hash = SHAHash::calculateHash(data);
     return hash;
+}
+
+
+void Transaction::setHash( ptr< SHAHash > _hash ) {
+
+    CHECK_ARGUMENT( _hash != nullptr );
 
+    auto partial = make_shared< partial_sha_hash >();
+
+    for ( size_t i = 0; i < PARTIAL_SHA_HASH_LEN; i++ ) {
+        partial->at( i ) = _hash->at( i );
+    }
+
+    hash = _hash;
+    partialHash = partial;
+    hashCalculated = true;
 }
 
 
-ptr< partial_sha_hash > Transaction::getPartialHash() {
+void Transaction::calculateHashes(const vector<ptr<Transaction>> &_transactions) {
 
-    LOCK(m)
+    vector<ptr<Transaction>> unhashed;
 
-    if ( partialHash ) {
-        return partialHash;
+    for (auto &&t : _transactions) {
+        CHECK_ARGUMENT(t != nullptr);
+        if (!t->hashCalculated)
+            unhashed.push_back(t);
     }
 
-    partialHash = make_shared<partial_sha_hash >();
+    if (unhashed.empty())
+        return;
 
-    getHash();
+    vector<const uint8_t *> items(unhashed.size());
+    vector<uint64_t> lens(unhashed.size());
+    vector<uint8_t> digests(unhashed.size() * SHA_HASH_LEN);
 
-    for ( size_t i = 0; i < PARTIAL_SHA_HASH_LEN; i++ ) {
-        partialHash->at( i ) = hash->at( i );
+    for (uint64_t i = 0; i < unhashed.size(); i++) {
+        items[i] = unhashed[i]->data->data();
+        lens[i] = unhashed[i]->data->size();
+    }
+
+    SHA256Hasher::hashMany(unhashed.size(), items.data(), lens.data(), digests.data());
+
+    for (uint64_t i = 0; i < unhashed.size(); i++) {
+        auto t = unhashed[i];
+        // a concurrent getHash() may have won, then the digest is simply dropped
+        call_once(t->hashOnce, [&]() {
+            auto digest = make_shared<array<uint8_t, SHA_HASH_LEN>>();
+            memcpy(digest->data(), digests.data() + i * SHA_HASH_LEN, SHA_HASH_LEN);
+            t->setHash(make_shared<SHAHash>(digest));
+        });
     }
+}
 
+
+ptr< partial_sha_hash > Transaction::getPartialHash() {
+    getHash();
     return partialHash;
 }
 
@@ -129,6 +165,10 @@ ptr< vector< uint8_t > > Transaction::getData() const {
 
 atomic<int64_t>  Transaction::totalObjects(0);
 
+recursive_mutex Transaction::internedTransactionsLock;
+
+cache::lru_cache<uint64_t, weak_ptr<Transaction>> Transaction::internedTransactions(INTERNED_TRANSACTIONS_CACHE_SIZE);
+
 
 Transaction::~Transaction() {
     totalObjects--;
@@ -144,8 +184,6 @@ uint64_t Transaction::getSerializedSize(bool _writePartialHash) {
 
 void Transaction::serializeInto( ptr< vector< uint8_t > > _out, bool _writePartialHash ) {
 
-    LOCK(m)
-
     CHECK_ARGUMENT( _out != nullptr )
     _out->insert( _out->end(), data->begin(), data->end() );
 
@@ -170,13 +208,67 @@ ptr<Transaction > Transaction::deserialize(
 
     CHECK_ARGUMENT(_len > 0);
 
-    auto transactionData = make_shared<vector<uint8_t>>(data->begin() + _startIndex,
-                                                        data->begin() + _startIndex + _len);
+    uint64_t dataLen = _len;
+
+    if (_verifyPartialHashes) {
+        CHECK_ARGUMENT(_len > PARTIAL_SHA_HASH_LEN);
+        dataLen -= PARTIAL_SHA_HASH_LEN;
+    }
+
+    auto begin = data->data() + _startIndex;
+
+    auto key = internKey(begin, dataLen);
+
+    auto interned = findInterned(key, begin, dataLen);
+
+    if (interned) {
+        if (_verifyPartialHashes) {
+            CHECK_ARGUMENT2(memcmp(interned->getPartialHash()->data(), begin + dataLen, PARTIAL_SHA_HASH_LEN) == 0,
+                            "Transaction partial hash does not match");
+        }
+        return interned;
+    }
+
+    ptr<vector<uint8_t>> transactionData;
+
+    if (_startIndex == 0 && _len == data->size() && !_verifyPartialHashes) {
+        // the buffer holds exactly this transaction and is not modified, share it
+        transactionData = data;
+    } else {
+        transactionData = make_shared<vector<uint8_t>>(data->begin() + _startIndex,
+                                                       data->begin() + _startIndex + _len);
+    }
+
+    auto transaction = make_shared<Transaction>(transactionData, _verifyPartialHashes);
+
+    LOCK(internedTransactionsLock)
+    internedTransactions.put(key, transaction);
+
+    return transaction;
+}
 
 
+uint64_t Transaction::internKey(const uint8_t *_data, uint64_t _len) {
+    return std::hash<string_view>()(string_view((const char *) _data, _len));
+}
+
+
+ptr<Transaction> Transaction::findInterned(uint64_t _key, const uint8_t *_data, uint64_t _len) {
+
+    ptr<Transaction> result;
+
+    {
+        LOCK(internedTransactionsLock)
+        if (!internedTransactions.exists(_key))
+            return nullptr;
+        result = internedTransactions.get(_key).lock();
+    }
 
-    return make_shared<Transaction>(transactionData, _verifyPartialHashes);
+    // the key is not cryptographic, so the bytes have to match too
+    if (result == nullptr || result->data->size() != _len || memcmp(result->data->data(), _data, _len) != 0)
+        return nullptr;
 
+    return result;
 }
 
 
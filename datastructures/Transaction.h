@@ -31,6 +31,7 @@
 
 
 #include "datastructures/DataStructure.h"
+#include "thirdparty/lrucache.hpp"
 
 class SHAHash;
 
@@ -42,12 +43,28 @@ class Transaction : public DataStructure {
 
     static atomic<int64_t>  totalObjects;
 
+    // transactions by a fast hash of their bytes, so that bytes seen again reuse the hashed object
+    static recursive_mutex internedTransactionsLock;
+
+    static cache::lru_cache<uint64_t, weak_ptr<Transaction>> internedTransactions;
+
     ptr<vector<uint8_t >> data = nullptr;
 
+    // set once by hashOnce, read without locking afterwards
     ptr<SHAHash> hash = nullptr;
 
     ptr<partial_sha_hash> partialHash = nullptr;
 
+    once_flag hashOnce;
+
+    atomic<bool> hashCalculated = false;
+
+    void setHash(ptr<SHAHash> _hash);
+
+    static uint64_t internKey(const uint8_t *_data, uint64_t _len);
+
+    static ptr<Transaction> findInterned(uint64_t _key, const uint8_t *_data, uint64_t _len);
+
 
 public:
 
@@ -65,11 +82,19 @@ public:
 
     ptr<SHAHash> getHash();
 
+    /**
+     * Hashes all transactions that do not have a hash yet in a single multi-buffer batch
+     */
+    static void calculateHashes(const vector<ptr<Transaction>> &_transactions);
+
     ptr<partial_sha_hash> getPartialHash();
 
     virtual ~Transaction();
 
 
+    /**
+     * Returns the already hashed transaction object if the same bytes have been seen before
+     */
     static ptr<Transaction > deserialize(
             const ptr< vector< uint8_t > > data, uint64_t _startIndex, uint64_t _len, bool _verifyPartialHashes );
 
@@ -145,14 +145,16 @@ size_t TransactionList::size() {
 }
 
 
-ptr<ConsensusExtFace::transactions_vector> TransactionList::createTransactionVector() {
+ptr<ConsensusExtFace::transaction_views> TransactionList::createTransactionViews() {
 
     LOCK(m)
 
-    auto tv = make_shared<ConsensusExtFace::transactions_vector >();
+    auto tv = make_shared<ConsensusExtFace::transaction_views >();
+
+    tv->reserve(transactions->size());
 
     for ( auto&& t : *getItems() ) {
-        tv->push_back( *( t->getData() ) );
+        tv->emplace_back( t->getData() );
     }
     return tv;
 }
@@ -213,3 +215,7 @@ uint64_t TransactionList::hashCount() {
 ptr<SHAHash> TransactionList::getHash(uint64_t _index) {
     return transactions->at(_index)->getHash();
 };
+
+void TransactionList::calculateHashes() {
+    Transaction::calculateHashes(*transactions);
+}
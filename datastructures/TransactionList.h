@@ -72,7 +72,10 @@ public:
 
     virtual ~TransactionList();
 
-    ptr<ConsensusExtFace::transactions_vector> createTransactionVector();
+    /**
+     * Views share the transaction buffers, nothing is copied
+     */
+    ptr<ConsensusExtFace::transaction_views> createTransactionViews();
 
 
     ptr< vector< uint64_t > > createTransactionSizesVector(bool _writePartialHash);
@@ -87,6 +90,10 @@ public:
     ptr<SHAHash> getHash(uint64_t _index);
 
     uint64_t hashCount() override;
+
+protected:
+
+    void calculateHashes() override;
 };
 
 
@@ -48,9 +48,11 @@ BlockSigShareDB::BlockSigShareDB(Schain *_sChain, string &_dirName, string &_pre
 
 
 ptr<ThresholdSignature>
-BlockSigShareDB::checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<CryptoManager> _cryptoManager) {
+BlockSigShareDB::checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<SHAHash> _hash,
+                                   ptr<CryptoManager> _cryptoManager) {
     try {
         CHECK_ARGUMENT(_sigShare != nullptr);
+        CHECK_ARGUMENT(_hash != nullptr);
         CHECK_ARGUMENT(_cryptoManager != nullptr);
         auto sigShareString = _sigShare->toString();
 
@@ -61,20 +63,33 @@ BlockSigShareDB::checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<CryptoM
         if (enoughSet == nullptr)
             return nullptr;
 
-        auto s = _cryptoManager->createSigShareSet(_sigShare->getBlockId());
+        vector<ptr<ThresholdSigShare>> sigShares;
 
         for (auto &&item : *enoughSet) {
             auto nodeInfo = sChain->getNode()->getNodeInfoByIndex(item.first);
             CHECK_STATE(nodeInfo != nullptr);
-            auto sigShare = _cryptoManager->createSigShare(item.second, sChain->getSchainID(),
-                                                           _sigShare->getBlockId(), item.first);
-            s->addSigShare(sigShare);
+            sigShares.push_back(_cryptoManager->createSigShare(item.second, sChain->getSchainID(),
+                                                               _sigShare->getBlockId(), item.first));
         }
 
+        vector<schain_index> badShares;
+
+        auto signature = _cryptoManager->mergeSigShares(_hash, _sigShare->getBlockId(), sigShares, badShares,
+                                                        _sigShare->getSignerIndex());
+
+        // without known bad shares, retry with every further share
+        setRetryOnNextShare(_sigShare->getBlockId(), signature == nullptr && badShares.empty());
+
+        if (signature == nullptr) {
+            // the set completes again when enough good shares arrive
+            for (auto &&index : badShares) {
+                LOG(warn, "Block sig share did not verify:BID:" + to_string(_sigShare->getBlockId()) +
+                          ":SIGNER:" + to_string(index));
+                removeFromSet(_sigShare->getBlockId(), index);
+            }
+            return nullptr;
+        }
 
-        CHECK_STATE(s->isEnough());
-        auto signature = s->mergeSignature();
-        CHECK_STATE(signature != nullptr);
         return signature;
     } catch (ExitRequestedException &) { throw; } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
@@ -31,6 +31,7 @@ class ThresholdSignature;
 #include "CacheLevelDB.h"
 
 class CryptoManager;
+class SHAHash;
 
 class BlockSigShareDB : public CacheLevelDB {
 
@@ -43,7 +44,8 @@ public:
 
     BlockSigShareDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId, uint64_t _maxDBSize);
 
-    ptr<ThresholdSignature> checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<CryptoManager> _cryptoManager);
+    ptr<ThresholdSignature> checkAndSaveShare(ptr<ThresholdSigShare> _sigShare, ptr<SHAHash> _hash,
+                                              ptr<CryptoManager> _cryptoManager);
 
 };
 
@@ -171,6 +171,65 @@ void CacheLevelDB::writeString(const string &_key, const string &_value,
 }
 
 
+void CacheLevelDB::writeStringToBatch(const string &_key, const string &_value, bool _overWrite) {
+
+    bool isFull;
+
+    {
+        lock_guard<mutex> lock(batchMutex);
+
+        // same as writeString(), the first value written stays
+        if (!_overWrite) {
+            if (pendingBatchKeys.count(_key) > 0 || keyExists(_key)) {
+                LOG(trace, "Double db entry " + this->prefix + "\n" + _key);
+                return;
+            }
+            pendingBatchKeys.insert(_key);
+        }
+
+        if (pendingBatch == nullptr)
+            pendingBatch = make_shared<WriteBatch>();
+
+        pendingBatch->Put(_key, _value);
+        isFull = ++pendingBatchWrites >= MAX_DB_BATCH_WRITES;
+    }
+
+    if (isFull)
+        flushBatch();
+}
+
+
+void CacheLevelDB::flushBatch() {
+
+    ptr<WriteBatch> batch;
+
+    {
+        lock_guard<mutex> lock(batchMutex);
+
+        if (pendingBatchWrites == 0)
+            return;
+
+        rotateDBsIfNeeded();
+
+        batch = pendingBatch;
+        pendingBatch = nullptr;
+        pendingBatchWrites = 0;
+        pendingBatchKeys.clear();
+
+        // written under batchMutex, so that batches reach the DB in the order they were collected
+        shared_lock<shared_mutex> dbLock(m);
+        auto status = db.back()->Write(writeOptions, batch.get());
+        throwExceptionOnError(status);
+    }
+}
+
+
+uint64_t CacheLevelDB::getPendingBatchWrites() {
+    lock_guard<mutex> lock(batchMutex);
+    return pendingBatchWrites;
+}
+
+
 void CacheLevelDB::writeByteArray(const char *_key, size_t _keyLen, const char *value,
                                   size_t _valueLen) {
 
@@ -555,6 +614,7 @@ CacheLevelDB::writeByteArrayToSetUnsafe(const char *_value, uint64_t _valueLen,
 
 
     CHECK_ARGUMENT(_index > 0 && _index <= totalSigners);
+    CHECK_ARGUMENT(_valueLen > 0);
 
 
     string entryKey = createSetKey(_blockId, _index);
@@ -604,10 +664,16 @@ CacheLevelDB::writeByteArrayToSetUnsafe(const char *_value, uint64_t _valueLen,
     }
 
 
-    if (count != requiredSigners) {
+    if (count < requiredSigners) {
         return nullptr;
     }
 
+    if (count > requiredSigners) {
+        lock_guard<mutex> lock(retrySetsMutex);
+        if (retrySets.count(_blockId) == 0)
+            return nullptr;
+    }
+
 
     auto enoughSet = make_shared<map<schain_index, ptr<string>>>();
 
@@ -615,19 +681,57 @@ CacheLevelDB::writeByteArrayToSetUnsafe(const char *_value, uint64_t _valueLen,
         auto key = createSetKey(_blockId, schain_index(i));
         auto entry = readStringUnsafe(key);
 
-        if (entry != nullptr)
+        if (entry != nullptr && !entry->empty())
             (*enoughSet)[schain_index(i)] = entry;
-        if (enoughSet->size() == requiredSigners) {
-            break;
-        }
     }
 
-    CHECK_STATE(enoughSet->size() == requiredSigners);
+    CHECK_STATE(enoughSet->size() >= requiredSigners);
 
     return enoughSet;
 
 }
 
+// a removed entry is kept empty, so that the same index can not be added to the set again
+void CacheLevelDB::removeFromSet(block_id _blockId, schain_index _index) {
+
+    CHECK_ARGUMENT(_index > 0 && _index <= totalSigners);
+
+    shared_lock<shared_mutex> lock(m);
+
+    auto entryKey = createSetKey(_blockId, _index);
+    auto counterKey = createCounterKey(_blockId);
+
+    for (int i = LEVELDB_PIECES - 1; i >= 0; i--) {
+        string counter;
+        ASSERT(db[i] != nullptr);
+        auto status = db[i]->Get(readOptions, counterKey, &counter);
+        throwExceptionOnError(status);
+        if (status.IsNotFound())
+            continue;
+
+        auto count = stoull(counter, NULL, 10);
+        CHECK_STATE(count > 0);
+
+        leveldb::WriteBatch batch;
+        batch.Put(counterKey, to_string(count - 1));
+        batch.Put(entryKey, "");
+        CHECK_STATE2(db[i]->Write(writeOptions, &batch).ok(), "Could not write LevelDB");
+        return;
+    }
+
+    CHECK_STATE2(false, "Set entry to remove does not exist");
+}
+
+void CacheLevelDB::setRetryOnNextShare(block_id _blockId, bool _retry) {
+    lock_guard<mutex> lock(retrySetsMutex);
+
+    if (_retry) {
+        retrySets.insert(_blockId);
+    } else {
+        retrySets.erase(_blockId);
+    }
+}
+
 void CacheLevelDB::verify() {
 
     CHECK_STATE(db.size() == LEVELDB_PIECES);
@@ -36,6 +36,8 @@ namespace leveldb {
     class Status;
 
     class Slice;
+
+    class WriteBatch;
 }
 
 
@@ -64,17 +66,37 @@ protected:
     bool isDuplicateAddOK;
     Schain* sChain;
 
+    // sets that did not merge into a valid signature, offered again with every new share
+    mutex retrySetsMutex;
+    set<block_id> retrySets;
+
+    // writes collected by writeStringToBatch() until the next flushBatch()
+    mutex batchMutex;
+    ptr<leveldb::WriteBatch> pendingBatch;
+    uint64_t pendingBatchWrites = 0;
+    // keys in the pending batch that must not be overwritten
+    set<string> pendingBatchKeys;
+
     ptr<string> readString(string &_key);
     ptr<string> readStringUnsafe(string &_key);
 
     void writeString(const string &key1, const string &value1, bool overWrite = false);
 
+    void writeStringToBatch(const string &_key, const string &_value, bool _overWrite = true);
+
     ptr<map<schain_index, ptr<string>>>
     writeStringToSet(const string &_value, block_id _blockId, schain_index _index);
 
         ptr<map<schain_index, ptr<string>>>
     writeByteArrayToSet(const char *_value, uint64_t _valueLen, block_id _blockId, schain_index _index);
 
+    void removeFromSet(block_id _blockId, schain_index _index);
+
+    /**
+     * If _retry is set, every further share written to the set returns all of its entries
+     */
+    void setRetryOnNextShare(block_id _blockId, bool _retry);
+
     void writeByteArray(const char *_key, size_t _keyLen, const char *value,
                         size_t _valueLen);
     void writeByteArray(string &_key, ptr<vector<uint8_t>> _data);
@@ -147,6 +169,14 @@ public:
 
 
     ptr<string> readLastKeyInPrefixRange(string &_prefix);
+
+    /**
+     * Writes everything collected by writeStringToBatch() as one LevelDB write batch
+     */
+    void flushBatch();
+
+    uint64_t getPendingBatchWrites();
+
 private:
     std::string path_to_index(uint64_t index);
 };
@@ -105,10 +105,40 @@ ConsensusStateDB::createAUXVoteKey(block_id _blockId, schain_index _proposerInde
 }
 
 
+ptr<string> ConsensusStateDB::createSnapshotKey(block_id _blockId, schain_index _proposerIndex) {
+    auto key = createKey(_blockId, _proposerIndex);
+    key->append(":snp");
+    return key;
+}
+
+
+// reads keys of the given type, one prefix scan per round if the range is bounded
+ptr<map<string, ptr<string>>>
+ConsensusStateDB::readRoundRange(block_id _blockId, schain_index _proposerIndex, const string &_type,
+                                 bin_consensus_round _fromRound, bin_consensus_round _toRound) {
+
+    auto prefix = *createKey(_blockId, _proposerIndex) + _type;
+
+    if (_toRound == ALL_ROUNDS)
+        return readPrefixRange(prefix);
+
+    auto result = make_shared<map<string, ptr<string>>>();
+
+    for (uint64_t r = (uint64_t) _fromRound; r <= (uint64_t) _toRound; r++) {
+        auto roundPrefix = prefix + to_string(r) + ":";
+        auto keysAndValues = readPrefixRange(roundPrefix);
+        if (keysAndValues != nullptr)
+            result->insert(keysAndValues->begin(), keysAndValues->end());
+    }
+
+    return result;
+}
+
+
 void ConsensusStateDB::writeCR(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r) {
 #ifdef CONSENSUS_STATE_PERSISTENCE
     auto key = createCurrentRoundKey(_blockId, _proposerIndex);
-    writeString(*key, to_string((uint64_t) _r), true);
+    writeStringToBatch(*key, to_string((uint64_t) _r));
 #endif
 }
 
@@ -127,7 +157,7 @@ bin_consensus_round ConsensusStateDB::readCR(block_id _blockId, schain_index _pr
 void ConsensusStateDB::writeDR(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r) {
 #ifdef CONSENSUS_STATE_PERSISTENCE
     auto key = createDecidedRoundKey(_blockId, _proposerIndex);
-    writeString(*key, to_string((uint64_t) _r));
+    writeStringToBatch(*key, to_string((uint64_t) _r), false);
 #endif
 }
 
@@ -147,7 +177,7 @@ void ConsensusStateDB::writeDV(block_id _blockId, schain_index _proposerIndex, b
     CHECK_ARGUMENT(_v <= 1)
 
     auto key = createDecidedValueKey(_blockId, _proposerIndex);
-    writeString(*key, to_string((uint32_t) (uint8_t) _v));
+    writeStringToBatch(*key, to_string((uint32_t) (uint8_t) _v), false);
 #endif
 }
 
@@ -167,7 +197,7 @@ void ConsensusStateDB::writePr(block_id _blockId, schain_index _proposerIndex, b
 #ifdef CONSENSUS_STATE_PERSISTENCE
     CHECK_ARGUMENT(_v <= 1)
     auto key = createProposalKey(_blockId, _proposerIndex, _r);
-    writeString(*key, to_string((uint32_t) (uint8_t) _v));
+    writeStringToBatch(*key, to_string((uint32_t) (uint8_t) _v), false);
 #endif
 }
 
@@ -191,17 +221,18 @@ void ConsensusStateDB::writeBVBVote(block_id _blockId, schain_index _proposerInd
 #ifdef CONSENSUS_STATE_PERSISTENCE
     CHECK_ARGUMENT(_v <= 1)
     auto key = createBVBVoteKey(_blockId, _proposerIndex, _r, _voterIndex, _v);
-    writeString(*key, "");
+    writeStringToBatch(*key, "");
 #endif
 
 }
 
 pair<ptr<map<bin_consensus_round, set<schain_index>>>,
         ptr<map<bin_consensus_round, set<schain_index>>>>
-ConsensusStateDB::readBVBVotes(block_id _blockId, schain_index _proposerIndex) {
+ConsensusStateDB::readBVBVotes(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _fromRound,
+                               bin_consensus_round _toRound) {
 
     auto prefix = createKey(_blockId, _proposerIndex)->append(":bvb:");
-    auto keysAndValues = readPrefixRange(prefix);
+    auto keysAndValues = readRoundRange(_blockId, _proposerIndex, ":bvb:", _fromRound, _toRound);
 
     auto trueMap = make_shared<map<bin_consensus_round, set<schain_index>>>();
     auto falseMap = make_shared<map<bin_consensus_round, set<schain_index>>>();
@@ -223,6 +254,9 @@ ConsensusStateDB::readBVBVotes(block_id _blockId, schain_index _proposerIndex) {
         CHECK_STATE(info.get() == ':');
         info >> value;
 
+        if (round < _fromRound)
+            continue;
+
         ptr<map<bin_consensus_round, set<schain_index>>> outputMap;
         outputMap = (value > 0  ? trueMap : falseMap);
         (*outputMap)[bin_consensus_round(round)].insert(schain_index(voterIndex));
@@ -237,17 +271,30 @@ void ConsensusStateDB::writeBinValue(block_id _blockId, schain_index _proposerIn
 #ifdef CONSENSUS_STATE_PERSISTENCE
     CHECK_ARGUMENT(_v <= 1)
     auto key = createBinValueKey(_blockId, _proposerIndex, _r, _v);
-    writeString(*key, "");
+    writeStringToBatch(*key, "");
 #endif
 }
 
+void ConsensusStateDB::writeSnapshot(block_id _blockId, schain_index _proposerIndex, const string &_snapshot) {
+#ifdef CONSENSUS_STATE_PERSISTENCE
+    auto key = createSnapshotKey(_blockId, _proposerIndex);
+    writeStringToBatch(*key, _snapshot);
+#endif
+}
+
+ptr<string> ConsensusStateDB::readSnapshot(block_id _blockId, schain_index _proposerIndex) {
+    auto key = createSnapshotKey(_blockId, _proposerIndex);
+    return readString(*key);
+}
+
 ptr<map<bin_consensus_round, set<bin_consensus_value>>>
-ConsensusStateDB::readBinValues(block_id _blockId, schain_index _proposerIndex) {
+ConsensusStateDB::readBinValues(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _fromRound,
+                                bin_consensus_round _toRound) {
 
     auto result = make_shared<map<bin_consensus_round, set<bin_consensus_value>>>();
 
     auto prefix = createKey(_blockId, _proposerIndex)->append(":bin:");
-    auto keysAndValues = readPrefixRange(prefix);
+    auto keysAndValues = readRoundRange(_blockId, _proposerIndex, ":bin:", _fromRound, _toRound);
 
     if (keysAndValues == nullptr) {
         return result;
@@ -263,6 +310,8 @@ ConsensusStateDB::readBinValues(block_id _blockId, schain_index _proposerIndex)
         info >> round;
         CHECK_STATE(info.get() == ':');
         info >> value;
+        if (round < _fromRound)
+            continue;
         bin_consensus_value b(value > 0 ? 1 : 0);
         (*result)[bin_consensus_round(round)].insert(b);
     }
@@ -274,7 +323,7 @@ ConsensusStateDB::readPRs(block_id _blockId, schain_index _proposerIndex) {
 
     auto result = make_shared<map<bin_consensus_round, bin_consensus_value>>();
 
-    auto prefix = createKey(_blockId, _proposerIndex)->append(":pr:");
+    auto prefix = createKey(_blockId, _proposerIndex)->append(":prp:");
     auto keysAndValues = readPrefixRange(prefix);
 
     if (keysAndValues == nullptr) {
@@ -306,14 +355,15 @@ void ConsensusStateDB::writeAUXVote(block_id _blockId, schain_index _proposerInd
     CHECK_ARGUMENT(_v <= 1);
     CHECK_ARGUMENT(_sigShare);
     auto key = createAUXVoteKey(_blockId, _proposerIndex, _r, _voterIndex, _v);
-    writeString(*key, *_sigShare);
+    writeStringToBatch(*key, *_sigShare);
 #endif
 
 }
 
 pair<ptr<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>>,
         ptr<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>>>
-ConsensusStateDB::readAUXVotes(block_id _blockId, schain_index _proposerIndex, ptr<CryptoManager> _cryptoManager) {
+ConsensusStateDB::readAUXVotes(block_id _blockId, schain_index _proposerIndex, ptr<CryptoManager> _cryptoManager,
+                               bin_consensus_round _fromRound, bin_consensus_round _toRound) {
 
     CHECK_ARGUMENT(_cryptoManager);
 
@@ -322,7 +372,7 @@ ConsensusStateDB::readAUXVotes(block_id _blockId, schain_index _proposerIndex, p
 
 
     auto prefix = createKey(_blockId, _proposerIndex)->append(":aux:");
-    auto keysAndValues = readPrefixRange(prefix);
+    auto keysAndValues = readRoundRange(_blockId, _proposerIndex, ":aux:", _fromRound, _toRound);
 
     if (keysAndValues == nullptr) {
         return {trueMap, falseMap};
@@ -340,6 +390,9 @@ ConsensusStateDB::readAUXVotes(block_id _blockId, schain_index _proposerIndex, p
         CHECK_STATE(info.get() == ':');
         info >> value;
 
+        if (round < _fromRound)
+            continue;
+
         ptr<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>> outputMap;
         outputMap = (value > 0  ? trueMap : falseMap);
 
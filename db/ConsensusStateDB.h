@@ -29,7 +29,12 @@
 #include "CacheLevelDB.h"
 
 class CryptoManager;
+class ThresholdSigShare;
 
+/**
+ * Binary consensus state. Writes are collected into a batch, which is flushed after each processed
+ * message batch and before any outgoing message is broadcast
+ */
 class ConsensusStateDB : public CacheLevelDB {
 
     const string getFormatVersion();
@@ -52,9 +57,16 @@ class ConsensusStateDB : public CacheLevelDB {
     ptr<string> createAUXVoteKey(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
                                  schain_index _voterIndex, bin_consensus_value _v);
 
+    ptr<string> createSnapshotKey(block_id _blockId, schain_index _proposerIndex);
+
+    ptr<map<string, ptr<string>>> readRoundRange(block_id _blockId, schain_index _proposerIndex,
+                                                 const string &_type, bin_consensus_round _fromRound,
+                                                 bin_consensus_round _toRound);
 
 public:
 
+    static constexpr uint64_t ALL_ROUNDS = UINT64_MAX;
+
     ConsensusStateDB(Schain *_sChain, string &_dirName, string &_prefix, node_id _nodeId,
                      uint64_t _maxDBSize);
 
@@ -76,6 +88,10 @@ public:
     void writeBinValue(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _r,
                        bin_consensus_value _v);
 
+    void writeSnapshot(block_id _blockId, schain_index _proposerIndex, const string &_snapshot);
+
+    ptr<string> readSnapshot(block_id _blockId, schain_index _proposerIndex);
+
 
     bin_consensus_round readCR(block_id _blockId, schain_index _proposerIndex);
 
@@ -89,14 +105,17 @@ public:
 
     pair<ptr<map<bin_consensus_round, set<schain_index>>>,
             ptr<map<bin_consensus_round, set<schain_index>>>>
-    readBVBVotes(block_id _blockId, schain_index _proposerIndex);
+    readBVBVotes(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _fromRound = 0,
+                 bin_consensus_round _toRound = bin_consensus_round(ALL_ROUNDS));
 
     pair<ptr<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>>,
             ptr<map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>>>>
-    readAUXVotes(block_id _blockId, schain_index _proposerIndex, ptr<CryptoManager> _cryptoManager);
+    readAUXVotes(block_id _blockId, schain_index _proposerIndex, ptr<CryptoManager> _cryptoManager,
+                 bin_consensus_round _fromRound = 0, bin_consensus_round _toRound = bin_consensus_round(ALL_ROUNDS));
 
     ptr<map<bin_consensus_round, set<bin_consensus_value>>>
-    readBinValues(block_id _blockId, schain_index _proposerIndex);
+    readBinValues(block_id _blockId, schain_index _proposerIndex, bin_consensus_round _fromRound = 0,
+                  bin_consensus_round _toRound = bin_consensus_round(ALL_ROUNDS));
 
     ptr<map<bin_consensus_round, bin_consensus_value>> readPRs(block_id _blockId, schain_index _proposerIndex);
 };
@@ -79,21 +79,35 @@ ptr<DAProof> DASigShareDB::addAndMergeSigShareAndVerifySig(ptr<ThresholdSigShare
 
     if (result != nullptr) {
 
-        auto set = sChain->getCryptoManager()->createSigShareSet(_sigShare->getBlockId());
+        auto cryptoManager = sChain->getCryptoManager();
+
+        vector<ptr<ThresholdSigShare>> shares;
 
         for (auto && entry : *result) {
-            auto share = sChain->getCryptoManager()->createSigShare(
+            shares.push_back(cryptoManager->createSigShare(
                     entry.second, sChain->getSchainID(),
-                    _proposal->getBlockID(), entry.first);
-
-            set->addSigShare(share);
+                    _proposal->getBlockID(), entry.first));
         }
 
+        vector<schain_index> badShares;
+
+        auto sig = cryptoManager->mergeSigShares(_proposal->getHash(), _sigShare->getBlockId(), shares, badShares,
+                                                 _sigShare->getSignerIndex());
+
+        // without known bad shares, retry with every further share
+        setRetryOnNextShare(_sigShare->getBlockId(), sig == nullptr && badShares.empty());
+
+        if (sig == nullptr) {
+            // the set completes again when enough good shares arrive
+            for (auto &&index : badShares) {
+                LOG(warn, "DA sig share did not verify:BID:" + to_string(_sigShare->getBlockId()) +
+                          ":SIGNER:" + to_string(index));
+                removeFromSet(_sigShare->getBlockId(), index);
+            }
+            return nullptr;
+        }
 
         LOG(trace, "Merged signature");
-        auto sig = set->mergeSignature();
-        sChain->getCryptoManager()->verifyThresholdSig(
-                _proposal->getHash(), sig->toString(), _sigShare->getBlockId());
         auto proof = make_shared<DAProof>(_proposal, sig);
         return proof;
     }
@@ -41,6 +41,7 @@
 #include "chains/Schain.h"
 
 #include "BlockDB.h"
+#include "ConsensusStateDB.h"
 
 
 void test_committed_block_save() {
@@ -81,3 +82,65 @@ TEST_CASE("Save/read block", "[block-save-read-db]") {
         test_committed_block_save();
 }
 
+
+// exposes the write batch of CacheLevelDB, the ConsensusStateDB writers only use it with CONSENSUS_STATE_PERSISTENCE
+class BatchTestDB : public ConsensusStateDB {
+public:
+    BatchTestDB(Schain *_sChain, string &_dirName, string &_prefix)
+            : ConsensusStateDB(_sChain, _dirName, _prefix, node_id(1), 5000000) {}
+
+    using CacheLevelDB::writeStringToBatch;
+    using CacheLevelDB::readString;
+};
+
+
+TEST_CASE("Consensus state writes are batched", "[consensus-state-batch-db]") {
+
+    auto sChain = make_shared<Schain>();
+    static string dirName = "/tmp";
+    static string fileName = "test_consensus_state_batch";
+
+    if (std::system(("rm -rf " + dirName + "/" + fileName + "*").c_str()) != 0) {
+        BOOST_THROW_EXCEPTION(runtime_error("Remove failed"));
+    }
+
+    auto db = make_shared<BatchTestDB>(sChain.get(), dirName, fileName);
+
+    for (uint64_t i = 1; i <= 16; i++) {
+        db->writeStringToBatch("vote:" + to_string(i), to_string(i));
+    }
+
+    REQUIRE(db->getPendingBatchWrites() == 16);
+
+    string key = "vote:1";
+    REQUIRE(db->readString(key) == nullptr);
+
+    db->flushBatch();
+
+    REQUIRE(db->getPendingBatchWrites() == 0);
+
+    for (uint64_t i = 1; i <= 16; i++) {
+        key = "vote:" + to_string(i);
+        REQUIRE(*db->readString(key) == to_string(i));
+    }
+
+    // decided values keep the first write, in the batch and on disk
+    key = "decided";
+    db->writeStringToBatch(key, "1", false);
+    db->writeStringToBatch(key, "0", false);
+
+    REQUIRE(db->getPendingBatchWrites() == 1);
+
+    db->flushBatch();
+    db->writeStringToBatch(key, "0", false);
+
+    REQUIRE(db->getPendingBatchWrites() == 0);
+    REQUIRE(*db->readString(key) == "1");
+
+    // the current round is overwritten
+    key = "vote:1";
+    db->writeStringToBatch(key, "17");
+    db->flushBatch();
+
+    REQUIRE(*db->readString(key) == "17");
+}
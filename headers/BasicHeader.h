@@ -63,6 +63,7 @@ public:
     static constexpr const char *BV_BROADCAST = "B";
     static constexpr const char *AUX_BROADCAST = "A";
     static constexpr const char *BLOCK_SIG_BROADCAST = "S";
+    static constexpr const char *MESSAGE_BATCH = "Btch";
 
     BasicHeader(const char *_type);
 
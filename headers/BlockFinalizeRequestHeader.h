@@ -33,12 +33,15 @@ class BlockFinalizeRequestHeader : public AbstractBlockRequestHeader{
    fragment_index fragmentIndex;
    node_id        nodeID;
 
+   // zero if plain fragments are requested
+   uint64_t       dataFragments;
+
 
 public:
 
     BlockFinalizeRequestHeader(Schain &_sChain, block_id _blockID,
             schain_index _proposerIndex, node_id _nodeID,
-                               fragment_index _fragmentIndex);
+                               fragment_index _fragmentIndex, uint64_t _dataFragments = 0);
 
 
 
@@ -48,6 +48,9 @@ void BlockFinalizeResponseHeader::addFields(nlohmann::json &_j) {
     _j["blockHash"] = *blockHash;
     _j["fragmentSize"] = (uint64_t) fragmentSize;
     _j["blockSize"] = (uint64_t) blockSize;
+
+    if (dataFragments > 0)
+        _j["dataFragments"] = dataFragments;
 }
 
 void BlockFinalizeResponseHeader::setFragmentParams(uint64_t _fragmentSize, uint64_t _blockSize, ptr<string> _hash) {
@@ -62,3 +65,7 @@ void BlockFinalizeResponseHeader::setFragmentParams(uint64_t _fragmentSize, uint
     blockHash = _hash;
     setComplete();
 }
+
+void BlockFinalizeResponseHeader::setDataFragments(uint64_t _dataFragments) {
+    dataFragments = _dataFragments;
+}
@@ -32,11 +32,16 @@ class BlockFinalizeResponseHeader : public Header {
     uint64_t  blockSize = 0;
     ptr<string> blockHash = nullptr;
 
+    // zero if the fragment is a plain slice of the block
+    uint64_t  dataFragments = 0;
+
 
 public:
 
     void setFragmentParams(uint64_t _fragmentSize, uint64_t _blockSize, ptr<string> _hash);
 
+    void setDataFragments(uint64_t _dataFragments);
+
 
 
     BlockFinalizeResponseHeader();
@@ -45,11 +45,18 @@ CatchupRequestHeader::CatchupRequestHeader() : Header(Header::BLOCK_CATCHUP_REQ)
 }
 
 CatchupRequestHeader::CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex) :
+        CatchupRequestHeader(_sChain, _dstIndex, _sChain.getLastCommittedBlockID(), 0) {
+}
+
+CatchupRequestHeader::CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex, block_id _afterBlockID,
+                                           block_id _toBlockID) :
         CatchupRequestHeader() {
 
+    CHECK_ARGUMENT(_toBlockID == 0 || _toBlockID > _afterBlockID);
 
     this->schainID = _sChain.getSchainID();
-    this->blockID = _sChain.getLastCommittedBlockID();
+    this->blockID = _afterBlockID;
+    this->toBlockID = _toBlockID;
     this->nodeID = _sChain.getNode()->getNodeID();
 
     ASSERT(_sChain.getNode()->getNodeInfoByIndex(_dstIndex) != nullptr);
@@ -66,6 +73,9 @@ void CatchupRequestHeader::addFields(nlohmann::json& _j) {
     _j["blockID"] = (uint64_t ) blockID;
     _j["nodeID"] = (uint64_t) nodeID;
 
+    if (toBlockID != 0)
+        _j["toBlockID"] = (uint64_t) toBlockID;
+
 }
 
 const node_id &CatchupRequestHeader::getNodeId() const {
@@ -38,6 +38,7 @@ class CatchupRequestHeader : public Header{
 
     schain_id schainID;
     block_id blockID;
+    block_id toBlockID = 0;
     node_id nodeID;
 
 public:
@@ -47,6 +48,9 @@ public:
 
     CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex);
 
+    // request blocks (_afterBlockID, _toBlockID]
+    CatchupRequestHeader(Schain &_sChain, schain_index _dstIndex, block_id _afterBlockID, block_id _toBlockID);
+
 
     void addFields(nlohmann::basic_json<> &j) override;
 
@@ -57,7 +57,13 @@ void CatchupResponseHeader::addFields(nlohmann::json &_j) {
     if (blockSizes != nullptr)
         _j["sizes"] = *blockSizes;
 
+    _j["committedBlockID"] = (uint64_t) committedBlockID;
 
+
+}
+
+void CatchupResponseHeader::setCommittedBlockID(block_id _committedBlockID) {
+    committedBlockID = _committedBlockID;
 }
 
 uint64_t CatchupResponseHeader::getBlockCount() const {
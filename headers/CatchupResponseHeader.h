@@ -50,6 +50,8 @@ private:
 
     ptr<list<uint64_t>> blockSizes = nullptr;
 
+    block_id committedBlockID = 0;
+
 public:
 
     CatchupResponseHeader();
@@ -58,6 +60,8 @@ public:
 
     void setBlockSizes(ptr<list<uint64_t>> _blockSizes);
 
+    void setCommittedBlockID(block_id _committedBlockID);
+
     void addFields(nlohmann::basic_json<> &j_) override;
 
 };
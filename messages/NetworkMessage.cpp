@@ -38,6 +38,7 @@
 #include "exceptions/InvalidSchainException.h"
 #include "network/Buffer.h"
 #include "network/Network.h"
+#include "node/Node.h"
 #include "node/NodeInfo.h"
 #include "protocols/ProtocolKey.h"
 #include "protocols/binconsensus/AUXBroadcastMessage.h"
@@ -47,13 +48,14 @@
 #include "thirdparty/json.hpp"
 #include "utils/Time.h"
 #include <crypto/SHAHash.h>
+#include <crypto/SHA256Hasher.h>
 
 
 NetworkMessage::NetworkMessage(MsgType _messageType, block_id _blockID, schain_index _blockProposerIndex,
                                bin_consensus_round _r,
                                bin_consensus_value _value, uint64_t _timeMs, ProtocolInstance &_srcProtocolInstance)
         : Message(_srcProtocolInstance.getSchain()->getSchainID(),
-                  _messageType, _srcProtocolInstance.createNetworkMessageID(),
+                  _messageType, createMessageID(_srcProtocolInstance),
                   _srcProtocolInstance.getSchain()->getNode()->getNodeID(), _blockID,
                   _blockProposerIndex), BasicHeader(getTypeString(_messageType)) {
 
@@ -104,6 +106,24 @@ const ptr<string> &NetworkMessage::getECDSASig() const {
     return ecdsaSig;
 }
 
+void NetworkMessage::setECDSASig(const ptr<string> &_ecdsaSig) {
+    CHECK_ARGUMENT(_ecdsaSig != nullptr);
+    ecdsaSig = _ecdsaSig;
+}
+
+
+msg_id NetworkMessage::createMessageID(ProtocolInstance &_srcProtocolInstance) {
+    auto id = (uint64_t) _srcProtocolInstance.createNetworkMessageID();
+    if (_srcProtocolInstance.getSchain()->getNode()->isCompactBLSEncoding())
+        id |= COMPACT_BLS_FLAG;
+    return msg_id(id);
+}
+
+
+bool NetworkMessage::isCompactBLSAdvertised() const {
+    return ((uint64_t) msgID & COMPACT_BLS_FLAG) != 0;
+}
+
 
 bin_consensus_round NetworkMessage::getRound() const {
     return r;
@@ -146,6 +166,22 @@ void NetworkMessage::addFields(nlohmann::basic_json<> &j) {
 
 ptr<NetworkMessage> NetworkMessage::parseMessage(ptr<string> _header, Schain *_sChain) {
 
+    CHECK_ARGUMENT(_header);
+
+    nlohmann::json js;
+
+    try {
+        js = nlohmann::json::parse(*_header);
+    } catch (ExitRequestedException &) { throw; } catch (...) {
+        throw_with_nested(InvalidStateException("Could not parse message", __CLASS_NAME__));
+    }
+
+    return parseMessage(js, _sChain);
+}
+
+
+ptr<NetworkMessage> NetworkMessage::parseMessage(nlohmann::json &_js, Schain *_sChain) {
+
     uint64_t sChainID;
     uint64_t blockID;
     uint64_t blockProposerIndex;
@@ -159,13 +195,11 @@ ptr<NetworkMessage> NetworkMessage::parseMessage(ptr<string> _header, Schain *_s
     ptr<string> sigShare;
     ptr<string> ecdsaSig;
 
-    CHECK_ARGUMENT(_header);
     CHECK_ARGUMENT(_sChain);
 
     try {
 
-        auto js = nlohmann::json::parse(*_header);
-
+        auto &js = _js;
 
         sChainID = getUint64(js, "si");
         blockID = getUint64(js, "bi");
@@ -272,7 +306,7 @@ ptr<SHAHash> NetworkMessage::getHash() {
 
 
 ptr<SHAHash> NetworkMessage::calculateHash() {
-    CryptoPP::SHA256 sha3;
+    SHA256Hasher sha3;
 
     SHA3_UPDATE(sha3, schainID);
     SHA3_UPDATE(sha3, blockID);
@@ -285,21 +319,21 @@ ptr<SHAHash> NetworkMessage::calculateHash() {
 
     uint32_t typeLen = strlen(type);
     SHA3_UPDATE(sha3, typeLen);
-    sha3.Update((unsigned char*)type, strlen(type));
+    sha3.update((unsigned char*)type, strlen(type));
 
     uint32_t  sigShareLen = 0;
 
     if (sigShareString != nullptr) {
         sigShareLen = sigShareString->size();
         SHA3_UPDATE(sha3, sigShareLen);
-        sha3.Update((unsigned char *) sigShareString->data(), sigShareLen);
+        sha3.update((unsigned char *) sigShareString->data(), sigShareLen);
     } else {
         SHA3_UPDATE(sha3, sigShareLen);
     }
 
 
     auto buf = make_shared<array<uint8_t, SHA_HASH_LEN>>();
-    sha3.Final(buf->data());
+    sha3.final(buf->data());
     hash = make_shared<SHAHash>(buf);
     return hash;
 }
@@ -45,6 +45,9 @@ class ThresholdSignature;
 
 static constexpr uint64_t MAX_CONSENSUS_MESSAGE_LEN = 1024;
 
+// a batch of coalesced messages, each of them fits into MAX_CONSENSUS_MESSAGE_LEN
+static constexpr uint64_t MAX_CONSENSUS_BATCH_LEN = 65536;
+
 #include "headers/BasicHeader.h"
 
 class NetworkMessage : public Message, public BasicHeader {
@@ -77,6 +80,8 @@ protected:
 
     virtual ptr<SHAHash> calculateHash();
 
+    static msg_id createMessageID(ProtocolInstance &_srcProtocolInstance);
+
     void addFields(nlohmann::json &j) override;
 public:
     uint64_t getTimeMs() const;
@@ -84,6 +89,14 @@ public:
 
 public:
 
+    /**
+     * Set in the message id by nodes that parse the compact BLS encoding. The id is hashed and signed,
+     * and older nodes do not interpret it, so the flag is authenticated without changing the wire format
+     */
+    static constexpr uint64_t COMPACT_BLS_FLAG = (uint64_t) 1 << 63;
+
+    bool isCompactBLSAdvertised() const;
+
     void sign(ptr<CryptoManager> _mgr);
 
 
@@ -105,6 +118,8 @@ public:
 
     static ptr<NetworkMessage> parseMessage(ptr<string> _header, Schain* _sChain);
 
+    static ptr<NetworkMessage> parseMessage(nlohmann::json &_js, Schain* _sChain);
+
     static const char* getTypeString(MsgType _type );
 
     schain_index getSrcSchainIndex() const;
@@ -113,4 +128,6 @@ public:
 
     const ptr<string> &getECDSASig() const;
 
+    void setECDSASig(const ptr<string> &_ecdsaSig);
+
 };
@@ -0,0 +1,189 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file NetworkMessageBatch.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/ExitRequestedException.h"
+#include "exceptions/FatalError.h"
+#include "exceptions/InvalidMessageFormatException.h"
+#include "exceptions/InvalidSchainException.h"
+#include "chains/Schain.h"
+#include "crypto/CryptoManager.h"
+#include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
+#include "thirdparty/json.hpp"
+
+#include "NetworkMessageBatch.h"
+
+
+NetworkMessageBatch::NetworkMessageBatch(schain_id _schainID, schain_index _srcSchainIndex,
+                                         ptr<vector<ptr<NetworkMessage>>> _messages, ptr<string> _ecdsaSig)
+        : schainID(_schainID), srcSchainIndex(_srcSchainIndex), messages(_messages), ecdsaSig(_ecdsaSig) {
+
+    CHECK_ARGUMENT(_srcSchainIndex > 0);
+    CHECK_ARGUMENT(_messages);
+    CHECK_ARGUMENT(!_messages->empty() && _messages->size() <= MAX_MESSAGES);
+
+    auto emptySig = make_shared<string>("");
+
+    for (auto &&m : *_messages) {
+        CHECK_ARGUMENT(m);
+        CHECK_ARGUMENT(m->getSrcSchainIndex() == _srcSchainIndex);
+        if (m->getECDSASig() == nullptr)
+            m->setECDSASig(emptySig);
+    }
+}
+
+
+ptr<SHAHash> NetworkMessageBatch::calculateHash() {
+    SHA256Hasher sha3;
+
+    SHA3_UPDATE(sha3, schainID);
+    SHA3_UPDATE(sha3, srcSchainIndex);
+
+    uint64_t count = messages->size();
+    SHA3_UPDATE(sha3, count);
+
+    for (auto &&m : *messages) {
+        auto messageHash = m->getHash()->getHash();
+        sha3.update(messageHash->data(), messageHash->size());
+    }
+
+    auto buf = make_shared<array<uint8_t, SHA_HASH_LEN>>();
+    sha3.final(buf->data());
+    return make_shared<SHAHash>(buf);
+}
+
+
+ptr<SHAHash> NetworkMessageBatch::getHash() {
+    if (hash == nullptr)
+        hash = calculateHash();
+    return hash;
+}
+
+
+const ptr<string> &NetworkMessageBatch::getECDSASig() const {
+    return ecdsaSig;
+}
+
+
+void NetworkMessageBatch::setECDSASig(const ptr<string> &_ecdsaSig) {
+    CHECK_ARGUMENT(_ecdsaSig != nullptr);
+    ecdsaSig = _ecdsaSig;
+}
+
+
+schain_index NetworkMessageBatch::getSrcSchainIndex() const {
+    return srcSchainIndex;
+}
+
+
+ptr<vector<ptr<NetworkMessage>>> NetworkMessageBatch::getMessages() const {
+    return messages;
+}
+
+
+ptr<string> NetworkMessageBatch::serializeToString() {
+
+    CHECK_STATE(ecdsaSig);
+
+    // messages are already json objects, so the frame is assembled without parsing them again
+    auto s = make_shared<string>();
+    s->reserve(messages->size() * MAX_CONSENSUS_MESSAGE_LEN / 2);
+
+    s->append("{\"msgs\":[");
+
+    for (uint64_t i = 0; i < messages->size(); i++) {
+        if (i > 0)
+            s->push_back(',');
+        s->append(*messages->at(i)->serializeToString());
+    }
+
+    s->append("],\"si\":" + to_string((uint64_t) schainID) +
+              ",\"sig\":" + nlohmann::json(*ecdsaSig).dump() +
+              ",\"ssi\":" + to_string((uint64_t) srcSchainIndex) +
+              ",\"type\":\"" + BasicHeader::MESSAGE_BATCH + "\"}");
+
+    CHECK_STATE(s->size() < MAX_CONSENSUS_BATCH_LEN);
+
+    return s;
+}
+
+
+void NetworkMessageBatch::verify(ptr<CryptoManager> _mgr) {
+    CHECK_STATE2(_mgr->verifyNetworkMsgBatch(*this), "ECDSA batch sig did not verify");
+}
+
+
+bool NetworkMessageBatch::isBatch(nlohmann::json &_js) {
+    return _js.is_object() && _js.find("msgs") != _js.end();
+}
+
+
+ptr<NetworkMessageBatch> NetworkMessageBatch::parseBatch(nlohmann::json &_js, Schain *_sChain) {
+
+    CHECK_ARGUMENT(_sChain);
+
+    uint64_t sChainID;
+    uint64_t srcSchainIndex;
+    ptr<string> type;
+    ptr<string> ecdsaSig;
+
+    try {
+        sChainID = BasicHeader::getUint64(_js, "si");
+        srcSchainIndex = BasicHeader::getUint64(_js, "ssi");
+        type = BasicHeader::getString(_js, "type");
+        ecdsaSig = BasicHeader::getString(_js, "sig");
+    } catch (ExitRequestedException &) { throw; } catch (...) {
+        throw_with_nested(InvalidStateException("Could not parse message batch", __CLASS_NAME__));
+    }
+
+    if (*type != BasicHeader::MESSAGE_BATCH) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Unknown batch type:" + *type, __CLASS_NAME__));
+    }
+
+    if (_sChain->getSchainID() != sChainID) {
+        BOOST_THROW_EXCEPTION(InvalidSchainException("unknown Schain id" + to_string(sChainID), __CLASS_NAME__));
+    }
+
+    auto &items = _js["msgs"];
+
+    if (!items.is_array() || items.empty() || items.size() > MAX_MESSAGES) {
+        BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Incorrect message batch size", __CLASS_NAME__));
+    }
+
+    auto messages = make_shared<vector<ptr<NetworkMessage>>>();
+
+    for (auto &&item : items) {
+        auto m = NetworkMessage::parseMessage(item, _sChain);
+
+        // the batch signature only vouches for messages of its own sender
+        if (m->getSrcSchainIndex() != srcSchainIndex) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException("Foreign message in batch", __CLASS_NAME__));
+        }
+
+        messages->push_back(m);
+    }
+
+    return make_shared<NetworkMessageBatch>(schain_id(sChainID), schain_index(srcSchainIndex), messages, ecdsaSig);
+}
@@ -0,0 +1,76 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file NetworkMessageBatch.h
+    @author agent
+    @date 2026
+*/
+
+#pragma once
+
+#include "NetworkMessage.h"
+
+class CryptoManager;
+class SHAHash;
+class Schain;
+
+
+/**
+ * Network messages of one sender that travel to peers in a single frame with a single ECDSA signature.
+ * Messages inside the batch carry an empty signature, the batch signature covers their hashes.
+ */
+class NetworkMessageBatch {
+
+    schain_id schainID;
+
+    schain_index srcSchainIndex;
+
+    ptr<vector<ptr<NetworkMessage>>> messages;
+
+    ptr<SHAHash> hash;
+
+    ptr<string> ecdsaSig;
+
+    ptr<SHAHash> calculateHash();
+
+public:
+
+    // each message is shorter than MAX_CONSENSUS_MESSAGE_LEN, so a full batch fits into MAX_CONSENSUS_BATCH_LEN
+    static constexpr uint64_t MAX_MESSAGES = MAX_CONSENSUS_BATCH_LEN / MAX_CONSENSUS_MESSAGE_LEN - 1;
+
+    NetworkMessageBatch(schain_id _schainID, schain_index _srcSchainIndex,
+                        ptr<vector<ptr<NetworkMessage>>> _messages, ptr<string> _ecdsaSig = nullptr);
+
+    ptr<SHAHash> getHash();
+
+    const ptr<string> &getECDSASig() const;
+
+    void setECDSASig(const ptr<string> &_ecdsaSig);
+
+    schain_index getSrcSchainIndex() const;
+
+    ptr<vector<ptr<NetworkMessage>>> getMessages() const;
+
+    ptr<string> serializeToString();
+
+    void verify(ptr<CryptoManager> _mgr);
+
+    static bool isBatch(nlohmann::json &_js);
+
+    static ptr<NetworkMessageBatch> parseBatch(nlohmann::json &_js, Schain *_sChain);
+};
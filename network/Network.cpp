@@ -30,13 +30,17 @@
 #include "abstracttcpserver/ConnectionStatus.h"
 #include "blockproposal/pusher/BlockProposalClientAgent.h"
 #include "db/BlockProposalDB.h"
+#include "db/ConsensusStateDB.h"
 #include "blockproposal/server/BlockProposalWorkerThreadPool.h"
 #include "chains/Schain.h"
+#include "catchup/client/CatchupClientAgent.h"
 #include "crypto/ConsensusBLSSigShare.h"
+#include "crypto/CryptoManager.h"
 #include "crypto/SHAHash.h"
 #include "datastructures/BlockProposal.h"
 #include "exceptions/FatalError.h"
 #include "messages/NetworkMessage.h"
+#include "messages/NetworkMessageBatch.h"
 #include "node/Node.h"
 #include "node/NodeInfo.h"
 #include "protocols/binconsensus/AUXBroadcastMessage.h"
@@ -51,6 +55,7 @@
 #include "exceptions/InvalidMessageFormatException.h"
 #include "exceptions/InvalidSchainException.h"
 #include "exceptions/InvalidSourceIPException.h"
+#include "exceptions/NetworkProtocolException.h"
 #include "messages/Message.h"
 #include "protocols/blockconsensus/BlockConsensusAgent.h"
 
@@ -60,6 +65,7 @@
 #include "network/Sockets.h"
 #include "network/ZMQSockets.h"
 #include "threads/GlobalThreadRegistry.h"
+#include "utils/Time.h"
 
 TransportType Network::transport = TransportType::ZMQ;
 
@@ -118,65 +124,210 @@ ptr<vector<ptr<NetworkMessageEnvelope> > > Network::pullMessagesForCurrentBlockI
     return returnList;
 }
 
-void Network::addToDelayedSends(ptr<NetworkMessage> _m, ptr<NodeInfo> dstNodeInfo) {
-    CHECK_ARGUMENT(_m);
+void Network::addToDelayedSends(ptr<string> _frame, ptr<NodeInfo> dstNodeInfo) {
+    CHECK_ARGUMENT(_frame);
     CHECK_ARGUMENT(dstNodeInfo);
     auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
     LOCK(delayedSendsLocks.at(dstIndex - 1));
-    delayedSends.at(dstIndex - 1).push_back({_m, dstNodeInfo});
+    delayedSends.at(dstIndex - 1).push_back({_frame, dstNodeInfo});
     if (delayedSends.at(dstIndex - 1).size() > MAX_DELAYED_MESSAGE_SENDS) {
         delayedSends.at(dstIndex - 1).pop_front();
     }
 }
 
 void Network::broadcastMessage(ptr<NetworkMessage> _m) {
+    auto messages = make_shared<vector<ptr<NetworkMessage>>>();
+    messages->push_back(_m);
+    broadcastMessages(messages);
+}
 
+void Network::broadcastMessages(ptr<vector<ptr<NetworkMessage>>> _messages) {
 
-    if (_m->getBlockID() <= this->catchupBlocks) {
-        return;
-    }
+    CHECK_ARGUMENT(_messages);
 
     try {
 
+        // consensus state the messages depend on has to be on disk before the messages leave
+        getSchain()->getNode()->getConsensusStateDB()->flushBatch();
 
+        auto messages = make_shared<vector<ptr<NetworkMessage>>>();
 
-        // sign message before sending
-        _m->sign(getSchain()->getCryptoManager());
+        for (auto &&m : *_messages) {
+            CHECK_ARGUMENT(m);
+            if (m->getBlockID() > this->catchupBlocks)
+                messages->push_back(m);
+        }
 
-        getSchain()->getNode()->getOutgoingMsgDB()->saveMsg(_m);
+        if (messages->empty())
+            return;
 
-        unordered_set<uint64_t> sent;
+        if (messageCoalescingWindowMs > 0) {
+            addToCoalescedMessages(messages);
+            return;
+        }
 
-        // wait until we send to at least 2/3 of participants
-        while (3 * (sent.size() + 1) < getSchain()->getNodeCount() * 2) {
-            for (auto const &it : *getSchain()->getNode()->getNodeInfosByIndex()) {
-                auto dstNodeInfo = it.second;
-                auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
+        sendMessages(messages);
 
-                if (dstIndex != (getSchain()->getSchainIndex()) && !sent.count(dstIndex)) {
-                    if (sendMessage(it.second, _m)) {
-                        sent.insert(dstIndex);
-                    }
-                }
-            }
-        }
+    } catch (...) {
+        throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
+    }
+
+}
+
+void Network::sendMessages(ptr<vector<ptr<NetworkMessage>>> _messages) {
+
+    vector<future<ptr<string>>> sigFutures;
+
+    // start all signatures first, with SGX they arrive from a batched wallet request
+    for (auto &&m : *_messages) {
+        sigFutures.push_back(getSchain()->getCryptoManager()->signNetworkMsgAsync(*m));
+    }
+
+    auto frames = make_shared<vector<ptr<string>>>();
+
+    for (uint64_t i = 0; i < _messages->size(); i++) {
+        auto m = _messages->at(i);
+        m->setECDSASig(sigFutures[i].get());
+        getSchain()->getNode()->getOutgoingMsgDB()->saveMsg(m);
+        frames->push_back(m->serializeToString());
+    }
+
+    sendFrames(frames);
+}
+
+void Network::sendFrames(ptr<vector<ptr<string>>> _frames) {
+
+    CHECK_ARGUMENT(_frames);
 
-        // messages that could not be sent because the receiving nodes were not online are
-        // queued to delayed sends to be tried later. The delayed sends queue for
-        // each destination can have MAX_DELAYED_MESSAGE_SENDS
+    vector<ptr<NodeInfo>> destinations;
 
-        for (auto const &it : *getSchain()->getNode()->getNodeInfosByIndex()) {
-            auto dstNodeInfo = it.second;
+    for (auto const &it : *getSchain()->getNode()->getNodeInfosByIndex()) {
+        if (it.second->getSchainIndex() != getSchain()->getSchainIndex())
+            destinations.push_back(it.second);
+    }
+
+    // number of frames already sent to each destination, a destination gets the frames in order
+    map<uint64_t, uint64_t> sentCounts;
+    unordered_set<uint64_t> sent;
+
+    // wait until we send to at least 2/3 of participants
+    while (3 * (sent.size() + 1) < getSchain()->getNodeCount() * 2) {
+        for (auto const &dstNodeInfo : destinations) {
             auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
-            if (dstIndex != (getSchain()->getSchainIndex()) && !sent.count(dstIndex)) {
-                addToDelayedSends(_m, dstNodeInfo);
+
+            if (sent.count(dstIndex))
+                continue;
+
+            auto &count = sentCounts[dstIndex];
+
+            while (count < _frames->size() && sendBytes(dstNodeInfo, _frames->at(count))) {
+                count++;
             }
+
+            if (count == _frames->size())
+                sent.insert(dstIndex);
         }
+    }
 
-    } catch (...) {
-        throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
+    // frames that could not be sent because the receiving nodes were not online are
+    // queued to delayed sends to be tried later. The delayed sends queue for
+    // each destination can have MAX_DELAYED_MESSAGE_SENDS
+
+    for (auto const &dstNodeInfo : destinations) {
+        auto dstIndex = (uint64_t) dstNodeInfo->getSchainIndex();
+        for (uint64_t i = sentCounts[dstIndex]; i < _frames->size(); i++) {
+            addToDelayedSends(_frames->at(i), dstNodeInfo);
+        }
     }
+}
+
+void Network::addToCoalescedMessages(ptr<vector<ptr<NetworkMessage>>> _messages) {
+    lock_guard<mutex> lock(coalescingMutex);
 
+    if (coalescedMessages.empty())
+        coalescingStartMs = Time::getCurrentTimeMs();
+
+    coalescedMessages.insert(coalescedMessages.end(), _messages->begin(), _messages->end());
+
+    coalescingCond.notify_all();
+}
+
+void Network::sendBatch(ptr<vector<ptr<NetworkMessage>>> _messages) {
+
+    auto batch = make_shared<NetworkMessageBatch>(getSchain()->getSchainID(), getSchain()->getSchainIndex(),
+                                                  _messages);
+
+    batch->setECDSASig(getSchain()->getCryptoManager()->signNetworkMsgBatchAsync(*batch).get());
+
+    auto frames = make_shared<vector<ptr<string>>>();
+    frames->push_back(batch->serializeToString());
+
+    for (auto &&m : *_messages) {
+        getSchain()->getNode()->getOutgoingMsgDB()->saveMsg(m);
+    }
+
+    sendFrames(frames);
+}
+
+void Network::messageCoalescingLoop() {
+    setThreadName("MsgCoalLoop", getSchain()->getNode()->getConsensusEngine());
+    waitOnGlobalStartBarrier();
+
+    try {
+        while (!sChain->getNode()->isExitRequested()) {
+            try {
+                auto messages = make_shared<vector<ptr<NetworkMessage>>>();
+
+                {
+                    unique_lock<mutex> lock(coalescingMutex);
+
+                    if (coalescedMessages.empty()) {
+                        coalescingCond.wait_for(lock, chrono::milliseconds(SCHAIN_MESSAGE_WAIT_MS));
+                        continue;
+                    }
+
+                    auto currentTime = Time::getCurrentTimeMs();
+                    auto deadline = coalescingStartMs + messageCoalescingWindowMs;
+
+                    // send when the window of the oldest message expires or when the batch is full
+                    if (currentTime < deadline && coalescedMessages.size() < NetworkMessageBatch::MAX_MESSAGES) {
+                        coalescingCond.wait_for(lock, chrono::milliseconds(deadline - currentTime));
+                        continue;
+                    }
+
+                    auto count = std::min((uint64_t) coalescedMessages.size(), NetworkMessageBatch::MAX_MESSAGES);
+
+                    messages->assign(coalescedMessages.begin(), coalescedMessages.begin() + count);
+                    coalescedMessages.erase(coalescedMessages.begin(), coalescedMessages.begin() + count);
+                }
+
+                try {
+                    sendBatch(messages);
+                } catch (ExitRequestedException &) {
+                    throw;
+                } catch (exception &e) {
+                    // for example the batch is too large, the messages are not lost but sent one by one
+                    if (sChain->getNode()->isExitRequested())
+                        return;
+                    Exception::logNested(e);
+                    LOG(warn, "Could not send message batch, sending " + to_string(messages->size()) +
+                              " messages separately");
+                    sendMessages(messages);
+                }
+
+            } catch (ExitRequestedException &) {
+                return;
+            } catch (FatalError &) {
+                throw;
+            } catch (exception &e) {
+                if (sChain->getNode()->isExitRequested())
+                    return;
+                Exception::logNested(e);
+            }
+        }
+    } catch (FatalError &e) {
+        sChain->getNode()->exitOnFatalError(e.getMessage());
+    }
 }
 
 void Network::networkReadLoop() {
@@ -186,20 +337,24 @@ void Network::networkReadLoop() {
     try {
         while (!sChain->getNode()->isExitRequested()) {
             try {
-                ptr<NetworkMessageEnvelope> m = receiveMessage();
+                auto envelopes = receiveMessage();
 
-                if (!m)
+                if (!envelopes)
                     continue;  // check exit again
 
-                if (m->getMessage()->getBlockID() <= catchupBlocks) {
-                    continue;
-                }
+                for (auto &&m : *envelopes) {
 
-                ASSERT(sChain);
+                    if (m->getMessage()->getBlockID() <= catchupBlocks) {
+                        continue;
+                    }
 
-                getSchain()->getNode()->getIncomingMsgDB()->saveMsg(dynamic_pointer_cast<NetworkMessage>(m->getMessage()));
+                    ASSERT(sChain);
 
-                postDeferOrDrop(m);
+                    getSchain()->getNode()->getIncomingMsgDB()->saveMsg(
+                            dynamic_pointer_cast<NetworkMessage>(m->getMessage()));
+
+                    postDeferOrDrop(m);
+                }
             } catch (ExitRequestedException &) {
                 return;
             } catch (FatalError &) {
@@ -237,6 +392,11 @@ void Network::postDeferOrDrop(const ptr<NetworkMessageEnvelope> &m) {
     if (bid > currentBlockID) {
         // block id is in the future, defer
         addToDeferredMessageQueue(m);
+
+        // the sender has committed the previous block already, we are behind
+        auto netMsg = dynamic_pointer_cast<NetworkMessage>(m->getMessage());
+        if (netMsg)
+            sChain->getCatchupClientAgent()->peerCommittedBlockIDArrived(netMsg->getSrcSchainIndex(), bid - 1);
         return;
     }
 
@@ -266,7 +426,7 @@ void Network::trySendingDelayedSends() {
     for (int i = 0; i < nodeCount; i++) {
         if (i != (schainIndex - 1)) {
 
-            ptr<NetworkMessage> msg = nullptr;
+            ptr<string> frame = nullptr;
             ptr<NodeInfo> dstNodeInfo = nullptr;
 
             while (true) {
@@ -277,15 +437,15 @@ void Network::trySendingDelayedSends() {
                         break;
                     }
                     dstNodeInfo = delayedSends.at( i ).front().second;
-                    msg = delayedSends.at( i ).front().first;
+                    frame = delayedSends.at( i ).front().first;
                 }
-                if (sendMessage(dstNodeInfo, msg)) {
+                if (sendBytes(dstNodeInfo, frame)) {
                     // successfully sent a delayed message, remove it from the list
                     {
                         LOCK( delayedSendsLocks.at( i ));
                         delayedSends.at( i ).pop_front();
                     }
-                } {
+                } else {
                     // could not send a message to this host, no point trying to
                     // send other delayed messages for this host
                     break;
@@ -337,6 +497,12 @@ void Network::startThreads() {
 
     reg->add(networkReadThread);
     reg->add(deferredMessageThread);
+
+    if (messageCoalescingWindowMs > 0) {
+        messageCoalescingThread =
+                make_shared<thread>(std::bind(&Network::messageCoalescingLoop, this));
+        reg->add(messageCoalescingThread);
+    }
 }
 
 bool Network::validateIpAddress(ptr<string> &ip) {
@@ -349,6 +515,8 @@ bool Network::validateIpAddress(ptr<string> &ip) {
 void Network::waitUntilExit() {
     networkReadThread->join();
     deferredMessageThread->join();
+    if (messageCoalescingThread)
+        messageCoalescingThread->join();
 }
 
 ptr<string> Network::ipToString(uint32_t _ip) {
@@ -358,31 +526,63 @@ ptr<string> Network::ipToString(uint32_t _ip) {
             to_string((uint8_t) ip[2]) + "." + to_string((uint8_t) ip[3]));
 }
 
-ptr<NetworkMessageEnvelope> Network::receiveMessage() {
-    auto buf = make_shared<Buffer>(MAX_CONSENSUS_MESSAGE_LEN);
-    uint64_t readBytes = readMessageFromNetwork(buf);
+ptr<vector<ptr<NetworkMessageEnvelope>>> Network::receiveMessage() {
+    uint64_t readBytes = readMessageFromNetwork(receiveBuffer);
+
+    auto data = (const char *) receiveBuffer->getBuf()->data();
 
-    auto msg = make_shared<string>((const char *) buf->getBuf()->data(), readBytes);
+    nlohmann::json js;
+
+    try {
+        js = nlohmann::json::parse(data, data + readBytes);
+    } catch (...) {
+        throw_with_nested(InvalidMessageFormatException("Could not parse message", __CLASS_NAME__));
+    }
 
-    auto mptr = NetworkMessage::parseMessage(msg, getSchain());
+    auto messages = make_shared<vector<ptr<NetworkMessage>>>();
 
-    mptr->verify(getSchain()->getCryptoManager());
+    if (NetworkMessageBatch::isBatch(js)) {
+        auto batch = NetworkMessageBatch::parseBatch(js, getSchain());
+        batch->verify(getSchain()->getCryptoManager());
+        messages = batch->getMessages();
+    } else {
+        if (readBytes >= MAX_CONSENSUS_MESSAGE_LEN) {
+            BOOST_THROW_EXCEPTION(NetworkProtocolException("Consensus message length too large:" +
+                                                           to_string(readBytes), __CLASS_NAME__));
+        }
+        auto mptr = NetworkMessage::parseMessage(js, getSchain());
+        mptr->verify(getSchain()->getCryptoManager());
+        messages->push_back(mptr);
+    }
 
-    ptr<NodeInfo> realSender = sChain->getNode()->getNodeInfoByIndex(mptr->getSrcSchainIndex());
+    ptr<NodeInfo> realSender = sChain->getNode()->getNodeInfoByIndex(messages->front()->getSrcSchainIndex());
 
     if (realSender == nullptr) {
         BOOST_THROW_EXCEPTION(InvalidStateException("NetworkMessage from unknown sender schain index",
                                                     __CLASS_NAME__));
     }
 
-    ptr<ProtocolKey> key = mptr->createDestinationProtocolKey();
+    // the encoding is recorded only for verified messages, the flag is covered by the signed hash
+    if (realSender->getSchainIndex() != getSchain()->getSchainIndex()) {
+        getSchain()->getCryptoManager()->peerBLSEncodingArrived(realSender->getSchainIndex(),
+                                                                 messages->back()->isCompactBLSAdvertised());
+    }
+
+    auto result = make_shared<vector<ptr<NetworkMessageEnvelope>>>();
+
+    for (auto &&mptr : *messages) {
 
-    if (key == nullptr) {
-        BOOST_THROW_EXCEPTION(InvalidMessageFormatException(
-                                      "Network Message with corrupt protocol key", __CLASS_NAME__ ));
-    };
+        ptr<ProtocolKey> key = mptr->createDestinationProtocolKey();
 
-    return make_shared<NetworkMessageEnvelope>(mptr, realSender);
+        if (key == nullptr) {
+            BOOST_THROW_EXCEPTION(InvalidMessageFormatException(
+                                          "Network Message with corrupt protocol key", __CLASS_NAME__ ));
+        };
+
+        result->push_back(make_shared<NetworkMessageEnvelope>(mptr, realSender));
+    }
+
+    return result;
 };
 
 
@@ -426,6 +626,10 @@ Network::Network(Schain &_sChain)
       delayedSends((uint64_t) _sChain.getNodeCount()) {
     auto cfg = _sChain.getNode()->getCfg();
 
+    messageCoalescingWindowMs = _sChain.getNode()->getMessageCoalescingWindowMs();
+
+    receiveBuffer = make_shared<Buffer>(MAX_CONSENSUS_BATCH_LEN);
+
 
 
     if (cfg.find("catchupBlocks") != cfg.end()) {
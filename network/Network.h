@@ -33,6 +33,7 @@ class Schain;
 class NetworkMessageEnvelope;
 class NodeInfo;
 class NetworkMessage;
+class NetworkMessageBatch;
 class Buffer;
 class Node;
 class Schain;
@@ -43,7 +44,8 @@ class Network : public Agent  {
 
     vector<recursive_mutex> delayedSendsLocks;
 
-    vector<list<pair<ptr<NetworkMessage>,ptr<NodeInfo>>>> delayedSends;
+    // serialized frames that could not be sent yet
+    vector<list<pair<ptr<string>,ptr<NodeInfo>>>> delayedSends;
 
 
 
@@ -56,6 +58,35 @@ class Network : public Agent  {
 
     uint64_t   catchupBlocks = 0;
 
+    uint64_t messageCoalescingWindowMs = 0;
+
+    mutex coalescingMutex;
+
+    condition_variable coalescingCond;
+
+    // messages waiting to be sent in the next batch
+    vector<ptr<NetworkMessage>> coalescedMessages;
+
+    uint64_t coalescingStartMs = 0;
+
+    // only used by the network read thread
+    ptr<Buffer> receiveBuffer;
+
+    void addToCoalescedMessages(ptr<vector<ptr<NetworkMessage>>> _messages);
+
+    void sendBatch(ptr<vector<ptr<NetworkMessage>>> _messages);
+
+    /**
+     * Signs and sends each message in its own frame
+     */
+    void sendMessages(ptr<vector<ptr<NetworkMessage>>> _messages);
+
+    /**
+     * Sends the frames to each peer in order, waits until 2/3 of peers got all of them
+     * and queues the rest to delayed sends
+     */
+    void sendFrames(ptr<vector<ptr<string>>> _frames);
+
 
 
 
@@ -77,13 +108,15 @@ protected:
 
     ptr<vector<ptr<NetworkMessageEnvelope> > > pullMessagesForCurrentBlockID();
 
-    virtual bool sendMessage(const ptr<NodeInfo> &remoteNodeInfo, ptr<NetworkMessage> _msg) = 0;
+    virtual bool sendBytes(const ptr<NodeInfo> &_remoteNodeInfo, ptr<string> _bytes) = 0;
 
 
     ptr<thread> networkReadThread;
 
     ptr<thread> deferredMessageThread;
 
+    ptr<thread> messageCoalescingThread;
+
 
 public:
 
@@ -94,6 +127,8 @@ public:
 
     void networkReadLoop();
 
+    void messageCoalescingLoop();
+
     void waitUntilExit();
 
 
@@ -102,7 +137,16 @@ public:
 
     void broadcastMessage(ptr<NetworkMessage> _m);
 
-    ptr<NetworkMessageEnvelope> receiveMessage();
+    /**
+     * Signs all messages concurrently and sends them to each peer back to back.
+     * If message coalescing is enabled, the messages are queued to the next batch instead.
+     */
+    void broadcastMessages(ptr<vector<ptr<NetworkMessage>>> _messages);
+
+    /**
+     * Reads a frame from the network, a batch frame is unpacked into its messages
+     */
+    ptr<vector<ptr<NetworkMessageEnvelope>>> receiveMessage();
 
     virtual uint64_t readMessageFromNetwork(ptr<Buffer> buf) = 0;
 
@@ -120,7 +164,7 @@ public:
 
     ~Network();
 
-    void addToDelayedSends(ptr<NetworkMessage> _m, ptr<NodeInfo> dstNodeInfo);
+    void addToDelayedSends(ptr<string> _frame, ptr<NodeInfo> dstNodeInfo);
 
     void trySendingDelayedSends();
 
@@ -54,10 +54,11 @@
 using namespace std;
 
 
-bool ZMQNetwork::sendMessage(const ptr<NodeInfo> &_remoteNodeInfo, ptr<NetworkMessage> _msg) {
+bool ZMQNetwork::sendBytes(const ptr<NodeInfo> &_remoteNodeInfo, ptr<string> _bytes) {
 
+    CHECK_ARGUMENT(_bytes);
 
-    auto buf = _msg->serializeToString();
+    auto buf = _bytes;
 
     void *s = sChain->getNode()->getSockets()->consensusZMQSockets->getDestinationSocket(
                                                                       _remoteNodeInfo);
@@ -143,9 +144,9 @@ uint64_t ZMQNetwork::readMessageFromNetwork(ptr<Buffer> buf) {
 
     auto s = sChain->getNode()->getSockets()->consensusZMQSockets->getReceiveSocket();
 
-    auto rc = interruptableRecv(s, buf->getBuf()->data(), MAX_CONSENSUS_MESSAGE_LEN, 0);
+    auto rc = interruptableRecv(s, buf->getBuf()->data(), buf->getSize(), 0);
 
-    if ((uint64_t) rc >= MAX_CONSENSUS_MESSAGE_LEN) {
+    if ((uint64_t) rc >= buf->getSize()) {
         BOOST_THROW_EXCEPTION(NetworkProtocolException("Consensus essage length too large:" +
                                        to_string(rc), __CLASS_NAME__));
     }
@@ -54,7 +54,7 @@ public:
 
     ZMQNetwork(Schain &_schain);
 
-    bool sendMessage(const ptr<NodeInfo> &_remoteNodeInfo, ptr<NetworkMessage> _msg);
+    bool sendBytes(const ptr<NodeInfo> &_remoteNodeInfo, ptr<string> _bytes);
 
 };
 
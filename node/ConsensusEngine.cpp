@@ -76,6 +76,9 @@
 #include "spdlog/spdlog.h"
 
 #include "chains/Schain.h"
+#include "crypto/SHAHash.h"
+#include "datastructures/CommittedBlock.h"
+#include "db/BlockDB.h"
 #include "exceptions/EngineInitException.h"
 #include "json/JSONFactory.h"
 #include "libBLS/bls/BLSPrivateKeyShare.h"
@@ -432,7 +435,24 @@ void ConsensusEngine::slowStartBootStrapTest() {
 
     for (auto const it : nodes) {
         it.second->startClients();
-        it.second->getSchain()->bootstrap(lastCommittedBlockID, lastCommittedBlockTimeStamp);
+
+        auto blockID = lastCommittedBlockID;
+        auto timeStamp = lastCommittedBlockTimeStamp;
+
+        // without an external face the block DB is the only record, so a restarted test node resumes from it
+        if (extFace == nullptr) {
+            auto dbBlockID = it.second->getBlockDB()->readLastCommittedBlockID();
+            if (dbBlockID > blockID) {
+                auto block = it.second->getBlockDB()->getBlock(dbBlockID,
+                                                               it.second->getSchain()->getCryptoManager());
+                if (block != nullptr) {
+                    blockID = dbBlockID;
+                    timeStamp = block->getTimeStamp();
+                }
+            }
+        }
+
+        it.second->getSchain()->bootstrap(blockID, timeStamp);
     }
 
     LOG(info, "Started all nodes");
@@ -673,6 +693,72 @@ block_id ConsensusEngine::getLargestCommittedBlockID() {
     return id;
 }
 
+uint64_t ConsensusEngine::checkCommittedBlocksMatch() {
+
+    CHECK_STATE(!nodes.empty());
+
+    uint64_t commonBlockID = UINT64_MAX;
+
+    for (auto &&item: nodes) {
+        commonBlockID = std::min(commonBlockID, (uint64_t) item.second->getSchain()->getLastCommittedBlockID());
+    }
+
+    for (uint64_t i = 1; i <= commonBlockID; i++) {
+
+        ptr<SHAHash> hash = nullptr;
+
+        for (auto &&item: nodes) {
+            auto block = item.second->getBlockDB()->getBlock(block_id(i),
+                                                            item.second->getSchain()->getCryptoManager());
+
+            CHECK_STATE2(block != nullptr, "Committed block is missing in the block DB:" + to_string(i));
+
+            if (hash == nullptr) {
+                hash = block->getHash();
+            } else {
+                CHECK_STATE2(hash->compare(block->getHash()) == 0,
+                             "Nodes committed different blocks with block id:" + to_string(i));
+            }
+        }
+    }
+
+    return commonBlockID;
+}
+
+uint64_t ConsensusEngine::checkNoDuplicateTransactions() {
+
+    CHECK_STATE(!nodes.empty());
+
+    auto node = nodes.begin()->second;
+
+    set<vector<uint8_t>> seen;
+
+    for (uint64_t i = 1; i <= (uint64_t) node->getSchain()->getLastCommittedBlockID(); i++) {
+        auto block = node->getBlockDB()->getBlock(block_id(i), node->getSchain()->getCryptoManager());
+
+        CHECK_STATE2(block != nullptr, "Committed block is missing in the block DB:" + to_string(i));
+
+        for (auto &&t: *block->getTransactionList()->getItems()) {
+            CHECK_STATE2(seen.insert(*t->getData()).second,
+                         "Transaction committed twice, second time in block:" + to_string(i));
+        }
+    }
+
+    return seen.size();
+}
+
+uint64_t ConsensusEngine::getCompactBLSNodesCount() {
+
+    uint64_t result = 0;
+
+    for (auto &&item: nodes) {
+        if (item.second->getSchain()->getCryptoManager()->isCompactBLSEncoding())
+            result++;
+    }
+
+    return result;
+}
+
 u256 ConsensusEngine::getPriceForBlockId(uint64_t _blockId) const {
 
     ASSERT(nodes.size() == 1);
@@ -685,6 +771,30 @@ u256 ConsensusEngine::getPriceForBlockId(uint64_t _blockId) const {
 }
 
 
+uint64_t ConsensusEngine::getExtFaceQueueDepth() const {
+
+    ASSERT(nodes.size() == 1);
+
+    for (auto &&item: nodes) {
+        return item.second->getSchain()->getExtFaceQueueDepth();
+    }
+
+    return 0; // never happens
+}
+
+
+uint64_t ConsensusEngine::getExtFaceDeliveryLatencyMs() const {
+
+    ASSERT(nodes.size() == 1);
+
+    for (auto &&item: nodes) {
+        return item.second->getSchain()->getExtFaceDeliveryLatencyMs();
+    }
+
+    return 0; // never happens
+}
+
+
 bool ConsensusEngine::onTravis = false;
 
 bool ConsensusEngine::noUlimitCheck = false;
@@ -144,6 +144,21 @@ public:
 
     block_id getLargestCommittedBlockID();
 
+    /**
+     * Test helper, throws if two nodes of this engine committed different blocks with the same id
+     * @return number of blocks committed by all nodes
+     */
+    uint64_t checkCommittedBlocksMatch();
+
+    // returns the number of committed transactions, throws if one of them is committed twice
+    uint64_t checkNoDuplicateTransactions();
+
+    /**
+     * Test helper
+     * @return number of nodes of this engine that write compact BLS shares and signatures
+     */
+    uint64_t getCompactBLSNodesCount();
+
     ConsensusEngine();
 
     ~ConsensusEngine() override;
@@ -211,6 +226,10 @@ public:
 
     u256 getPriceForBlockId(uint64_t _blockId) const override;
 
+    uint64_t getExtFaceQueueDepth() const override;
+
+    uint64_t getExtFaceDeliveryLatencyMs() const override;
+
     void systemHealthCheck();
 
 
@@ -28,6 +28,7 @@
 
 #include<boost/multiprecision/cpp_int.hpp>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -74,9 +75,38 @@ public:
 
     virtual void setEmptyBlockIntervalMs(uint64_t) {}
 
+    // committed blocks waiting for createBlock(), non-zero only if extFaceQueueSize is set
+    virtual uint64_t getExtFaceQueueDepth() const { return 0; }
+
+    // time from commit to return from createBlock() of the last delivered block
+    virtual uint64_t getExtFaceDeliveryLatencyMs() const { return 0; }
+
     virtual consensus_engine_status getStatus() const = 0;
 };
 
+/**
+ * Bytes of a single transaction in a reference counted buffer that is shared with consensus.
+ * Holding the view keeps the bytes alive, the bytes must not be modified.
+ */
+class transaction_view {
+    std::shared_ptr<std::vector<uint8_t> > buffer;
+
+public:
+    transaction_view() = default;
+
+    explicit transaction_view(std::shared_ptr<std::vector<uint8_t> > _buffer) : buffer(std::move(_buffer)) {}
+
+    const uint8_t *data() const { return buffer ? buffer->data() : nullptr; }
+
+    size_t size() const { return buffer ? buffer->size() : 0; }
+
+    const uint8_t *begin() const { return data(); }
+
+    const uint8_t *end() const { return data() + size(); }
+
+    const std::shared_ptr<std::vector<uint8_t> > &getBuffer() const { return buffer; }
+};
+
 /**
  * Through this interface Consensus interacts with the rest of the system
  */
@@ -84,6 +114,8 @@ class ConsensusExtFace {
 public:
     typedef std::vector<std::vector<uint8_t> > transactions_vector;
 
+    typedef std::vector<transaction_view> transaction_views;
+
     // Returns hashes and bytes of new transactions as well as state root to put into block proposal
     virtual transactions_vector pendingTransactions(size_t _limit, u256& _stateRoot) = 0;
 
@@ -92,6 +124,32 @@ public:
                              uint32_t _timeStampMillis, uint64_t _blockID, u256 _gasPrice,
                              u256 _stateRoot) = 0;
 
+    /* Zero-copy versions of pendingTransactions() and createBlock(), consensus only calls these.
+     Override them to pass transaction buffers without copying, the defaults fall back to the
+     vector based functions above.
+     */
+
+    virtual transaction_views pendingTransactionViews(size_t _limit, u256& _stateRoot) {
+        auto transactions = pendingTransactions(_limit, _stateRoot);
+        transaction_views result;
+        result.reserve(transactions.size());
+        for (auto &t : transactions) {
+            result.emplace_back(std::make_shared<std::vector<uint8_t> >(std::move(t)));
+        }
+        return result;
+    }
+
+    virtual void createBlockFromViews(const transaction_views &_approvedTransactions, uint64_t _timeStamp,
+                                      uint32_t _timeStampMillis, uint64_t _blockID, u256 _gasPrice,
+                                      u256 _stateRoot) {
+        transactions_vector transactions;
+        transactions.reserve(_approvedTransactions.size());
+        for (auto &t : _approvedTransactions) {
+            transactions.emplace_back(t.begin(), t.end());
+        }
+        createBlock(transactions, _timeStamp, _timeStampMillis, _blockID, _gasPrice, _stateRoot);
+    }
+
     virtual ~ConsensusExtFace() = default;
 
     virtual void terminateApplication() {};
@@ -165,6 +165,14 @@ void Node::initParamsFromConfig() {
     basePort = network_port(cfg.at("basePort").get<int>());
 
     catchupIntervalMS = getParamUint64("catchupIntervalMs", CATCHUP_INTERVAL_MS);
+    catchupWindowSize = getParamUint64("catchupWindowSize", CATCHUP_WINDOW_SIZE);
+    catchupDownloadThreads = getParamUint64("catchupDownloadThreads", CATCHUP_DOWNLOAD_THREADS);
+    messageProcessingShards = getParamUint64("messageProcessingShards", MESSAGE_PROCESSING_SHARDS);
+    proposalPipelining = getParamUint64("proposalPipelining", PROPOSAL_PIPELINING) != 0;
+    messageCoalescingWindowMs = getParamUint64("messageCoalescingWindowMs", MESSAGE_COALESCING_WINDOW_MS);
+    fastPathDecision = getParamUint64("fastPathDecision", FAST_PATH_DECISION) != 0;
+    compactBLSEncoding = getParamUint64("compactBLSEncoding", COMPACT_BLS_ENCODING) != 0;
+    extFaceQueueSize = getParamUint64("extFaceQueueSize", EXT_FACE_QUEUE_SIZE);
     monitoringIntervalMS = getParamUint64("monitoringIntervalMs", MONITORING_INTERVAL_MS);
     waitAfterNetworkErrorMs = getParamUint64("waitAfterNetworkErrorMs", WAIT_AFTER_NETWORK_ERROR_MS);
     blockProposalHistorySize = getParamUint64("blockProposalHistorySize", BLOCK_PROPOSAL_HISTORY_SIZE);
@@ -187,6 +187,22 @@ class Node {
 
     uint64_t catchupIntervalMS;
 
+    uint64_t catchupWindowSize;
+
+    uint64_t catchupDownloadThreads;
+
+    uint64_t messageProcessingShards;
+
+    bool proposalPipelining;
+
+    uint64_t messageCoalescingWindowMs;
+
+    bool fastPathDecision;
+
+    bool compactBLSEncoding;
+
+    uint64_t extFaceQueueSize;
+
     uint64_t monitoringIntervalMS;
 
     uint64_t waitAfterNetworkErrorMs;
@@ -330,6 +346,22 @@ public:
 
     uint64_t getCatchupIntervalMs();
 
+    uint64_t getCatchupWindowSize() const;
+
+    uint64_t getCatchupDownloadThreads() const;
+
+    uint64_t getMessageProcessingShards() const;
+
+    bool isProposalPipelining() const;
+
+    uint64_t getMessageCoalescingWindowMs() const;
+
+    bool isFastPathDecision() const;
+
+    bool isCompactBLSEncoding() const;
+
+    uint64_t getExtFaceQueueSize() const;
+
     uint64_t getMonitoringIntervalMs();
 
 
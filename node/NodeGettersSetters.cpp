@@ -247,6 +247,38 @@ uint64_t Node::getCatchupIntervalMs() {
     return catchupIntervalMS;
 }
 
+uint64_t Node::getCatchupWindowSize() const {
+    return catchupWindowSize;
+}
+
+uint64_t Node::getCatchupDownloadThreads() const {
+    return catchupDownloadThreads;
+}
+
+uint64_t Node::getMessageProcessingShards() const {
+    return messageProcessingShards;
+}
+
+bool Node::isProposalPipelining() const {
+    return proposalPipelining;
+}
+
+uint64_t Node::getMessageCoalescingWindowMs() const {
+    return messageCoalescingWindowMs;
+}
+
+bool Node::isFastPathDecision() const {
+    return fastPathDecision;
+}
+
+bool Node::isCompactBLSEncoding() const {
+    return compactBLSEncoding;
+}
+
+uint64_t Node::getExtFaceQueueSize() const {
+    return extFaceQueueSize;
+}
+
 uint64_t Node::getMonitoringIntervalMs() {
     return monitoringIntervalMS;
 }
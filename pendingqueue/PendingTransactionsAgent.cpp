@@ -53,49 +53,104 @@ using namespace std;
 PendingTransactionsAgent::PendingTransactionsAgent( Schain& ref_sChain )
     : Agent(ref_sChain, false)  {}
 
+// state roots of the test message generator
+static u256 stateRootSample = 1;
+
 ptr<BlockProposal> PendingTransactionsAgent::buildBlockProposal(block_id _blockID, uint64_t _previousBlockTimeStamp,
-    uint32_t _previousBlockTimeStampMs) {
+    uint32_t _previousBlockTimeStampMs, ptr<TransactionList> _excluded) {
+
+    MICROPROFILE_ENTERI( "PendingTransactionsAgent", "sleep", MP_DIMGRAY );
+    usleep(getNode()->getMinBlockIntervalMs() * 1000);
+    MICROPROFILE_LEAVE();
+
+    auto result  = createTransactionsListForProposal(_excluded);
+
+    return makeBlockProposal(_blockID, _previousBlockTimeStamp, _previousBlockTimeStampMs, result.first,
+                             result.second);
+}
+
+ptr<vector<ptr<Transaction>>> PendingTransactionsAgent::collectTransactionsForProposal(
+        ptr<TransactionList> _excluded) {
 
     MICROPROFILE_ENTERI( "PendingTransactionsAgent", "sleep", MP_DIMGRAY );
     usleep(getNode()->getMinBlockIntervalMs() * 1000);
     MICROPROFILE_LEAVE();
 
-    auto result  = createTransactionsListForProposal();
-    auto transactions = result.first;
-    auto stateRoot = result.second;
-    CHECK_STATE(stateRoot != 0)
+    return createTransactionsListForProposal(_excluded).first;
+}
+
+ptr<BlockProposal> PendingTransactionsAgent::completeBlockProposal(block_id _blockID,
+        uint64_t _previousBlockTimeStamp, uint32_t _previousBlockTimeStampMs,
+        ptr<vector<ptr<Transaction>>> _transactions) {
+    CHECK_ARGUMENT(_transactions != nullptr);
+
+    return makeBlockProposal(_blockID, _previousBlockTimeStamp, _previousBlockTimeStampMs, _transactions,
+                             readStateRoot());
+}
+
+u256 PendingTransactionsAgent::readStateRoot() {
+    u256 stateRoot = 0;
+
+    if (sChain->getExtFace()) {
+        // takes no transactions, only reads the state root
+        sChain->getExtFace()->pendingTransactionViews(0, stateRoot);
+        getSchain()->getNode()->exitCheck();
+    } else {
+        stateRootSample++;
+        stateRoot = stateRootSample;
+    }
+
+    return stateRoot;
+}
+
+ptr<BlockProposal> PendingTransactionsAgent::makeBlockProposal(block_id _blockID,
+        uint64_t _previousBlockTimeStamp, uint32_t _previousBlockTimeStampMs,
+        ptr<vector<ptr<Transaction>>> _transactions, u256 _stateRoot) {
+
+    CHECK_STATE(_stateRoot != 0)
 
     while (Time::getCurrentTimeMs() <= _previousBlockTimeStamp * 1000 + _previousBlockTimeStampMs) {
         usleep(10);
     }
 
-    auto transactionList = make_shared<TransactionList>(transactions);
+    auto transactionList = make_shared<TransactionList>(_transactions);
 
     auto currentTime = Time::getCurrentTimeMs();
     auto sec = currentTime / 1000;
     auto m = (uint32_t) (currentTime % 1000);
 
     auto myBlockProposal = make_shared<MyBlockProposal>(*sChain, _blockID, sChain->getSchainIndex(),
-            transactionList, stateRoot, sec, m, getSchain()->getCryptoManager());
+            transactionList, _stateRoot, sec, m, getSchain()->getCryptoManager());
 
-    LOG(trace, "Created proposal, transactions:" + to_string(transactions->size()));
+    LOG(trace, "Created proposal, transactions:" + to_string(_transactions->size()));
 
     transactionCounter += (uint64_t) myBlockProposal->createPartialHashesList()->getTransactionCount();
     return myBlockProposal;
 }
 
-pair<ptr<vector<ptr<Transaction>>>, u256> PendingTransactionsAgent::createTransactionsListForProposal() {
+pair<ptr<vector<ptr<Transaction>>>, u256> PendingTransactionsAgent::createTransactionsListForProposal(
+        ptr<TransactionList> _excluded) {
     auto result = make_shared<vector<ptr<Transaction>>>();
 
     size_t need_max = getNode()->getMaxTransactionsPerBlock();
-    ConsensusExtFace::transactions_vector tx_vec;
+    ConsensusExtFace::transaction_views tx_vec;
+
+    unordered_set<ptr<partial_sha_hash>, Hasher, Equal> excludedHashes;
+
+    if (_excluded != nullptr) {
+        for (auto &&t : *_excluded->getItems()) {
+            excludedHashes.insert(t->getPartialHash());
+        }
+    }
+
+    // excluded transactions are still pending in the external face, ask for more to fill the block
+    size_t need_ext = need_max + excludedHashes.size();
 
     boost::posix_time::ptime t1 = boost::posix_time::microsec_clock::local_time();
 
     u256 stateRoot = 0;
-    static u256 stateRootSample = 1;
 
-    while(tx_vec.empty()){
+    while(result->empty()){
 
         getSchain()->getNode()->exitCheck();
         boost::posix_time::ptime t2 = boost::posix_time::microsec_clock::local_time();
@@ -105,21 +160,35 @@ pair<ptr<vector<ptr<Transaction>>>, u256> PendingTransactionsAgent::createTransa
             break;
 
         if (sChain->getExtFace()) {
-            tx_vec = sChain->getExtFace()->pendingTransactions(need_max, stateRoot);
+            tx_vec = sChain->getExtFace()->pendingTransactionViews(need_ext, stateRoot);
             // exit immediately if exitGracefully has been requested
             getSchain()->getNode()->exitCheck();
         } else {
             stateRootSample++;
             stateRoot = stateRootSample;
-            tx_vec = sChain->getTestMessageGeneratorAgent()->pendingTransactions(need_max);
+            tx_vec = sChain->getTestMessageGeneratorAgent()->pendingTransactions(need_ext);
+        }
+
+        // transactions that were already pulled or received before come back with their hashes
+        // new transactions keep the buffer of the external face, no bytes are copied
+        for(const auto& e: tx_vec){
+            ptr<Transaction> pt = Transaction::deserialize( e.getBuffer(), 0, e.size(), false );
+            result->push_back(pt);
         }
-    }
 
+        Transaction::calculateHashes(*result);
+
+        if (!excludedHashes.empty()) {
+            result->erase(remove_if(result->begin(), result->end(), [&](const ptr<Transaction> &_t) {
+                return excludedHashes.count(_t->getPartialHash()) > 0;
+            }), result->end());
+        }
+
+        if (result->size() > need_max)
+            result->resize(need_max);
+    }
 
-    for(const auto& e: tx_vec){
-        ptr<Transaction> pt = Transaction::deserialize( make_shared<std::vector<uint8_t>>(e),
-                0,e.size(), false );
-        result->push_back(pt);
+    for (auto &&pt : *result) {
         pushKnownTransaction(pt);
     }
 
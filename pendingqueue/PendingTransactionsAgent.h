@@ -31,6 +31,7 @@ class Schain;
 class BlockProposal;
 class PartialHashesList;
 class Transaction;
+class TransactionList;
 
 #include "db/CacheLevelDB.h"
 
@@ -94,7 +95,13 @@ private:
     recursive_mutex transactionsMutex;
 
 
-    pair<ptr<vector<ptr<Transaction>>>, u256> createTransactionsListForProposal();
+    pair<ptr<vector<ptr<Transaction>>>, u256> createTransactionsListForProposal(ptr<TransactionList> _excluded);
+
+    u256 readStateRoot();
+
+    ptr<BlockProposal> makeBlockProposal(block_id _blockID, uint64_t _previousBlockTimeStamp,
+                                         uint32_t _previousBlockTimeStampMs,
+                                         ptr<vector<ptr<Transaction>>> _transactions, u256 _stateRoot);
 
 public:
 
@@ -106,8 +113,26 @@ public:
 
     ptr<Transaction> getKnownTransactionByPartialHash(ptr<partial_sha_hash> hash);
 
+    /**
+     * @param _excluded transactions of a block that is not yet committed, so that the external face
+     * still returns them as pending
+     */
     ptr<BlockProposal> buildBlockProposal(block_id _blockID, uint64_t  _previousBlockTimeStamp,
-                             uint32_t _previosBlockTimeStampMs);
+                             uint32_t _previosBlockTimeStampMs, ptr<TransactionList> _excluded = nullptr);
+
+    /**
+     * First half of a pipelined proposal: waits for the minimal block interval and pulls transactions
+     * while the previous block is committed. _excluded are the transactions of that block
+     */
+    ptr<vector<ptr<Transaction>>> collectTransactionsForProposal(ptr<TransactionList> _excluded);
+
+    /**
+     * Second half of a pipelined proposal, called once the previous block is pushed to the external face,
+     * so that the state root includes it
+     */
+    ptr<BlockProposal> completeBlockProposal(block_id _blockID, uint64_t _previousBlockTimeStamp,
+                                             uint32_t _previousBlockTimeStampMs,
+                                             ptr<vector<ptr<Transaction>>> _transactions);
 
 
     virtual ~PendingTransactionsAgent() = default;
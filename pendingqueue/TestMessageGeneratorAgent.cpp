@@ -29,6 +29,8 @@
 #include "chains/Schain.h"
 #include "chains/SchainTest.h"
 #include "datastructures/Transaction.h"
+#include "datastructures/TransactionList.h"
+#include "datastructures/CommittedBlock.h"
 #include "chains/Schain.h"
 #include "pendingqueue/TestMessageGeneratorAgent.h"
 #include "datastructures/Transaction.h"
@@ -38,35 +40,47 @@
 
 TestMessageGeneratorAgent::TestMessageGeneratorAgent(Schain& _sChain_) : Agent(_sChain_, false) {
     ASSERT(_sChain_.getNodeCount() > 0);
+    keepPending = _sChain_.getNode()->getExtFaceQueueSize() > 0;
 }
 
 
 
-ConsensusExtFace::transactions_vector TestMessageGeneratorAgent::pendingTransactions( size_t _limit ) {
+ConsensusExtFace::transaction_views TestMessageGeneratorAgent::pendingTransactions( size_t _limit ) {
 
     uint64_t  messageSize = 200;
 
-    ConsensusExtFace::transactions_vector result;
+    ConsensusExtFace::transaction_views result;
 
 
     if (*sChain->getBlockProposerTest() == SchainTest::NONE)
         return result;
 
-    for (uint64_t i = 0; i < _limit; i++) {
+    lock_guard<mutex> lock(pendingMutex);
 
-        vector<uint8_t> transaction(messageSize);
+    for (auto &&transaction : pending) {
+        if (result.size() >= _limit)
+            break;
+        result.emplace_back(transaction);
+    }
+
+    for (uint64_t i = result.size(); i < _limit; i++) {
+
+        auto transaction = make_shared<vector<uint8_t>>(messageSize);
 
         uint64_t  dummy = counter;
         auto bytes = (uint8_t*) & dummy;
 
         for (uint64_t j = 0; j < messageSize/8; j++) {
             for (int k = 0; k < 7; k++) {
-                transaction.at(2 * j + k ) = bytes[k];
+                transaction->at(2 * j + k ) = bytes[k];
             }
 
         }
 
-        result.push_back(transaction);
+        result.emplace_back(transaction);
+
+        if (keepPending)
+            pending.push_back(transaction);
 
         counter++;
 
@@ -77,3 +91,24 @@ ConsensusExtFace::transactions_vector TestMessageGeneratorAgent::pendingTransact
 };
 
 
+void TestMessageGeneratorAgent::blockDelivered(ptr<CommittedBlock> _block) {
+    CHECK_ARGUMENT(_block);
+
+    if (!keepPending)
+        return;
+
+    set<vector<uint8_t>> delivered;
+
+    for (auto &&t : *_block->getTransactionList()->getItems()) {
+        delivered.insert(*t->getData());
+    }
+
+    lock_guard<mutex> lock(pendingMutex);
+
+    pending.erase(remove_if(pending.begin(), pending.end(), [&](const ptr<vector<uint8_t>> &_t) {
+        return delivered.count(*_t) > 0;
+    }), pending.end());
+}
+
+
+
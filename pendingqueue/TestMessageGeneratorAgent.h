@@ -28,18 +28,29 @@
 #include "node/ConsensusEngine.h"
 
 class Schain;
+class CommittedBlock;
 
 class TestMessageGeneratorAgent : Agent {
 
 
     uint64_t counter = 0;
 
+    // with an ext face queue, returned transactions stay pending until their block is delivered,
+    // the way the external face keeps them
+    bool keepPending = false;
+
+    mutex pendingMutex;
+
+    deque<ptr<vector<uint8_t>>> pending;
+
 
 public:
 
 
     TestMessageGeneratorAgent(Schain& _sChain);
 
-    ConsensusExtFace::transactions_vector pendingTransactions( size_t _limit);
+    ConsensusExtFace::transaction_views pendingTransactions( size_t _limit);
+
+    void blockDelivered(ptr<CommittedBlock> _block);
 
 };
@@ -65,7 +65,7 @@ PricingAgent::PricingAgent(Schain &_sChain) : Agent(_sChain, false) {
 }
 
 u256
-PricingAgent::calculatePrice(const ConsensusExtFace::transactions_vector &_approvedTransactions, uint64_t _timeStamp,
+PricingAgent::calculatePrice(const ConsensusExtFace::transaction_views &_approvedTransactions, uint64_t _timeStamp,
                              uint32_t _timeStampMs,
                              block_id _blockID) {
 
@@ -28,6 +28,7 @@
 #include "crypto/bls_include.h"
 #include "crypto/ConsensusBLSSignature.h"
 #include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
 
 #include "chains/Schain.h"
 #include "node/Node.h"
@@ -52,17 +53,17 @@ AUXBroadcastMessage::AUXBroadcastMessage(bin_consensus_round _round, bin_consens
                          _sourceProtocolInstance) {
     printPrefix = "a";
     auto schain = _sourceProtocolInstance.getSchain();
-    CryptoPP::SHA256 sha256;
+    SHA256Hasher sha256;
     auto bpi = getBlockProposerIndex();
 
-    sha256.Update(reinterpret_cast < uint8_t * > ( &bpi), sizeof(bpi));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->r), sizeof(r));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->blockID), sizeof(blockID));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->schainID), sizeof(schainID));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->msgType), sizeof(msgType));
+    sha256.update(reinterpret_cast < uint8_t * > ( &bpi), sizeof(bpi));
+    sha256.update(reinterpret_cast < uint8_t * > ( &this->r), sizeof(r));
+    sha256.update(reinterpret_cast < uint8_t * > ( &this->blockID), sizeof(blockID));
+    sha256.update(reinterpret_cast < uint8_t * > ( &this->schainID), sizeof(schainID));
+    sha256.update(reinterpret_cast < uint8_t * > ( &this->msgType), sizeof(msgType));
 
     auto buf = make_shared<array<uint8_t, SHA_HASH_LEN>>();
-    sha256.Final(buf->data());
+    sha256.final(buf->data());
     auto hash = make_shared<SHAHash>(buf);
     this->sigShare = schain->getCryptoManager()->signBinaryConsensusSigShare(hash, _blockID);
     this->sigShareString = sigShare->toString();
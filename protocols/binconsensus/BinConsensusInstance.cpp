@@ -30,6 +30,11 @@
 #include "crypto/ConsensusBLSSignature.h"
 #include "crypto/ConsensusSigShareSet.h"
 #include "crypto/CryptoManager.h"
+#include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
+#include "datastructures/CommittedBlock.h"
+#include "exceptions/InvalidStateException.h"
+#include "exceptions/ExitRequestedException.h"
 #include "db/BlockProposalDB.h"
 #include "db/ConsensusStateDB.h"
 #include "db/RandomDB.h"
@@ -163,7 +168,8 @@ void BinConsensusInstance::updateStats(const ptr<NetworkMessageEnvelope> &_me) {
     }
 }
 
-void BinConsensusInstance::processParentProposal(ptr<InternalMessageEnvelope> _me) {
+void BinConsensusInstance::processParentProposal(ptr<InternalMessageEnvelope> _me,
+                                                 ptr<vector<ptr<NetworkMessage>>> _outgoing) {
 
 
     auto m = dynamic_pointer_cast<BVBroadcastMessage>(_me->getMessage());
@@ -178,7 +184,7 @@ void BinConsensusInstance::processParentProposal(ptr<InternalMessageEnvelope> _m
     setProposal(m->getRound(), m->getValue());
 
 
-    networkBroadcastValue(m);
+    networkBroadcastValue(m, _outgoing);
 
 
 
@@ -262,11 +268,7 @@ void BinConsensusInstance::bvbVote(ptr<MessageEnvelope> _me) {
                                                                 getBlockProposerIndex(), r, index, v);
 
 
-    if (v) {
-        bvbTrueVotes[r].insert(index);
-    } else {
-        bvbFalseVotes[r].insert(index);
-    }
+    getRoundVotes(r).addBVBVote(v, index);
 }
 
 
@@ -284,17 +286,13 @@ void BinConsensusInstance::auxVote(ptr<MessageEnvelope> _me) {
                                                                 sigShare->toString());
 
 
-    if (v) {
-        auxTrueVotes[r][index] = sigShare;
-    } else {
-        auxFalseVotes[r][index] = sigShare;
-    }
+    getRoundVotes(r).addAUXVote(v, index, sigShare);
 
 }
 
 
 uint64_t BinConsensusInstance::totalAUXVotes(bin_consensus_round r) {
-    return auxTrueVotes[r].size() + auxFalseVotes[r].size();
+    return getRoundVotes(r).getTotalAUXVoteCount();
 }
 
 void BinConsensusInstance::auxSelfVote(bin_consensus_round _r,
@@ -309,23 +307,20 @@ void BinConsensusInstance::auxSelfVote(bin_consensus_round _r,
                                                                 getSchain()->getSchainIndex(), _v,
                                                                 _sigShare->toString());
 
-    if (_v) {
-        ASSERT(auxTrueVotes[_r].count(getSchain()->getSchainIndex()) == 0);
-        auxTrueVotes[_r][getSchain()->getSchainIndex()] = _sigShare;
-    } else {
-        ASSERT(auxFalseVotes[_r].count(getSchain()->getSchainIndex()) == 0);
-        auxFalseVotes[_r][getSchain()->getSchainIndex()] = _sigShare;
-    }
+    auto &votes = getRoundVotes(_r);
+
+    ASSERT(!votes.hasAUXVote(_v, getSchain()->getSchainIndex()));
+    votes.addAUXVote(_v, getSchain()->getSchainIndex(), _sigShare);
 
 }
 
 
 node_count BinConsensusInstance::getBVBVoteCount(bin_consensus_value _v, bin_consensus_round _r) {
-    return node_count(((_v ? bvbTrueVotes[_r] : bvbFalseVotes[_r]).size()));
+    return node_count(getRoundVotes(_r).getBVBVoteCount(_v));
 }
 
 node_count BinConsensusInstance::getAUXVoteCount(bin_consensus_value _v, bin_consensus_round _r) {
-    return node_count(((_v ? auxTrueVotes[_r] : auxFalseVotes[_r]).size()));
+    return node_count(getRoundVotes(_r).getAUXVoteCount(_v));
 }
 
 bool BinConsensusInstance::isThird(node_count count) {
@@ -350,7 +345,7 @@ bool BinConsensusInstance::isTwoThirdVote(ptr<BVBroadcastMessage> _m) {
 void BinConsensusInstance::insertValue(bin_consensus_round _r, bin_consensus_value _v) {
     getSchain()->getNode()->getConsensusStateDB()->writeBinValue(getBlockID(),
             getBlockProposerIndex(), _r, _v);
-    binValues[_r].insert(_v);
+    getRoundVotes(_r).insertBinValue(_v);
 }
 
 void BinConsensusInstance::commitValueIfTwoThirds(ptr<BVBroadcastMessage> _m) {
@@ -359,12 +354,12 @@ void BinConsensusInstance::commitValueIfTwoThirds(ptr<BVBroadcastMessage> _m) {
     auto v = _m->getValue();
 
 
-    if (binValues[r].count(v))
+    if (getRoundVotes(r).hasBinValue(v))
         return;
 
 
     if (isTwoThirdVote(_m)) {
-        bool didAUXBroadcast = binValues[r].size() > 0;
+        bool didAUXBroadcast = getRoundVotes(r).hasBinValues();
 
         insertValue(r, v);
 
@@ -386,21 +381,26 @@ void BinConsensusInstance::networkBroadcastValueIfThird(ptr<BVBroadcastMessage>
     }
 }
 
-void BinConsensusInstance::networkBroadcastValue(ptr<BVBroadcastMessage> _m) {
+void BinConsensusInstance::networkBroadcastValue(ptr<BVBroadcastMessage> _m,
+                                                 ptr<vector<ptr<NetworkMessage>>> _outgoing) {
 
     auto v = _m->getValue();
     auto r = _m->getRound();
 
-    if (broadcastValues[r].count(v) > 0)
+    if (getRoundVotes(r).isBroadcast(v))
         return;
 
     auto newMsg = make_shared<BVBroadcastMessage>(_m->getBlockID(), _m->getBlockProposerIndex(), _m->getRound(),
                                                   _m->getValue(), Time::getCurrentTimeMs(),
                                                   *this);
 
-    getSchain()->getNode()->getNetwork()->broadcastMessage(newMsg);
+    if (_outgoing != nullptr) {
+        _outgoing->push_back(newMsg);
+    } else {
+        getSchain()->getNode()->getNetwork()->broadcastMessage(newMsg);
+    }
 
-    broadcastValues[r].insert(bin_consensus_value(v == 1));
+    getRoundVotes(r).setBroadcast(bin_consensus_value(v == 1));
 }
 
 
@@ -428,25 +428,37 @@ void BinConsensusInstance::proceedWithCommonCoinIfAUXTwoThird(bin_consensus_roun
     bool hasTrue = false;
     bool hasFalse = false;
 
-    if (binValues[_r].count(bin_consensus_value(true)) > 0 && auxTrueVotes[_r].size() > 0) {
-        verifiedValuesSize += auxTrueVotes[_r].size();
+    auto &votes = getRoundVotes(_r);
+
+    auto trueCount = votes.getAUXVoteCount(bin_consensus_value(true));
+    auto falseCount = votes.getAUXVoteCount(bin_consensus_value(false));
+
+    if (votes.hasBinValue(bin_consensus_value(true)) && trueCount > 0) {
+        verifiedValuesSize += trueCount;
         hasTrue = true;
     }
 
-    if (binValues[_r].count(bin_consensus_value(false)) > 0 && auxFalseVotes[_r].size() > 0) {
-        verifiedValuesSize += auxFalseVotes[_r].size();
+    if (votes.hasBinValue(bin_consensus_value(false)) && falseCount > 0) {
+        verifiedValuesSize += falseCount;
         hasFalse = true;
     }
 
     if (isTwoThird(node_count(verifiedValuesSize))) {
 
+        // the coin of round 0 is fixed. Agreement does not depend on the coin being random, only
+        // termination does, and the later rounds still use the real coin
+        if (_r == 0 && getSchain()->getNode()->isFastPathDecision()) {
+            proceedWithCommonCoin(hasTrue, hasFalse, bin_consensus_value(true));
+            return;
+        }
+
         uint64_t random;
 
         if (getSchain()->getNode()->isBlsEnabled()) {
             random = this->calculateBLSRandom(_r);
         } else {
-            srand((uint64_t) _r + (uint64_t) getBlockID() * 123456);
-            random = rand();
+            random = calculateDeterministicRandom(getSchain()->getSchainID(), getBlockID(),
+                                                  getBlockProposerIndex(), _r, getPreviousBlockHash());
         }
 
         auto randomDB = getSchain()->getNode()->getRandomDB();
@@ -454,21 +466,21 @@ void BinConsensusInstance::proceedWithCommonCoinIfAUXTwoThird(bin_consensus_roun
         randomDB->writeRandom(getBlockID(), getBlockProposerIndex(),
                               _r, random);
 
-        proceedWithCommonCoin(hasTrue, hasFalse, random);
+        proceedWithCommonCoin(hasTrue, hasFalse, bin_consensus_value(random % 2 == 0));
 
     }
 
 }
 
 
-void BinConsensusInstance::proceedWithCommonCoin(bool _hasTrue, bool _hasFalse, uint64_t _random) {
+void BinConsensusInstance::proceedWithCommonCoin(bool _hasTrue, bool _hasFalse, bin_consensus_value _coin) {
 
 
     ASSERT(!isDecided);
 
     LOG(debug, "ROUND_COMPLETE:BLOCK:" + to_string(blockID) + ":ROUND:" + to_string(getCurrentRound()));
 
-    bin_consensus_value random(_random % 2 == 0);
+    bin_consensus_value random = _coin;
 
     addCommonCoinToHistory(getCurrentRound(), random);
 
@@ -632,20 +644,57 @@ void BinConsensusInstance::initFromDB(const BlockConsensusAgent*
         decidedValue = db->readDV(blockID, blockProposerIndex);
     }
 
-    auto bvVotes = db->readBVBVotes(blockID, blockProposerIndex);
+    // rounds before the snapshot round come from the snapshot, only the tail is read vote by vote
+    bin_consensus_round fromRound = 0;
+
+    auto snapshot = db->readSnapshot(blockID, blockProposerIndex);
+
+    if (snapshot != nullptr) {
+        try {
+            auto snapshotRound = loadSnapshot(*snapshot);
+            // late votes of the previous round are not in the snapshot
+            fromRound = snapshotRound > 0 ? snapshotRound - 1 : 0;
+        } catch (exception &e) {
+            LOG(err, "Could not load consensus snapshot, reading all votes:" + string(e.what()));
+            rounds.clear();
+            proposals.clear();
+            fromRound = 0;
+        }
+    }
 
-    bvbTrueVotes.insert(bvVotes.first->begin(), bvVotes.first->end());
-    bvbFalseVotes.insert(bvVotes.second->begin(), bvVotes.second->end());
+    auto toRound = bin_consensus_round(fromRound > 0 ? (uint64_t) getCurrentRound() + 1 : ConsensusStateDB::ALL_ROUNDS);
+
+    auto bvVotes = db->readBVBVotes(blockID, blockProposerIndex, fromRound, toRound);
+
+    for (auto &&item : *bvVotes.first) {
+        for (auto &&index : item.second)
+            getRoundVotes(item.first).addBVBVote(bin_consensus_value(true), index);
+    }
+
+    for (auto &&item : *bvVotes.second) {
+        for (auto &&index : item.second)
+            getRoundVotes(item.first).addBVBVote(bin_consensus_value(false), index);
+    }
 
     auto auxVotes = db->readAUXVotes(blockID, blockProposerIndex,
-                                     _instance->getSchain()->getCryptoManager());
+                                     _instance->getSchain()->getCryptoManager(), fromRound, toRound);
+
+    for (auto &&item : *auxVotes.first) {
+        for (auto &&vote : item.second)
+            getRoundVotes(item.first).addAUXVote(bin_consensus_value(true), vote.first, vote.second);
+    }
 
-    auxTrueVotes.insert(auxVotes.first->begin(), auxVotes.first->end());
-    auxFalseVotes.insert(auxVotes.first->begin(), auxVotes.first->end());
+    for (auto &&item : *auxVotes.second) {
+        for (auto &&vote : item.second)
+            getRoundVotes(item.first).addAUXVote(bin_consensus_value(false), vote.first, vote.second);
+    }
 
-    auto bValues = db->readBinValues(blockID, blockProposerIndex);
+    auto bValues = db->readBinValues(blockID, blockProposerIndex, fromRound, toRound);
 
-    binValues.insert(bValues->begin(), bValues->end());
+    for (auto &&item : *bValues) {
+        for (auto &&value : item.second)
+            getRoundVotes(item.first).insertBinValue(value);
+    }
 
     auto props = db->readPRs(blockID, blockProposerIndex);
 
@@ -681,6 +730,141 @@ void BinConsensusInstance::initHistory(node_count _nodeCount) {
     }
 }
 
+RoundVotes &BinConsensusInstance::getRoundVotes(bin_consensus_round _r) {
+    while (rounds.size() <= (uint64_t) _r) {
+        rounds.emplace_back(getNodeCount());
+    }
+    return rounds[(uint64_t) _r];
+}
+
+
+static const uint8_t SNAPSHOT_VERSION = 2;
+
+// integers are stored little endian, so that snapshots do not depend on the host
+template<typename T>
+static void appendSnapshotValue(string &_out, T _value) {
+    for (uint64_t i = 0; i < sizeof(T); i++) {
+        _out.push_back((char) (uint8_t) ((uint64_t) _value >> (8 * i)));
+    }
+}
+
+template<typename T>
+static T readSnapshotValue(const char *&_data, const char *_end) {
+    CHECK_STATE2((uint64_t) (_end - _data) >= sizeof(T), "Consensus snapshot is too short");
+    uint64_t value = 0;
+    for (uint64_t i = 0; i < sizeof(T); i++) {
+        value |= (uint64_t) (uint8_t) _data[i] << (8 * i);
+    }
+    _data += sizeof(T);
+    return (T) value;
+}
+
+static void appendSnapshotString(string &_out, const string &_value) {
+    appendSnapshotValue<uint32_t>(_out, (uint32_t) _value.size());
+    _out.append(_value);
+}
+
+static ptr<string> readSnapshotString(const char *&_data, const char *_end) {
+    auto size = readSnapshotValue<uint32_t>(_data, _end);
+    CHECK_STATE2((uint64_t) (_end - _data) >= size, "Consensus snapshot is too short");
+    auto result = make_shared<string>(_data, size);
+    _data += size;
+    return result;
+}
+
+string BinConsensusInstance::createSnapshot() {
+
+    string result;
+
+    appendSnapshotValue<uint8_t>(result, SNAPSHOT_VERSION);
+    appendSnapshotValue<uint64_t>(result, (uint64_t) getCurrentRound());
+    appendSnapshotValue<uint8_t>(result, isDecided);
+    appendSnapshotValue<uint64_t>(result, isDecided ? (uint64_t) decidedRound : 0);
+    appendSnapshotValue<uint8_t>(result, isDecided ? (uint8_t) decidedValue : 0);
+
+    appendSnapshotValue<uint64_t>(result, proposals.size());
+    for (auto &&item : proposals) {
+        appendSnapshotValue<uint64_t>(result, (uint64_t) item.first);
+        appendSnapshotValue<uint8_t>(result, (uint8_t) item.second);
+    }
+
+    auto nodeCount = (uint64_t) getSchain()->getNodeCount();
+
+    appendSnapshotValue<uint64_t>(result, rounds.size());
+    for (auto &&votes : rounds) {
+        votes.serialize(result);
+        // AUX sig shares of the votes set in the bitsets, false first
+        for (uint8_t v = 0; v <= 1; v++) {
+            for (uint64_t i = 1; i <= nodeCount; i++) {
+                if (!votes.hasAUXVote(bin_consensus_value(v), schain_index(i)))
+                    continue;
+                auto sigShare = votes.getAUXSigShare(bin_consensus_value(v), schain_index(i));
+                CHECK_STATE(sigShare);
+                appendSnapshotString(result, *sigShare->toString());
+            }
+        }
+    }
+
+    return result;
+}
+
+bin_consensus_round BinConsensusInstance::loadSnapshot(const string &_snapshot) {
+
+    auto data = _snapshot.data();
+    auto end = data + _snapshot.size();
+
+    CHECK_STATE2(readSnapshotValue<uint8_t>(data, end) == SNAPSHOT_VERSION, "Unknown consensus snapshot version");
+
+    auto snapshotRound = bin_consensus_round(readSnapshotValue<uint64_t>(data, end));
+
+    if (readSnapshotValue<uint8_t>(data, end)) {
+        isDecided = true;
+        decidedRound = readSnapshotValue<uint64_t>(data, end);
+        decidedValue = readSnapshotValue<uint8_t>(data, end);
+    } else {
+        readSnapshotValue<uint64_t>(data, end);
+        readSnapshotValue<uint8_t>(data, end);
+    }
+
+    auto proposalCount = readSnapshotValue<uint64_t>(data, end);
+    for (uint64_t i = 0; i < proposalCount; i++) {
+        auto r = bin_consensus_round(readSnapshotValue<uint64_t>(data, end));
+        proposals[r] = bin_consensus_value(readSnapshotValue<uint8_t>(data, end));
+    }
+
+    auto nodeCount = (uint64_t) getSchain()->getNodeCount();
+    auto cryptoManager = getSchain()->getCryptoManager();
+
+    auto roundCount = readSnapshotValue<uint64_t>(data, end);
+    for (uint64_t r = 0; r < roundCount; r++) {
+        auto &votes = getRoundVotes(r);
+        votes.deserialize(data, end);
+        for (uint8_t v = 0; v <= 1; v++) {
+            for (uint64_t i = 1; i <= nodeCount; i++) {
+                if (!votes.hasAUXVote(bin_consensus_value(v), schain_index(i)))
+                    continue;
+                auto sigShare = cryptoManager->createSigShare(readSnapshotString(data, end),
+                                                              getSchain()->getSchainID(), getBlockID(), i);
+                votes.addAUXVote(bin_consensus_value(v), schain_index(i), sigShare);
+            }
+        }
+    }
+
+    CHECK_STATE2(data == end, "Trailing bytes in consensus snapshot");
+
+    if (snapshotRound > getCurrentRound())
+        currentRound = snapshotRound;
+
+    return snapshotRound;
+}
+
+void BinConsensusInstance::saveSnapshot() {
+#ifdef CONSENSUS_STATE_PERSISTENCE
+    getSchain()->getNode()->getConsensusStateDB()->writeSnapshot(getBlockID(), blockProposerIndex,
+                                                                 createSnapshot());
+#endif
+}
+
 bin_consensus_round BinConsensusInstance::getCurrentRound() {
     return currentRound;
 }
@@ -689,6 +873,7 @@ void BinConsensusInstance::setCurrentRound(bin_consensus_round _currentRound) {
     currentRound = _currentRound;
     getSchain()->getNode()->getConsensusStateDB()->writeCR(getBlockID(),
                                                            blockProposerIndex, _currentRound);
+    saveSnapshot();
 }
 
 bool BinConsensusInstance::decided() const {
@@ -714,21 +899,15 @@ uint64_t BinConsensusInstance::calculateBLSRandom(bin_consensus_round _r) {
 
     auto shares = getSchain()->getCryptoManager()->createSigShareSet(getBlockID());
 
-    if (binValues[_r].count(bin_consensus_value(true)) > 0 && auxTrueVotes[_r].size() > 0) {
-        for (auto &&item: auxTrueVotes[_r]) {
-            ASSERT(item.second);
-            shares->addSigShare(item.second);
-            if (shares->isEnough())
-                break;
-        }
-    }
+    auto &votes = getRoundVotes(_r);
 
-    if (binValues[_r].count(bin_consensus_value(false)) > 0 && auxFalseVotes[_r].size() > 0) {
-        for (auto &&item: auxFalseVotes[_r]) {
-            ASSERT(item.second);
-            shares->addSigShare(item.second);
-            if (shares->isEnough())
-                break;
+    for (auto v : {bin_consensus_value(true), bin_consensus_value(false)}) {
+        if (!votes.hasBinValue(v))
+            continue;
+        for (uint64_t i = 1; i <= (uint64_t) getNodeCount() && !shares->isEnough(); i++) {
+            auto sigShare = votes.getAUXSigShare(v, schain_index(i));
+            if (sigShare != nullptr)
+                shares->addSigShare(sigShare);
         }
     }
 
@@ -741,6 +920,73 @@ uint64_t BinConsensusInstance::calculateBLSRandom(bin_consensus_round _r) {
     return random;
 }
 
+ptr<SHAHash> BinConsensusInstance::getPreviousBlockHash() {
+
+    if (previousBlockHash != nullptr)
+        return previousBlockHash;
+
+    if (getBlockID() <= 1) {
+        previousBlockHash = make_shared<SHAHash>(make_shared<array<uint8_t, SHA_HASH_LEN>>());
+        previousBlockHash->getHash()->fill(0);
+        return previousBlockHash;
+    }
+
+    ptr<CommittedBlock> previousBlock = nullptr;
+
+    try {
+        previousBlock = getSchain()->getBlock(getBlockID() - 1);
+    } catch (ExitRequestedException &) { throw; } catch (exception &e) {
+        Exception::logNested(e);
+    }
+
+    if (previousBlock != nullptr) {
+        previousBlockHash = previousBlock->getHash();
+        return previousBlockHash;
+    }
+
+    previousBlockHash = getSchain()->getLastCommittedBlockHash(getBlockID() - 1);
+
+    if (previousBlockHash != nullptr)
+        return previousBlockHash;
+
+    // a coin that differs from other nodes only delays termination, agreement does not depend on it
+    LOG(err, "Can not read block " + to_string(getBlockID() - 1) + ", using a zero hash for the common coin");
+
+    previousBlockHash = make_shared<SHAHash>(make_shared<array<uint8_t, SHA_HASH_LEN>>());
+    previousBlockHash->getHash()->fill(0);
+
+    return previousBlockHash;
+}
+
+
+uint64_t BinConsensusInstance::calculateDeterministicRandom(schain_id _schainID, block_id _blockID,
+                                                            schain_index _proposerIndex, bin_consensus_round _r,
+                                                            ptr<SHAHash> _previousBlockHash) {
+    CHECK_ARGUMENT(_previousBlockHash != nullptr);
+
+    uint64_t schainID = (uint64_t) _schainID;
+    uint64_t blockID = (uint64_t) _blockID;
+    uint64_t proposerIndex = (uint64_t) _proposerIndex;
+    uint64_t round = (uint64_t) _r;
+
+    // the hasher lives on the stack, so concurrent instances do not share anything
+    SHA256Hasher sha256;
+    SHA3_UPDATE(sha256, schainID);
+    SHA3_UPDATE(sha256, blockID);
+    SHA3_UPDATE(sha256, proposerIndex);
+    SHA3_UPDATE(sha256, round);
+    sha256.update(_previousBlockHash->data(), SHA_HASH_LEN);
+
+    uint8_t digest[SHA_HASH_LEN];
+    sha256.final(digest);
+
+    uint64_t random;
+    memcpy(&random, digest, sizeof(random));
+
+    return random;
+}
+
+
 void BinConsensusInstance::setDecidedRoundAndValue(const bin_consensus_round &_decidedRound,
                                                    const bin_consensus_value &_decidedValue) {
     isDecided = true;
@@ -749,6 +995,8 @@ void BinConsensusInstance::setDecidedRoundAndValue(const bin_consensus_round &_d
     decidedRound = _decidedRound;
     decidedValue = _decidedValue;
 
+    saveSnapshot();
+
     addDecideToHistory(decidedRound, decidedValue);
 
 }
@@ -37,8 +37,10 @@ class BVBroadcastMessage;
 class NetworkMessageEnvelope;
 class Schain;
 class ProtocolKey;
+class SHAHash;
 
 #include "thirdparty/lrucache.hpp"
+#include "RoundVotes.h"
 
 class BinConsensusInstance : public ProtocolInstance{
 
@@ -76,10 +78,6 @@ class BinConsensusInstance : public ProtocolInstance{
     // non-essential tracing data tracing proposals for each round
     map  <bin_consensus_round, bin_consensus_value> proposals;
 
-    // Used to make sure the same message is not broadcast twice. Does not need to be
-    // saved in the DB
-    map<bin_consensus_round, set<bin_consensus_value>> broadcastValues;
-
 #ifdef CONSENSUS_DEBUG
 
     // non-essential debugging
@@ -98,22 +96,36 @@ class BinConsensusInstance : public ProtocolInstance{
 
     std::atomic<bin_consensus_round> currentRound = bin_consensus_round(0);
 
-    map<bin_consensus_round, set<schain_index>> bvbTrueVotes;
-    map<bin_consensus_round, set<schain_index>> bvbFalseVotes;
+    // BV votes, AUX votes and bin values indexed by round. Also tracks values that were
+    // already broadcast, so that the same message is not broadcast twice; that part does not
+    // need to be saved in the DB
+    vector<RoundVotes> rounds;
+
+    // END OF ESSENTIAL PROTOCOL FIELDS
 
-    map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>> auxTrueVotes;
-    map<bin_consensus_round, map<schain_index, ptr<ThresholdSigShare>>> auxFalseVotes;
+    // read once from the block DB, input of the common coin if BLS is disabled
+    ptr<SHAHash> previousBlockHash = nullptr;
 
-    map<bin_consensus_round, set<bin_consensus_value>> binValues;
+    RoundVotes &getRoundVotes(bin_consensus_round _r);
 
-    // END OF ESSENTIAL PROTOCOL FIELDS
+    /**
+     * Compact state of the instance: current round, decision, proposals, vote bitsets and AUX sig shares of all rounds
+     */
+    string createSnapshot();
+
+    /**
+     * @return round of the snapshot, throws if the snapshot is malformed
+     */
+    bin_consensus_round loadSnapshot(const string &_snapshot);
+
+    void saveSnapshot();
 
     void processNetworkMessageImpl(ptr<NetworkMessageEnvelope> _me);
 
 
     void networkBroadcastValueIfThird(ptr<BVBroadcastMessage>  _m);
 
-    void networkBroadcastValue(ptr<BVBroadcastMessage> _m);
+    void networkBroadcastValue(ptr<BVBroadcastMessage> _m, ptr<vector<ptr<NetworkMessage>>> _outgoing = nullptr);
 
     void setProposal(bin_consensus_round _r, bin_consensus_value _v);
 
@@ -142,7 +154,7 @@ class BinConsensusInstance : public ProtocolInstance{
 
     bool isTwoThird(node_count _count);
 
-    void proceedWithCommonCoin(bool _hasTrue, bool _hasFalse, uint64_t _random);
+    void proceedWithCommonCoin(bool _hasTrue, bool _hasFalse, bin_consensus_value _coin);
 
     void proceedWithNewRound(bin_consensus_value _value);
 
@@ -174,6 +186,8 @@ class BinConsensusInstance : public ProtocolInstance{
 
     uint64_t calculateBLSRandom(bin_consensus_round _r);
 
+    ptr<SHAHash> getPreviousBlockHash();
+
     void addDecideToGlobalHistory(bin_consensus_value _decidedValue);
 
     void setCurrentRound(bin_consensus_round _currentRound);
@@ -187,6 +201,16 @@ class BinConsensusInstance : public ProtocolInstance{
 
 public:
 
+    /**
+     * Common coin when BLS is disabled: a hash keyed by the schain id of the block id, proposer index,
+     * round and previous block hash. Same on every node, and uses no shared state.
+     * There is no secret in it, so anyone can predict the coin. This is for tests only:
+     * production chains run with BLS enabled, where the coin is a threshold signature.
+     */
+    static uint64_t calculateDeterministicRandom(schain_id _schainID, block_id _blockID,
+                                                 schain_index _proposerIndex, bin_consensus_round _r,
+                                                 ptr<SHAHash> _previousBlockHash);
+
     bool decided() const;
 
     const block_id getBlockID() const;
@@ -201,7 +225,10 @@ public:
 
     void processMessage(ptr<MessageEnvelope> _m);
 
-    void processParentProposal(ptr<InternalMessageEnvelope> _me);
+    /**
+     * If _outgoing is set, the initial BV message is appended to it instead of being broadcast
+     */
+    void processParentProposal(ptr<InternalMessageEnvelope> _me, ptr<vector<ptr<NetworkMessage>>> _outgoing = nullptr);
 
     BinConsensusInstance(BlockConsensusAgent* _instance, block_id _blockId, schain_index _blockProposerIndex,
             bool _initFromDB = false);
@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file RoundVotes.cpp
+    @author agent
+    @date 2026
+*/
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "RoundVotes.h"
+
+
+static constexpr uint64_t BV_BITSET = 0;
+static constexpr uint64_t AUX_BITSET = 2;
+
+
+RoundVotes::RoundVotes(node_count _nodeCount) : nodeCount((uint64_t) _nodeCount),
+                                                 words(((uint64_t) _nodeCount + 63) / 64),
+                                                 bits(BITSETS * words, 0),
+                                                 auxSigShares(2 * (uint64_t) _nodeCount) {
+    CHECK_ARGUMENT(_nodeCount > 0);
+}
+
+
+uint64_t RoundVotes::count(uint64_t _k) const {
+    auto b = bits.data() + _k * words;
+    uint64_t result = 0;
+    for (uint64_t i = 0; i < words; i++) {
+        result += __builtin_popcountll(b[i]);
+    }
+    return result;
+}
+
+
+bool RoundVotes::set(uint64_t _k, schain_index _index) {
+    CHECK_ARGUMENT(_index > 0 && (uint64_t) _index <= nodeCount);
+    auto i = (uint64_t) _index - 1;
+    auto &word = bitset(_k)[i / 64];
+    auto mask = (uint64_t) 1 << (i % 64);
+    if (word & mask)
+        return false;
+    word |= mask;
+    return true;
+}
+
+
+bool RoundVotes::test(uint64_t _k, schain_index _index) const {
+    CHECK_ARGUMENT(_index > 0 && (uint64_t) _index <= nodeCount);
+    auto i = (uint64_t) _index - 1;
+    return (bits[_k * words + i / 64] >> (i % 64)) & 1;
+}
+
+
+bool RoundVotes::addBVBVote(bin_consensus_value _v, schain_index _index) {
+    return set(BV_BITSET + (_v ? 1 : 0), _index);
+}
+
+
+void RoundVotes::addAUXVote(bin_consensus_value _v, schain_index _index, ptr<ThresholdSigShare> _sigShare) {
+    set(AUX_BITSET + (_v ? 1 : 0), _index);
+    auxSigShares[(_v ? nodeCount : 0) + (uint64_t) _index - 1] = _sigShare;
+}
+
+
+bool RoundVotes::hasAUXVote(bin_consensus_value _v, schain_index _index) const {
+    return test(AUX_BITSET + (_v ? 1 : 0), _index);
+}
+
+
+ptr<ThresholdSigShare> RoundVotes::getAUXSigShare(bin_consensus_value _v, schain_index _index) const {
+    CHECK_ARGUMENT(_index > 0 && (uint64_t) _index <= nodeCount);
+    return auxSigShares[(_v ? nodeCount : 0) + (uint64_t) _index - 1];
+}
+
+
+uint64_t RoundVotes::getBVBVoteCount(bin_consensus_value _v) const {
+    return count(BV_BITSET + (_v ? 1 : 0));
+}
+
+
+uint64_t RoundVotes::getAUXVoteCount(bin_consensus_value _v) const {
+    return count(AUX_BITSET + (_v ? 1 : 0));
+}
+
+
+uint64_t RoundVotes::getTotalAUXVoteCount() const {
+    return count(AUX_BITSET) + count(AUX_BITSET + 1);
+}
+
+
+bool RoundVotes::hasBinValue(bin_consensus_value _v) const {
+    return (binValues >> (_v ? 1 : 0)) & 1;
+}
+
+
+bool RoundVotes::hasBinValues() const {
+    return binValues != 0;
+}
+
+
+void RoundVotes::insertBinValue(bin_consensus_value _v) {
+    binValues |= (uint8_t) (1 << (_v ? 1 : 0));
+}
+
+
+bool RoundVotes::isBroadcast(bin_consensus_value _v) const {
+    return (broadcastValues >> (_v ? 1 : 0)) & 1;
+}
+
+
+void RoundVotes::setBroadcast(bin_consensus_value _v) {
+    broadcastValues |= (uint8_t) (1 << (_v ? 1 : 0));
+}
+
+
+void RoundVotes::serialize(string &_out) const {
+    _out.push_back((char) binValues);
+    _out.push_back((char) broadcastValues);
+    for (auto word : bits) {
+        word = htole64(word);
+        _out.append((const char *) &word, sizeof(uint64_t));
+    }
+}
+
+
+void RoundVotes::deserialize(const char *&_data, const char *_end) {
+    auto size = 2 + bits.size() * sizeof(uint64_t);
+
+    CHECK_ARGUMENT(_data != nullptr && _end >= _data);
+    CHECK_STATE2((uint64_t) (_end - _data) >= size, "Round votes snapshot is too short");
+
+    binValues = (uint8_t) _data[0];
+    broadcastValues = (uint8_t) _data[1];
+    for (uint64_t i = 0; i < bits.size(); i++) {
+        uint64_t word;
+        memcpy(&word, _data + 2 + i * sizeof(uint64_t), sizeof(uint64_t));
+        bits[i] = le64toh(word);
+    }
+
+    _data += size;
+}
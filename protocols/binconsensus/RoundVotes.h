@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file RoundVotes.h
+    @author agent
+    @date 2026
+*/
+
+#pragma  once
+
+
+class ThresholdSigShare;
+
+
+/**
+ * Votes of a single binary consensus round.
+ * BV and AUX votes are bitsets over schain indices, so that inserting a vote does not allocate
+ * and counting votes is a popcount. AUX sig shares are kept in a flat array indexed by schain index.
+ */
+class RoundVotes {
+
+    // BV false, BV true, AUX false, AUX true
+    static constexpr uint64_t BITSETS = 4;
+
+    uint64_t nodeCount;
+
+    uint64_t words;
+
+    vector<uint64_t> bits;
+
+    // nodeCount shares for false, then nodeCount shares for true
+    vector<ptr<ThresholdSigShare>> auxSigShares;
+
+    uint8_t binValues = 0;
+
+    uint8_t broadcastValues = 0;
+
+    uint64_t *bitset(uint64_t _k) {
+        return bits.data() + _k * words;
+    }
+
+    uint64_t count(uint64_t _k) const;
+
+    bool set(uint64_t _k, schain_index _index);
+
+    bool test(uint64_t _k, schain_index _index) const;
+
+public:
+
+    explicit RoundVotes(node_count _nodeCount);
+
+    /**
+     * @return false if the node already voted for this value
+     */
+    bool addBVBVote(bin_consensus_value _v, schain_index _index);
+
+    void addAUXVote(bin_consensus_value _v, schain_index _index, ptr<ThresholdSigShare> _sigShare);
+
+    bool hasAUXVote(bin_consensus_value _v, schain_index _index) const;
+
+    /**
+     * @return nullptr if the node did not vote for this value
+     */
+    ptr<ThresholdSigShare> getAUXSigShare(bin_consensus_value _v, schain_index _index) const;
+
+    uint64_t getBVBVoteCount(bin_consensus_value _v) const;
+
+    uint64_t getAUXVoteCount(bin_consensus_value _v) const;
+
+    uint64_t getTotalAUXVoteCount() const;
+
+    bool hasBinValue(bin_consensus_value _v) const;
+
+    bool hasBinValues() const;
+
+    void insertBinValue(bin_consensus_value _v);
+
+    bool isBroadcast(bin_consensus_value _v) const;
+
+    void setBroadcast(bin_consensus_value _v);
+
+    /**
+     * Appends bin values, broadcast values and vote bitsets, little endian. AUX sig shares are not included
+     */
+    void serialize(string &_out) const;
+
+    /**
+     * Reads what serialize() wrote and advances _data, throws if the input is too short
+     */
+    void deserialize(const char *&_data, const char *_end);
+};
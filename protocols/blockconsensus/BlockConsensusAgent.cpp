@@ -27,7 +27,6 @@
 #include "thirdparty/json.hpp"
 
 #include "blockfinalize/client/BlockFinalizeDownloader.h"
-#include "blockfinalize/client/BlockFinalizeDownloaderThreadPool.h"
 #include "blockproposal/pusher/BlockProposalClientAgent.h"
 #include "chains/Schain.h"
 #include "crypto/SHAHash.h"
@@ -90,7 +89,8 @@ BlockConsensusAgent::BlockConsensusAgent(Schain &_schain) : ProtocolInstance(
 };
 
 
-void BlockConsensusAgent::startConsensusProposal(block_id _blockID, ptr<BooleanProposalVector> _proposal) {
+void BlockConsensusAgent::startConsensusProposal(block_id _blockID, ptr<BooleanProposalVector> _proposal,
+                                                 uint64_t _shard) {
 
 
     try {
@@ -110,16 +110,36 @@ void BlockConsensusAgent::startConsensusProposal(block_id _blockID, ptr<BooleanP
 
         ASSERT(3 * truthCount > getSchain()->getNodeCount() * 2);
 
+        auto nodeCount = (uint64_t) getSchain()->getNodeCount();
+        auto shardCount = getSchain()->getMessageShardCount();
+
+        CHECK_ARGUMENT(_shard < shardCount);
+
+        vector<ptr<BinConsensusInstance>> instances;
+
+        {
+            LOCK(m)
+            for (uint64_t i = _shard + 1; i <= nodeCount; i += shardCount) {
+                instances.push_back(getChild(make_shared<ProtocolKey>(_blockID, schain_index(i))));
+            }
+        }
 
-        for (uint64_t i = 1; i <= (uint64_t) getSchain()->getNodeCount(); i++) {
+        // initial BV messages of the shard proposers go out together
+        auto messages = make_shared<vector<ptr<NetworkMessage>>>();
 
-            bin_consensus_value x;
+        for (auto &&instance : instances) {
+            auto x = bin_consensus_value(_proposal->getProposalValue(instance->getBlockProposerIndex()) ? 1 : 0);
 
-            x = bin_consensus_value(_proposal->getProposalValue(schain_index(i)) ? 1 : 0);
+            // nodes with even indices vote 0 for odd proposers, so that round 0 of their instances is split
+            INJECT_TEST(SPLIT_CONSENSUS_VOTE_TEST,
+                        if ((uint64_t) getSchain()->getSchainIndex() % 2 == 0 &&
+                            (uint64_t) instance->getBlockProposerIndex() % 2 == 1) x = bin_consensus_value(0))
 
-            propose(x, schain_index(i), _blockID);
+            propose(x, instance, _blockID, messages);
         }
 
+        getSchain()->getNode()->getNetwork()->broadcastMessages(messages);
+
     } catch (ExitRequestedException &) { throw; } catch (Exception &e) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
@@ -135,23 +155,22 @@ void BlockConsensusAgent::processChildMessageImpl(ptr<InternalMessageEnvelope> _
     reportConsensusAndDecideIfNeeded(msg);
 }
 
-void BlockConsensusAgent::propose(bin_consensus_value _proposal, schain_index _index, block_id _id) {
-
-    try {
+void BlockConsensusAgent::propose(bin_consensus_value _proposal, ptr<BinConsensusInstance> _child, block_id _id,
+                                  ptr<vector<ptr<NetworkMessage>>> _outgoing) {
 
+    CHECK_ARGUMENT(_child);
 
-        auto key = make_shared<ProtocolKey>(_id, _index);
-
-        auto child = getChild(key);
+    try {
 
-        auto msg = make_shared<BVBroadcastMessage>(_id, _index, bin_consensus_round(0), _proposal,
-                Time::getCurrentTimeMs(), *child);
+        auto msg = make_shared<BVBroadcastMessage>(_id, _child->getBlockProposerIndex(), bin_consensus_round(0),
+                _proposal, Time::getCurrentTimeMs(), *_child);
 
 
         auto id = (uint64_t) msg->getBlockId();
         ASSERT(id != 0);
 
-        child->processParentProposal(make_shared<InternalMessageEnvelope>(ORIGIN_PARENT, msg, *getSchain()));
+        _child->processParentProposal(make_shared<InternalMessageEnvelope>(ORIGIN_PARENT, msg, *getSchain()),
+                                      _outgoing);
 
     } catch (ExitRequestedException &) { throw; } catch (...) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
@@ -173,16 +192,14 @@ void BlockConsensusAgent::decideBlock(block_id _blockId, schain_index _sChainInd
         auto msg = make_shared<BlockSignBroadcastMessage>(_blockId, _sChainIndex,
                 Time::getCurrentTimeMs(), *this);
 
-        auto signature = getSchain()->getNode()->getBlockSigShareDB()->checkAndSaveShare(msg->getSigShare(),
+        auto hash = BlockSignBroadcastMessage::calculateBlockSigHash(_sChainIndex, _blockId,
+                                                                     getSchain()->getSchainID());
+
+        auto signature = getSchain()->getNode()->getBlockSigShareDB()->checkAndSaveShare(msg->getSigShare(), hash,
                                                                                          getSchain()->getCryptoManager());
 
         getSchain()->getNode()->getNetwork()->broadcastMessage(msg);
 
-        ASSERT(!decidedIndices->exists((uint64_t) _blockId));
-
-        decidedIndices->put((uint64_t) _blockId, _sChainIndex);
-
-
         if (signature != nullptr) {
             getSchain()->finalizeDecidedAndSignedBlock( _blockId, _sChainIndex, signature );
         }
@@ -195,16 +212,28 @@ void BlockConsensusAgent::decideBlock(block_id _blockId, schain_index _sChainInd
 }
 
 
-void BlockConsensusAgent::decideDefaultBlock(block_id _blockNumber) {
+void BlockConsensusAgent::reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMessage> _msg) {
+
     try {
-        decideBlock(_blockNumber, schain_index(0), make_shared<string>("DEFAULT_BLOCK"));
+        schain_index decidedIndex(0);
+
+        // only the decision is recorded under the lock, signing and broadcasting happen outside of it
+        auto stats = recordDecisionIfNeeded(_msg, decidedIndex);
+
+        if (stats != nullptr) {
+            decideBlock(_msg->getBlockId(), decidedIndex, stats);
+        }
     } catch (ExitRequestedException &) { throw; } catch (Exception &e) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
 }
 
 
-void BlockConsensusAgent::reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMessage> _msg) {
+ptr<string> BlockConsensusAgent::recordDecisionIfNeeded(ptr<ChildBVDecidedMessage> _msg,
+                                                        schain_index &_decidedIndex) {
+
+    // children of different proposers may report from different message shards
+    LOCK(m)
 
     try {
 
@@ -214,13 +243,13 @@ void BlockConsensusAgent::reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMes
 
         if (blockID <= getSchain()->getLastCommittedBlockID()) {
             // Old consensus is reporting, already got this block through catchup
-            return;
+            return nullptr;
         }
 
         ASSERT(blockProposerIndex <= nodeCount);
 
 
-        if (decidedIndices->exists((uint64_t) blockID)) { return; }
+        if (decidedIndices->exists((uint64_t) blockID)) { return nullptr; }
 
 
         if (_msg->getValue()) {
@@ -245,9 +274,11 @@ void BlockConsensusAgent::reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMes
             trueDecisions->get((uint64_t) blockID)->empty()) {
             if (falseDecisions->exists((uint64_t) blockID) &&
                 (uint64_t) falseDecisions->get((uint64_t) blockID)->size() == nodeCount) {
-                decideDefaultBlock(blockID);
+                decidedIndices->put((uint64_t) blockID, schain_index(0));
+                _decidedIndex = 0;
+                return make_shared<string>("DEFAULT_BLOCK");
             }
-            return;
+            return nullptr;
         }
 
 
@@ -274,18 +305,17 @@ void BlockConsensusAgent::reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMes
             if (trueDecisions->exists((uint64_t) blockID) &&
                 trueDecisions->get((uint64_t) blockID)->count(index) > 0) {
 
-                ptr<string> statsString = buildStats(blockID);
-
-
-
-                decideBlock(blockID, index, statsString);
-                return;
+                decidedIndices->put((uint64_t) blockID, index);
+                _decidedIndex = index;
+                return buildStats(blockID);
             }
             if (!falseDecisions->exists((uint64_t) blockID) ||
                 falseDecisions->get((uint64_t) blockID)->count(index) == 0) {
-                return;
+                return nullptr;
             }
         }
+
+        return nullptr;
     } catch (ExitRequestedException &) { throw; } catch (Exception &e) {
         throw_with_nested(InvalidStateException(__FUNCTION__, __CLASS_NAME__));
     }
@@ -294,17 +324,23 @@ void BlockConsensusAgent::reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMes
 
 
 void BlockConsensusAgent::processBlockSignMessage(ptr<BlockSignBroadcastMessage> _message) {
+
+    LOCK(m)
+
     try {
+        auto proposer = _message->getBlockProposerIndex();
+        auto blockId = _message->getBlockId();
+
+        auto hash = BlockSignBroadcastMessage::calculateBlockSigHash(proposer, blockId,
+                                                                     getSchain()->getSchainID());
+
         auto signature =
-                getSchain()->getNode()->getBlockSigShareDB()->checkAndSaveShare(_message->getSigShare(),
+                getSchain()->getNode()->getBlockSigShareDB()->checkAndSaveShare(_message->getSigShare(), hash,
                                                                                 getSchain()->getCryptoManager());
         if (signature == nullptr) {
             return;
         }
 
-        auto proposer = _message->getBlockProposerIndex();
-        auto blockId = _message->getBlockId();
-
         LOG(info, string("BLOCK_DECIDE (GOT SIG): PRPSR:") + to_string(proposer) +
                   ":BID:" + to_string(blockId) + "| Now signing block ...");
 
@@ -319,7 +355,7 @@ void BlockConsensusAgent::processBlockSignMessage(ptr<BlockSignBroadcastMessage>
 };
 
 
-void BlockConsensusAgent::routeAndProcessMessage(ptr<MessageEnvelope> m) {
+void BlockConsensusAgent::routeAndProcessMessage(ptr<MessageEnvelope> m, uint64_t _shard) {
 
     try {
 
@@ -337,7 +373,8 @@ void BlockConsensusAgent::routeAndProcessMessage(ptr<MessageEnvelope> m) {
 
         if (m->getMessage()->getMessageType() == MSG_CONSENSUS_PROPOSAL) {
             this->startConsensusProposal(m->getMessage()->getBlockId(),
-                                         ((ConsensusProposalMessage *) m->getMessage().get())->getProposals());
+                                         ((ConsensusProposalMessage *) m->getMessage().get())->getProposals(),
+                                         _shard);
             return;
         }
 
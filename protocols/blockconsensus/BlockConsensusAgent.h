@@ -56,13 +56,20 @@ class BlockConsensusAgent : public ProtocolInstance {
 
     void decideBlock(block_id _blockId, schain_index _sChainIndex, ptr<string> _stats);
 
-    void propose(bin_consensus_value _proposal, schain_index index, block_id _id);
+    void propose(bin_consensus_value _proposal, ptr<BinConsensusInstance> _child, block_id _id,
+                 ptr<vector<ptr<NetworkMessage>>> _outgoing);
 
     void reportConsensusAndDecideIfNeeded(ptr<ChildBVDecidedMessage> _msg);
 
-    void decideDefaultBlock(block_id _blockNumber);
+    /**
+     * Records the decided proposer of the block, if there is one yet, and returns the decision stats
+     */
+    ptr<string> recordDecisionIfNeeded(ptr<ChildBVDecidedMessage> _msg, schain_index &_decidedIndex);
 
-    void startConsensusProposal(block_id _blockID, ptr<BooleanProposalVector> _proposal);
+    /**
+     * Starts instances of the proposers that belong to _shard, (proposer - 1) % shard count == _shard
+     */
+    void startConsensusProposal(block_id _blockID, ptr<BooleanProposalVector> _proposal, uint64_t _shard);
 
 
     void processBlockSignMessage(ptr<BlockSignBroadcastMessage> _message);
@@ -91,7 +98,7 @@ public:
     bool shouldPost(ptr<NetworkMessage> _msg);
 
 
-    void routeAndProcessMessage(ptr<MessageEnvelope> m);
+    void routeAndProcessMessage(ptr<MessageEnvelope> m, uint64_t _shard = 0);
 
 };
 
@@ -27,6 +27,7 @@
 
 #include "messages/NetworkMessage.h"
 #include "crypto/SHAHash.h"
+#include "crypto/SHA256Hasher.h"
 
 #include "protocols/ProtocolKey.h"
 #include "protocols/ProtocolInstance.h"
@@ -38,6 +39,20 @@
 #include "crypto/ThresholdSigShare.h"
 
 
+ptr<SHAHash> BlockSignBroadcastMessage::calculateBlockSigHash(schain_index _blockProposerIndex, block_id _blockID,
+                                                             schain_id _schainID) {
+    SHA256Hasher sha256;
+    MsgType type = MSG_BLOCK_SIGN_BROADCAST;
+    sha256.update(reinterpret_cast < uint8_t * > ( &_blockProposerIndex), sizeof(_blockProposerIndex));
+    sha256.update(reinterpret_cast < uint8_t * > ( &_blockID), sizeof(_blockID));
+    sha256.update(reinterpret_cast < uint8_t * > ( &_schainID), sizeof(_schainID));
+    sha256.update(reinterpret_cast < uint8_t * > ( &type), sizeof(type));
+    auto buf = make_shared<array<uint8_t, SHA_HASH_LEN>>();
+    sha256.final(buf->data());
+    return make_shared<SHAHash>(buf);
+}
+
+
 bin_consensus_round BlockSignBroadcastMessage::getRound() const {
     CHECK_STATE(false);
 }
@@ -55,15 +70,7 @@ BlockSignBroadcastMessage::BlockSignBroadcastMessage(block_id _blockID, schain_i
     printPrefix = "f";
 
     auto schain = _sourceProtocolInstance.getSchain();
-    CryptoPP::SHA256 sha256;
-    auto bpi = getBlockProposerIndex();
-    sha256.Update(reinterpret_cast < uint8_t * > ( &bpi), sizeof(bpi));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->blockID), sizeof(blockID));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->schainID), sizeof(schainID));
-    sha256.Update(reinterpret_cast < uint8_t * > ( &this->msgType), sizeof(msgType));
-    auto buf = make_shared<array<uint8_t, SHA_HASH_LEN>>();
-    sha256.Final(buf->data());
-    auto hash = make_shared<SHAHash>(buf);
+    auto hash = calculateBlockSigHash(getBlockProposerIndex(), blockID, schainID);
 
     this->sigShare = schain->getCryptoManager()->signBlockSigShare(hash, _blockID);
     this->sigShareString = sigShare->toString();
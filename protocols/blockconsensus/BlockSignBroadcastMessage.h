@@ -23,6 +23,8 @@
 
 #pragma  once
 
+class SHAHash;
+
 class BlockSignBroadcastMessage : public NetworkMessage{
 public:
 
@@ -38,5 +40,8 @@ public:
     virtual bin_consensus_round getRound() const override ;
 
     virtual bin_consensus_value getValue() const override ;
+
+    static ptr<SHAHash> calculateBlockSigHash(schain_index _blockProposerIndex, block_id _blockID,
+                                              schain_id _schainID);
 };
 
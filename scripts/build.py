@@ -62,7 +62,7 @@ buildType = sys.argv[1];
 print("BUILD_TYPE=" + buildType)
 run ("ccache -M 20G")
 run("cmake . -Bbuild -DCMAKE_BUILD_TYPE=" +  buildType +
-                        " -DCOVERAGE=ON -DMICROPROFILE_ENABLED=0")
+                        " -DCOVERAGE=ON -DMICROPROFILE_ENABLED=0 -DCONSENSUS_STATE_PERSISTENCE=ON")
 run("cmake --build build -- -j$(nproc)")
 
 assert  os.path.isfile("build/consensust")
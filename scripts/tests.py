@@ -69,6 +69,12 @@ consensustExecutive = getConsensustExecutive()
 
 unitTest(consensustExecutive, "[tx-serialize]")
 unitTest(consensustExecutive, "[tx-list-serialize]")   
+unitTest(consensustExecutive, "[common-coin]")
+unitTest(consensustExecutive, "[ecdsa]")
+unitTest(consensustExecutive, "[bls-merge]")
+unitTest(consensustExecutive, "[bls-codec]")
+unitTest(consensustExecutive, "[sha]")
+unitTest(consensustExecutive, "[round-votes]")
 
 
 fullConsensusTest("sixteennodes", consensustExecutive, "[consensus-finalization-download]")
@@ -85,6 +91,20 @@ fullConsensusTest("fournodes", consensustExecutive, "[consensus-basic]")
 fullConsensusTest("sixteennodes", consensustExecutive, "[consensus-basic]")
 fullConsensusTest("fournodes_catchup", consensustExecutive, "[consensus-basic]")
 fullConsensusTest("three_out_of_four", consensustExecutive, "[consensus-basic]")
+fullConsensusTest("fournodes_pipelined", consensustExecutive, "[consensus-basic]")
+fullConsensusTest("fournodes_coalesced", consensustExecutive, "[consensus-basic]")
+fullConsensusTest("fournodes", consensustExecutive, "[bls-compact]")
+fullConsensusTest("fournodes_legacy_bls", consensustExecutive, "[bls-legacy-peer]")
+fullConsensusTest("fournodes_ext_queue", consensustExecutive, "[ext-face-queue]")
+fullConsensusTest("fournodes", consensustExecutive, "[consensus-restart]")
+
+fullConsensusTest("fournodes_fast_path", consensustExecutive, "[fast-path]")
+fullConsensusTest("fournodes_large_delay_fast_path", consensustExecutive, "[fast-path]")
+fullConsensusTest("three_out_of_four_fast_path", consensustExecutive, "[fast-path]")
+fullConsensusTest("fournodes_fast_path", consensustExecutive, "[fast-path-split-vote]")
+fullConsensusTest("three_out_of_four_fast_path", consensustExecutive, "[fast-path-split-vote]")
+fullConsensusTest("fournodes", consensustExecutive, "[corrupt-proposal]")
+fullConsensusTest("fournodes_fast_path", consensustExecutive, "[corrupt-proposal]")
 
 unitTest(consensustExecutive, "[tx-serialize]")
 unitTest(consensustExecutive, "[tx-list-serialize]")
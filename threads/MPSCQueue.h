@@ -0,0 +1,164 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file MPSCQueue.h
+    @author agent
+    @date 2026
+*/
+
+#pragma once
+
+
+/**
+ * Lock-free multiple producer single consumer queue.
+ *
+ * Producers push onto an intrusive stack with a single CAS. The consumer takes the whole
+ * stack with one exchange and reverses it, so items are drained in batches in FIFO order.
+ * The mutex is only touched when the consumer has to sleep on an empty queue.
+ */
+template<typename T>
+class MPSCQueue {
+
+    class Item {
+    public:
+        T value;
+        Item *next;
+
+        Item(T &&_value) : value(std::move(_value)), next(nullptr) {}
+    };
+
+    atomic<Item *> head = nullptr;
+
+    atomic<uint64_t> count = 0;
+
+    atomic<bool> consumerWaiting = false;
+
+    mutex waitMutex;
+
+    condition_variable waitCond;
+
+    bool closed = false;
+
+public:
+
+    MPSCQueue() = default;
+
+    MPSCQueue(const MPSCQueue &) = delete;
+
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    ~MPSCQueue() {
+        auto item = head.exchange(nullptr);
+        while (item != nullptr) {
+            auto next = item->next;
+            delete item;
+            item = next;
+        }
+    }
+
+    void push(T _value) {
+
+        auto item = new Item(std::move(_value));
+        item->next = head.load(memory_order_relaxed);
+
+        // counted before publishing, so that drain() never makes the count wrap
+        count++;
+
+        while (!head.compare_exchange_weak(item->next, item)) {}
+
+        // seq_cst on both sides, so either the consumer sees the item or we see the consumer waiting
+        if (consumerWaiting) {
+            lock_guard<mutex> lock(waitMutex);
+            waitCond.notify_one();
+        }
+    }
+
+    /**
+     * Appends all queued items to _batch in the order they were pushed
+     * @return number of items appended
+     */
+    uint64_t drain(vector<T> &_batch) {
+
+        auto item = head.exchange(nullptr);
+
+        if (item == nullptr)
+            return 0;
+
+        Item *reversed = nullptr;
+        uint64_t n = 0;
+
+        while (item != nullptr) {
+            auto next = item->next;
+            item->next = reversed;
+            reversed = item;
+            item = next;
+            n++;
+        }
+
+        _batch.reserve(_batch.size() + n);
+
+        while (reversed != nullptr) {
+            auto next = reversed->next;
+            _batch.push_back(std::move(reversed->value));
+            delete reversed;
+            reversed = next;
+        }
+
+        count -= n;
+
+        return n;
+    }
+
+    /**
+     * Same as drain(), but sleeps up to _timeoutMs if the queue is empty
+     */
+    uint64_t waitAndDrain(vector<T> &_batch, uint64_t _timeoutMs) {
+
+        auto n = drain(_batch);
+
+        if (n > 0)
+            return n;
+
+        {
+            unique_lock<mutex> lock(waitMutex);
+            consumerWaiting = true;
+            if (!closed && head.load() == nullptr)
+                waitCond.wait_for(lock, chrono::milliseconds(_timeoutMs));
+            consumerWaiting = false;
+        }
+
+        return drain(_batch);
+    }
+
+    /**
+     * Wakes up the consumer for good, used on exit
+     */
+    void close() {
+        lock_guard<mutex> lock(waitMutex);
+        closed = true;
+        waitCond.notify_all();
+    }
+
+    uint64_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return head.load() == nullptr;
+    }
+};
@@ -0,0 +1,207 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ReedSolomon.cpp
+    @author agent
+    @date 2026
+*/
+
+
+#include "SkaleCommon.h"
+#include "Log.h"
+#include "exceptions/FatalError.h"
+
+#include "ReedSolomon.h"
+
+
+ReedSolomon::GaloisTables::GaloisTables() {
+    // generator 2, primitive polynomial x^8 + x^4 + x^3 + x^2 + 1
+    uint64_t x = 1;
+    for (uint64_t i = 0; i < 255; i++) {
+        exp[i] = (uint8_t) x;
+        log[x] = (uint8_t) i;
+        x <<= 1;
+        if (x & 0x100)
+            x ^= 0x11d;
+    }
+    for (uint64_t i = 255; i < 512; i++) {
+        exp[i] = exp[i - 255];
+    }
+    log[0] = 0;
+}
+
+
+const ReedSolomon::GaloisTables &ReedSolomon::getTables() {
+    static const GaloisTables tables;
+    return tables;
+}
+
+
+uint8_t ReedSolomon::mul(uint8_t _a, uint8_t _b) {
+    if (_a == 0 || _b == 0)
+        return 0;
+    auto &t = getTables();
+    return t.exp[t.log[_a] + t.log[_b]];
+}
+
+
+uint8_t ReedSolomon::inv(uint8_t _a) {
+    CHECK_ARGUMENT(_a != 0);
+    auto &t = getTables();
+    return t.exp[255 - t.log[_a]];
+}
+
+
+uint8_t ReedSolomon::getCoefficient(uint64_t _shardIndex, uint64_t _dataIndex, uint64_t _dataShards) {
+    if (_shardIndex < _dataShards)
+        return (_shardIndex == _dataIndex) ? 1 : 0;
+    // Cauchy matrix 1 / (x_i + y_j), x_i = shard index, y_j = data index, the two sets are disjoint
+    return inv((uint8_t) (_shardIndex ^ _dataIndex));
+}
+
+
+void ReedSolomon::mulAdd(uint8_t _coefficient, const uint8_t *_src, uint8_t *_dst, uint64_t _len) {
+    if (_coefficient == 0)
+        return;
+
+    if (_coefficient == 1) {
+        for (uint64_t i = 0; i < _len; i++) {
+            _dst[i] ^= _src[i];
+        }
+        return;
+    }
+
+    array<uint8_t, 256> row;
+    for (uint64_t x = 0; x < 256; x++) {
+        row[x] = mul(_coefficient, (uint8_t) x);
+    }
+
+    for (uint64_t i = 0; i < _len; i++) {
+        _dst[i] ^= row[_src[i]];
+    }
+}
+
+
+uint64_t ReedSolomon::getShardSize(uint64_t _dataSize, uint64_t _dataShards) {
+    CHECK_ARGUMENT(_dataShards > 0);
+    return (_dataSize + _dataShards - 1) / _dataShards;
+}
+
+
+ptr<vector<uint8_t>> ReedSolomon::encodeShard(const vector<uint8_t> &_data, uint64_t _dataShards,
+                                              uint64_t _totalShards, uint64_t _index) {
+    CHECK_ARGUMENT(_dataShards > 0);
+    CHECK_ARGUMENT(_dataShards <= _totalShards);
+    CHECK_ARGUMENT(_totalShards <= MAX_SHARDS);
+    CHECK_ARGUMENT(_index < _totalShards);
+    CHECK_ARGUMENT(_data.size() > 0);
+
+    auto shardSize = getShardSize(_data.size(), _dataShards);
+
+    auto shard = make_shared<vector<uint8_t>>(shardSize, 0);
+
+    for (uint64_t j = 0; j < _dataShards; j++) {
+        auto start = j * shardSize;
+        if (start >= _data.size())
+            break;
+        auto len = std::min(shardSize, _data.size() - start);
+        mulAdd(getCoefficient(_index, j, _dataShards), _data.data() + start, shard->data(), len);
+    }
+
+    return shard;
+}
+
+
+ptr<vector<uint8_t>> ReedSolomon::decode(const map<uint64_t, ptr<vector<uint8_t>>> &_shards,
+                                         uint64_t _dataShards, uint64_t _totalShards, uint64_t _dataSize) {
+    CHECK_ARGUMENT(_dataShards > 0);
+    CHECK_ARGUMENT(_dataShards <= _totalShards);
+    CHECK_ARGUMENT(_totalShards <= MAX_SHARDS);
+    CHECK_ARGUMENT(_shards.size() >= _dataShards);
+
+    auto shardSize = getShardSize(_dataSize, _dataShards);
+
+    // map is ordered, so data shards are preferred and need no arithmetic
+    vector<uint64_t> indices;
+    vector<const uint8_t *> rows;
+
+    for (auto &&item : _shards) {
+        CHECK_ARGUMENT(item.first < _totalShards);
+        CHECK_ARGUMENT(item.second != nullptr && item.second->size() == shardSize);
+        indices.push_back(item.first);
+        rows.push_back(item.second->data());
+        if (indices.size() == _dataShards)
+            break;
+    }
+
+    auto k = _dataShards;
+
+    // invert the k x k submatrix of the generator with Gauss-Jordan elimination
+    vector<uint8_t> matrix(k * k);
+    vector<uint8_t> inverse(k * k, 0);
+
+    for (uint64_t r = 0; r < k; r++) {
+        for (uint64_t c = 0; c < k; c++) {
+            matrix[r * k + c] = getCoefficient(indices[r], c, k);
+        }
+        inverse[r * k + r] = 1;
+    }
+
+    for (uint64_t c = 0; c < k; c++) {
+        uint64_t pivot = c;
+        while (pivot < k && matrix[pivot * k + c] == 0)
+            pivot++;
+
+        CHECK_STATE2(pivot < k, "Singular erasure code matrix");
+
+        if (pivot != c) {
+            for (uint64_t i = 0; i < k; i++) {
+                std::swap(matrix[pivot * k + i], matrix[c * k + i]);
+                std::swap(inverse[pivot * k + i], inverse[c * k + i]);
+            }
+        }
+
+        auto factor = inv(matrix[c * k + c]);
+        for (uint64_t i = 0; i < k; i++) {
+            matrix[c * k + i] = mul(matrix[c * k + i], factor);
+            inverse[c * k + i] = mul(inverse[c * k + i], factor);
+        }
+
+        for (uint64_t r = 0; r < k; r++) {
+            auto f = matrix[r * k + c];
+            if (r == c || f == 0)
+                continue;
+            for (uint64_t i = 0; i < k; i++) {
+                matrix[r * k + i] ^= mul(f, matrix[c * k + i]);
+                inverse[r * k + i] ^= mul(f, inverse[c * k + i]);
+            }
+        }
+    }
+
+    auto padded = make_shared<vector<uint8_t>>(shardSize * k, 0);
+
+    for (uint64_t j = 0; j < k; j++) {
+        for (uint64_t r = 0; r < k; r++) {
+            mulAdd(inverse[j * k + r], rows[r], padded->data() + j * shardSize, shardSize);
+        }
+    }
+
+    padded->resize(_dataSize);
+
+    return padded;
+}
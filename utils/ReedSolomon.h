@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2026 SKALE Labs
+
+    This file is part of skale-consensus.
+
+    skale-consensus is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published
+    by the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    skale-consensus is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with skale-consensus.  If not, see <https://www.gnu.org/licenses/>.
+
+    @file ReedSolomon.h
+    @author agent
+    @date 2026
+*/
+
+
+#pragma once
+
+
+/**
+ * Systematic Reed-Solomon code over GF(2^8). Data is split into dataShards equal shards
+ * (zero padded), the remaining shards are parity. Any dataShards of the shards restore the data.
+ * Parity rows form a Cauchy matrix, so every square submatrix of the generator is invertible.
+ */
+class ReedSolomon {
+
+    class GaloisTables {
+    public:
+        array<uint8_t, 512> exp;
+        array<uint8_t, 256> log;
+
+        GaloisTables();
+    };
+
+    static const GaloisTables &getTables();
+
+    static uint8_t mul(uint8_t _a, uint8_t _b);
+
+    static uint8_t inv(uint8_t _a);
+
+    static uint8_t getCoefficient(uint64_t _shardIndex, uint64_t _dataIndex, uint64_t _dataShards);
+
+    static void mulAdd(uint8_t _coefficient, const uint8_t *_src, uint8_t *_dst, uint64_t _len);
+
+public:
+
+    static constexpr uint64_t MAX_SHARDS = 256;
+
+    static uint64_t getShardSize(uint64_t _dataSize, uint64_t _dataShards);
+
+    /**
+     * Computes shard _index (0-based) of _data. Shards below _dataShards are plain data slices
+     */
+    static ptr<vector<uint8_t>> encodeShard(const vector<uint8_t> &_data, uint64_t _dataShards,
+                                            uint64_t _totalShards, uint64_t _index);
+
+    /**
+     * Restores _dataSize bytes of data from at least _dataShards shards, keyed by 0-based index
+     */
+    static ptr<vector<uint8_t>> decode(const map<uint64_t, ptr<vector<uint8_t>>> &_shards,
+                                       uint64_t _dataShards, uint64_t _totalShards, uint64_t _dataSize);
+};